@@ -0,0 +1,25 @@
+# Top-level project: builds the headless dotcore library, then the game,
+# the benchmarks and the tests ('make check').
+TEMPLATE = subdirs
+CONFIG += ordered
+
+SUBDIRS = dotcore app swarmbench textbench hotpaths surfacebench gamereplaytest
+
+dotcore.subdir = src/dotcore
+app.file = src/dotgame.pro
+app.depends = dotcore
+
+swarmbench.subdir = src/benchmarks/swarmbench
+swarmbench.depends = dotcore
+
+textbench.subdir = src/benchmarks/textbench
+textbench.depends = dotcore
+
+hotpaths.subdir = src/benchmarks/hotpaths
+hotpaths.depends = dotcore
+
+surfacebench.subdir = src/benchmarks/surfacebench
+surfacebench.depends = dotcore
+
+gamereplaytest.subdir = src/tests/gamereplay
+gamereplaytest.depends = dotcore
@@ -0,0 +1,45 @@
+# QTestLib micro-benchmarks of the game's hot paths.
+# 'make benchmark' runs them and writes the results to hotpaths.xml, for
+# comparing releases.
+TEMPLATE = app
+TARGET = hotpaths
+QT += testlib
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+DEPENDPATH += ../..
+
+SOURCES += tst_hotpaths.cpp \
+    ../../cachedtext.cpp \
+    ../../dot.cpp \
+    ../../dotwidget.cpp \
+    ../../frameprofiler.cpp \
+    ../../gradienttextstatusbar.cpp \
+    ../../latencymonitor.cpp \
+    ../../leaderboard.cpp \
+    ../../perfhud.cpp \
+    ../../safefile.cpp \
+    ../../scorescreen.cpp \
+    ../../sparkline.cpp
+
+HEADERS += \
+    ../../cachedtext.h \
+    ../../dot.h \
+    ../../dotwidget.h \
+    ../../frameprofiler.h \
+    ../../gradienttextstatusbar.h \
+    ../../latencymonitor.h \
+    ../../leaderboard.h \
+    ../../perfhud.h \
+    ../../safefile.h \
+    ../../scorescreen.h \
+    ../../sparkline.h
+
+DOTCORE_OUT_PWD = $$OUT_PWD/../../dotcore
+include(../../dotcore/dotcore.pri)
+
+# machine-readable results: make benchmark
+benchmark.commands = ./$$TARGET -xml -o hotpaths.xml
+benchmark.depends = $$TARGET
+QMAKE_EXTRA_TARGETS += benchmark
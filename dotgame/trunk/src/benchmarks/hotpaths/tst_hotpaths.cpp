@@ -0,0 +1,273 @@
+/** ****************************************************************************
+ * @file tst_hotpaths.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * QBENCHMARKs of the code that runs every tick or every frame: dot motion,
+ * the error ratio, the game stats, and painting the DotWidget, ScoreScreen and
+ * status bar into an offscreen image.  Run with -xml (or 'make benchmark') for
+ * results that can be compared between releases.
+ *
+ ******************************************************************************/
+
+#include <QtTest/QtTest>
+#include <QtGui/QImage>
+#include <QtCore/QList>
+#include "dot.h"
+#include "dotwidget.h"
+#include "gamesim.h"
+#include "scorescreen.h"
+#include "leaderboard.h"
+#include "gradienttextstatusbar.h"
+
+/// Size of the main window area, as on the kiosk
+static const QSize MAIN_AREA_SIZE(800, 600);
+/// Size of the status bar
+static const QSize STATUS_BAR_SIZE(800, 20);
+/// A full high score table
+static const int HIGH_SCORE_ROWS = 10;
+
+/** ****************************************************************************
+ * @class HotPathsBench
+ *   One benchmark per hot path.
+*******************************************************************************/
+class HotPathsBench : public QObject
+{
+    Q_OBJECT
+private slots:
+    void dotUpdateLoc();
+    void dotCalcPosErrorRatio();
+    void gameSimCalcGameStats();
+    void gameSimStep();
+    void dotWidgetPaint();
+    void scoreScreenPaint();
+    void scoreScreenNewTable();
+    void scoreScreenScroll();
+    void statusBarUpdateValues();
+    void statusBarPaint();
+};
+
+/** ****************************************************************************
+ * Function: dotUpdateLoc()
+ *   One random step of the Dot, including its newDotLoc signal.
+*******************************************************************************/
+void HotPathsBench::dotUpdateLoc()
+{
+    QWidget arena;
+    arena.resize(MAIN_AREA_SIZE);
+    DotSim dotSim(SimPoint(MAIN_AREA_SIZE.width()/2, MAIN_AREA_SIZE.height()/2));
+    Dot dot(&arena, &dotSim);
+    QBENCHMARK {
+        dot.updateLoc();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: dotCalcPosErrorRatio()
+ *
+*******************************************************************************/
+void HotPathsBench::dotCalcPosErrorRatio()
+{
+    QWidget arena;
+    arena.resize(MAIN_AREA_SIZE);
+    DotSim dotSim(SimPoint(MAIN_AREA_SIZE.width()/2, MAIN_AREA_SIZE.height()/2));
+    Dot dot(&arena, &dotSim);
+    const QPoint cursorPos(MAIN_AREA_SIZE.width()/2 + 7, MAIN_AREA_SIZE.height()/2 - 5);
+    float errorRatio = 0;
+    QBENCHMARK {
+        errorRatio += dot.calcPosErrorRatio(cursorPos);
+    }
+    QVERIFY(errorRatio > 0);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: gameSimCalcGameStats()
+ *   The stats update that used to be DotWidget::calcGameStats(): error-ratio
+ *   average and score, every GAME_UPDATE_INTERVAL_MS.
+*******************************************************************************/
+void HotPathsBench::gameSimCalcGameStats()
+{
+    const SimPoint center(MAIN_AREA_SIZE.width()/2, MAIN_AREA_SIZE.height()/2);
+    GameSim gameSim(center, MAIN_AREA_SIZE.width(), MAIN_AREA_SIZE.height());
+    gameSim.setTimeLimit(GameSim::INFINITE_TIME);
+    gameSim.step(1, center);    // a scored cursor position
+    QBENCHMARK {
+        gameSim.calcGameStats();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: gameSimStep()
+ *   One 1 ms simulation step, as run by DotWidget::runFrame().
+*******************************************************************************/
+void HotPathsBench::gameSimStep()
+{
+    const SimPoint center(MAIN_AREA_SIZE.width()/2, MAIN_AREA_SIZE.height()/2);
+    GameSim gameSim(center, MAIN_AREA_SIZE.width(), MAIN_AREA_SIZE.height());
+    gameSim.setTimeLimit(GameSim::INFINITE_TIME);
+    gameSim.addCursorSample(0, center);
+    QBENCHMARK {
+        gameSim.step(1);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: dotWidgetPaint()
+ *   A full repaint of the DotWidget, paused so all of its text is drawn.
+*******************************************************************************/
+void HotPathsBench::dotWidgetPaint()
+{
+    DotWidget dotWidget(NULL, MAIN_AREA_SIZE);
+    QImage target(MAIN_AREA_SIZE, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        dotWidget.render(&target);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scoreScreenPaint()
+ *
+*******************************************************************************/
+void HotPathsBench::scoreScreenPaint()
+{
+    const QString leaderboardName = QDir::temp().filePath("dotgame-bench-leaderboard");
+    QFile::remove(leaderboardName + ".rows");
+    QFile::remove(leaderboardName + ".names");
+    QFile::remove(leaderboardName + ".index");
+    Leaderboard leaderboard(leaderboardName);
+    leaderboard.open();
+    for (int index = 0; index < HIGH_SCORE_ROWS; ++index)
+    {
+        HighScoreData highScore = {QString("Player_%1").arg(index), 1000u - index*50,
+                                   10, 20, 40u - index};
+        leaderboard.insert(highScore);
+    }
+    ScoreScreen scoreScreen;
+    scoreScreen.setSnapshot(leaderboard.snapshot(ScoreScreen::TABLE_ROWS));
+    scoreScreen.resize(MAIN_AREA_SIZE);
+    QImage target(MAIN_AREA_SIZE, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        scoreScreen.render(&target);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scoreScreenNewTable()
+ *   The worst case: a changed table before every paint, so its cached layer is
+ *   redrawn each time.  Happens once per game.
+*******************************************************************************/
+void HotPathsBench::scoreScreenNewTable()
+{
+    ScoreSnapshot snapshots[2];
+    for (int index = 0; index < HIGH_SCORE_ROWS; ++index)
+    {
+        HighScoreData highScore = {QString("Player_%1").arg(index), 1000u - index*50,
+                                   10, 20, 40u - index};
+        snapshots[0] = snapshots[0].withGame(highScore, ScoreScreen::TABLE_ROWS);
+    }
+    HighScoreData newHighScore = {QString("Player_new"), 990u, 10, 20, 40u};
+    snapshots[1] = snapshots[0].withGame(newHighScore, ScoreScreen::TABLE_ROWS);
+    ScoreScreen scoreScreen;
+    scoreScreen.resize(MAIN_AREA_SIZE);
+    QImage target(MAIN_AREA_SIZE, QImage::Format_ARGB32_Premultiplied);
+    int paintNum = 0;
+    QBENCHMARK {
+        scoreScreen.setSnapshot(snapshots[paintNum++ % 2]);
+        scoreScreen.render(&target);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scoreScreenScroll()
+ *   Jumping around a leaderboard of ten million games, with the page for
+ *   each position arriving just before the paint.  Should take as long as
+ *   scrolling a table of twenty.
+*******************************************************************************/
+void HotPathsBench::scoreScreenScroll()
+{
+    const int GAME_COUNT = 10000000;
+    ScoreSnapshot snapshot;
+    QList<HighScoreData> page;
+    for (int index = 0; index < ScoreScreen::PAGE_ROWS; ++index)
+    {
+        HighScoreData highScore = {QString("Player_%1").arg(index), 1000u - index,
+                                   10, 20, 40u};
+        page.append(highScore);
+        if (index < HIGH_SCORE_ROWS)
+        {
+            snapshot.topGames.append(highScore);
+        }
+    }
+    snapshot.gameCount = GAME_COUNT;
+    ScoreScreen scoreScreen;
+    scoreScreen.resize(MAIN_AREA_SIZE);
+    scoreScreen.setSnapshot(snapshot);
+    QImage target(MAIN_AREA_SIZE, QImage::Format_ARGB32_Premultiplied);
+    int scrollNum = 0;
+    QBENCHMARK {
+        const int firstRank = int((scrollNum++ * 7919LL * 1009LL) % (GAME_COUNT - HIGH_SCORE_ROWS));
+        const int firstPage = qMax(0, firstRank - HIGH_SCORE_ROWS) / ScoreScreen::PAGE_ROWS;
+        const int lastPage = (firstRank + 2*HIGH_SCORE_ROWS) / ScoreScreen::PAGE_ROWS;
+        for (int pageNum = firstPage; pageNum <= lastPage; ++pageNum)
+        {
+            scoreScreen.setPage(pageNum * ScoreScreen::PAGE_ROWS, page, GAME_COUNT);
+        }
+        scoreScreen.scrollToRank(firstRank);
+        scoreScreen.render(&target);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: statusBarUpdateValues()
+ *
+*******************************************************************************/
+void HotPathsBench::statusBarUpdateValues()
+{
+    GradientTextStatusBar statusBar;
+    statusBar.resize(STATUS_BAR_SIZE);
+    int updateNum = 0;
+    QBENCHMARK {
+        statusBar.updateValues((updateNum % 100) / 100.0, updateNum / 12);
+        ++updateNum;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: statusBarPaint()
+ *   With a full minute of distance history in its sparkline.
+*******************************************************************************/
+void HotPathsBench::statusBarPaint()
+{
+    GradientTextStatusBar statusBar;
+    statusBar.resize(STATUS_BAR_SIZE);
+    for (uint updateNum = 0; updateNum < 60000 / GameSim::GAME_UPDATE_INTERVAL_MS; ++updateNum)
+    {
+        statusBar.updateValues((updateNum % 100) / 100.0, updateNum / 12);
+    }
+    QImage target(STATUS_BAR_SIZE, QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        statusBar.render(&target);
+    }
+    return;
+}
+
+QTEST_MAIN(HotPathsBench)
+#include "tst_hotpaths.moc"
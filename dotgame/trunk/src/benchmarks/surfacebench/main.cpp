@@ -0,0 +1,161 @@
+/** ****************************************************************************
+ * @file main.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Surface benchmark: plays the game on screen for a few seconds with the
+ * DotWidget layered under the QML view, then with everything in the one QML
+ * view, and prints the paint time per frame of each as measured by the
+ * FrameProfiler.  The cursor is kept on the dot, so the game doesn't end.
+ *
+ ******************************************************************************/
+
+#include <QtGui/QApplication>
+#include <QtGui/QStackedLayout>
+#include <QtGui/QMouseEvent>
+#include <QtCore/QEventLoop>
+#include <QtCore/QTimer>
+#include <QtCore/QUrl>
+#include <QtCore/QVector>
+#include <QtDeclarative/QDeclarativeView>
+#include <QtDeclarative/qdeclarative.h>
+#include <algorithm>
+#include <stdio.h>
+#include "dotwidget.h"
+#include "dotdeclarative.h"
+#include "dotfielddeclarative.h"
+#include "qsliderdeclarative.h"
+
+/// How long each case plays
+static const int RUN_TIME_MS = 4000;
+/// Size of the main window area, as on the kiosk
+static const QSize MAIN_AREA_SIZE(800, 600);
+
+/** ****************************************************************************
+ * @class CursorFollower
+ *   Does what MainWindow::updateGameState() does with the QML dot, and puts
+ *   the cursor on the dot, as a perfect player.
+*******************************************************************************/
+class CursorFollower : public QObject
+{
+    Q_OBJECT
+public:
+    CursorFollower(QWidget *surfacePtr, DotDeclarative *qmlDotPtr) :
+        m_surfacePtr(surfacePtr), m_qmlDotPtr(qmlDotPtr) {}
+public slots:
+    void follow(const GameStateSnapshot &state)
+    {
+        if (m_qmlDotPtr != NULL)
+        {
+            m_qmlDotPtr->setCenter(state.dotPos);
+        }
+        QMouseEvent moveEvent(QEvent::MouseMove, state.dotPos, m_surfacePtr->mapToGlobal(state.dotPos),
+                              Qt::NoButton, Qt::NoButton, Qt::NoModifier);
+        QApplication::sendEvent(m_surfacePtr, &moveEvent);
+    }
+private:
+    QWidget *m_surfacePtr;
+    DotDeclarative *m_qmlDotPtr;
+};
+
+/** ****************************************************************************
+ * Function: runCase()
+ *   Put the game on screen one way, play, and print a line of the table.
+*******************************************************************************/
+static void runCase(const char *name, bool singleSurface)
+{
+    DotWidget dotWidget(NULL, MAIN_AREA_SIZE);
+    QWidget window;
+    QStackedLayout *layoutPtr = new QStackedLayout(&window);
+    layoutPtr->setStackingMode(QStackedLayout::StackAll);
+    QDeclarativeView *viewPtr = new QDeclarativeView;
+    viewPtr->setResizeMode(QDeclarativeView::SizeRootObjectToView);
+    viewPtr->setSource(QUrl::fromLocalFile(DOTGAME_QML_FILE));
+    QDeclarativeItem *rootItemPtr = qobject_cast<QDeclarativeItem *>(viewPtr->rootObject());
+    if (rootItemPtr == NULL)
+    {
+        printf("%-16s can't load %s\n", name, DOTGAME_QML_FILE);
+        return;
+    }
+    DotDeclarative *qmlDotPtr = rootItemPtr->findChild<DotDeclarative *>("dot");
+
+    // as the MainWindow constructor does
+    layoutPtr->addWidget(viewPtr);
+    if (singleSurface)
+    {
+        DotFieldDeclarative *fieldPtr = new DotFieldDeclarative(&dotWidget, rootItemPtr);
+        fieldPtr->setZ(-1);
+        fieldPtr->fill(rootItemPtr);
+        viewPtr->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    }
+    else
+    {
+        layoutPtr->addWidget(&dotWidget);
+        layoutPtr->setCurrentIndex(0);      // the QML on top
+    }
+    dotWidget.trackCursorOver(viewPtr->viewport());
+    dotWidget.frameProfiler()->watchPaint(viewPtr->viewport(), SECTION_PAINT_QML);
+    CursorFollower follower(viewPtr->viewport(), qmlDotPtr);
+    QObject::connect(&dotWidget, SIGNAL(newGameState(GameStateSnapshot)),
+                     &follower, SLOT(follow(GameStateSnapshot)));
+
+    window.resize(MAIN_AREA_SIZE);
+    window.show();
+    dotWidget.initialize();
+    dotWidget.setTimeLimit(GameSim::INFINITE_TIME);
+    dotWidget.setHudVisible(true);      // starts the profiler; drawn the same in both
+    dotWidget.startGame();
+    QEventLoop playLoop;
+    QTimer::singleShot(RUN_TIME_MS, &playLoop, SLOT(quit()));
+    playLoop.exec();
+    const uint paintedPixelsPerSecond = dotWidget.getPaintedPixelsPerSecond();
+    layoutPtr->removeWidget(&dotWidget);
+    dotWidget.setParent(NULL);      // not deleted with the window
+
+    // paint time of each frame, both surfaces together
+    const QVector<FrameTiming> frames = dotWidget.frameProfiler()->recentFrames();
+    QVector<qint64> paintUs;
+    qint64 paintUsTotal = 0;
+    for (int frameNum = 0; frameNum < frames.size(); ++frameNum)
+    {
+        const qint64 frameUs = frames[frameNum].us[SECTION_PAINT_DOT] +
+                frames[frameNum].us[SECTION_PAINT_QML];
+        paintUs.append(frameUs);
+        paintUsTotal += frameUs;
+    }
+    if (paintUs.isEmpty())
+    {
+        printf("%-16s no frames\n", name);
+        return;
+    }
+    std::sort(paintUs.begin(), paintUs.end());
+    printf("%-16s %8i %12.1f %12lli %14u\n", name, paintUs.size(),
+           double(paintUsTotal) / paintUs.size(), paintUs[(paintUs.size() * 95) / 100],
+           paintedPixelsPerSecond);
+    fflush(stdout);
+    return;
+}
+
+/// Main Function for the surface benchmark.
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+    qmlRegisterType<QSliderDeclarative>("QtItems", 1, 0, "QSlider");
+    qmlRegisterType<DotDeclarative>("QtItems", 1, 0, "GameDot");
+
+    printf("%-16s %8s %12s %12s %14s\n", "surface", "frames", "paint us", "p95 us", "field px/s");
+    runCase("layered", false);
+    runCase("single surface", true);
+    return 0;
+}
+
+#include "main.moc"
@@ -0,0 +1,39 @@
+# Benchmark of the two ways of putting the game on screen: the DotWidget
+# composited under the QML view, or everything in the one QML view.  Plays
+# for a few seconds in each and prints the paint time per frame as a table.
+TEMPLATE = app
+TARGET = surfacebench
+QT += declarative
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+DEPENDPATH += ../..
+
+# the game's own QML, loaded from the source tree
+DEFINES += DOTGAME_QML_FILE=\\\"$$PWD/../../qml/dotgame/main.qml\\\"
+
+SOURCES += main.cpp \
+    ../../cachedtext.cpp \
+    ../../dot.cpp \
+    ../../dotdeclarative.cpp \
+    ../../dotfielddeclarative.cpp \
+    ../../dotwidget.cpp \
+    ../../frameprofiler.cpp \
+    ../../latencymonitor.cpp \
+    ../../perfhud.cpp \
+    ../../qsliderdeclarative.cpp
+
+HEADERS += \
+    ../../cachedtext.h \
+    ../../dot.h \
+    ../../dotdeclarative.h \
+    ../../dotfielddeclarative.h \
+    ../../dotwidget.h \
+    ../../frameprofiler.h \
+    ../../latencymonitor.h \
+    ../../perfhud.h \
+    ../../qsliderdeclarative.h
+
+DOTCORE_OUT_PWD = $$OUT_PWD/../../dotcore
+include(../../dotcore/dotcore.pri)
@@ -0,0 +1,65 @@
+/** ****************************************************************************
+ * @file main.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Swarm benchmark: times SwarmSim::updateLoc() for swarms of 1 to 1M dots and
+ * prints ticks/second and dot updates/second as a table.
+ *
+ ******************************************************************************/
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <stdio.h>
+#include "swarmsim.h"
+
+/// Arena size used for every run, like a maximized window.
+static const int ARENA_WIDTH = 1920;
+static const int ARENA_HEIGHT = 1080;
+/// Each swarm size is ticked for at least this long...
+static const qint64 MIN_RUN_TIME_MS = 500;
+/// ...and at least this many times.
+static const int MIN_TICKS = 10;
+
+/// Main Function for the swarm benchmark.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    printf("%10s %14s %16s\n", "dots", "ticks/s", "dot updates/s");
+    for (unsigned int dotCount = 1; dotCount <= 1000000; dotCount *= 10)
+    {
+        SwarmSim swarm(ARENA_WIDTH, ARENA_HEIGHT);
+        swarm.reserve(dotCount);
+        for (unsigned int i = 0; i < dotCount; ++i)
+        {
+            // spread the dots over the arena, diameters over the full range
+            swarm.addDot(SimPoint((i * 7919) % ARENA_WIDTH, (i * 104729) % ARENA_HEIGHT),
+                         DotSim::DOT_DIAM_MIN + (i % (DotSim::DOT_DIAM_MAX - DotSim::DOT_DIAM_MIN + 1)));
+        }
+        swarm.updateLoc();     // warm up the caches
+
+        QElapsedTimer timer;
+        int ticks = 0;
+        timer.start();
+        while ((ticks < MIN_TICKS) || (timer.elapsed() < MIN_RUN_TIME_MS))
+        {
+            swarm.updateLoc();
+            ++ticks;
+        }
+        const double seconds = timer.nsecsElapsed() / 1e9;
+        const double ticksPerSecond = ticks / seconds;
+        printf("%10u %14.1f %16.0f\n", dotCount, ticksPerSecond, ticksPerSecond * dotCount);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,12 @@
+# Console benchmark of the SwarmSim structure-of-arrays engine.
+# Prints ticks/second for swarms of 1 to 1M dots.
+TEMPLATE = app
+TARGET = swarmbench
+QT -= gui
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp
+
+DOTCORE_OUT_PWD = $$OUT_PWD/../../dotcore
+include(../../dotcore/dotcore.pri)
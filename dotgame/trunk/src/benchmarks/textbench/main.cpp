@@ -0,0 +1,143 @@
+/** ****************************************************************************
+ * @file main.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Text benchmark: renders the DotWidget, ScoreScreen and status bar into an
+ * image, with the CachedText layout cache on and off, and prints the time per
+ * paint as a table.
+ *
+ ******************************************************************************/
+
+#include <QtGui/QApplication>
+#include <QtGui/QImage>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QDir>
+#include <QtCore/QList>
+#include <stdio.h>
+#include "cachedtext.h"
+#include "dotwidget.h"
+#include "scorescreen.h"
+#include "leaderboard.h"
+#include "gradienttextstatusbar.h"
+
+/// Each case is painted for at least this long...
+static const qint64 MIN_RUN_TIME_MS = 500;
+/// ...and at least this many times.
+static const int MIN_PAINTS = 20;
+/// Size of the main window area, as on the kiosk
+static const QSize MAIN_AREA_SIZE(800, 600);
+/// Size of the status bar
+static const QSize STATUS_BAR_SIZE(800, 20);
+/// Number of rows in the sample high score table
+static const int HIGH_SCORE_ROWS = 10;
+
+/** ****************************************************************************
+ * @class PaintCase
+ *   One widget to paint, optionally changing its content before each paint.
+*******************************************************************************/
+class PaintCase
+{
+public:
+    PaintCase(const char *name, QWidget *widgetPtr) :
+        m_name(name), m_widgetPtr(widgetPtr) {}
+    virtual ~PaintCase() {}
+    /// Called before each paint, with the paint number
+    virtual void prepare(int paintNumber) { Q_UNUSED(paintNumber); }
+    const char *m_name;
+    QWidget *m_widgetPtr;
+};
+
+/** ****************************************************************************
+ * @class StatusBarUpdateCase
+ *   The status bar with new values before every paint, its worst case.
+*******************************************************************************/
+class StatusBarUpdateCase : public PaintCase
+{
+public:
+    StatusBarUpdateCase(const char *name, GradientTextStatusBar *statusBarPtr) :
+        PaintCase(name, statusBarPtr), m_statusBarPtr(statusBarPtr) {}
+    virtual void prepare(int paintNumber)
+    {
+        m_statusBarPtr->updateValues((paintNumber % 100) / 100.0, paintNumber / 12);
+    }
+    GradientTextStatusBar *m_statusBarPtr;
+};
+
+/** ****************************************************************************
+ * Function: timePaint()
+ *   @return Average microseconds per paint of the case's widget.
+*******************************************************************************/
+static double timePaint(PaintCase &paintCase)
+{
+    QImage target(paintCase.m_widgetPtr->size(), QImage::Format_ARGB32_Premultiplied);
+    paintCase.prepare(0);
+    paintCase.m_widgetPtr->render(&target);     // warm up fonts and caches
+
+    QElapsedTimer timer;
+    int paints = 0;
+    timer.start();
+    while ((paints < MIN_PAINTS) || (timer.elapsed() < MIN_RUN_TIME_MS))
+    {
+        paintCase.prepare(paints);
+        paintCase.m_widgetPtr->render(&target);
+        ++paints;
+    }
+    return (timer.nsecsElapsed() / 1000.0) / paints;
+}
+
+/// Main Function for the text benchmark.
+int main(int argc, char *argv[])
+{
+    QApplication app(argc, argv);
+
+    DotWidget dotWidget(NULL, MAIN_AREA_SIZE);      // PAUSED: score plus three labels
+
+    const QString leaderboardName = QDir::temp().filePath("dotgame-bench-leaderboard");
+    QFile::remove(leaderboardName + ".rows");
+    QFile::remove(leaderboardName + ".names");
+    QFile::remove(leaderboardName + ".index");
+    Leaderboard leaderboard(leaderboardName);
+    leaderboard.open();
+    for (int index = 0; index < HIGH_SCORE_ROWS; ++index)
+    {
+        HighScoreData highScore = {QString("Player_%1").arg(index), 1000u - index*50,
+                                   10, 20, 40u - index};
+        leaderboard.insert(highScore);
+    }
+    ScoreScreen scoreScreen;
+    scoreScreen.setSnapshot(leaderboard.snapshot(ScoreScreen::TABLE_ROWS));
+    scoreScreen.resize(MAIN_AREA_SIZE);
+
+    GradientTextStatusBar statusBar;
+    statusBar.resize(STATUS_BAR_SIZE);
+
+    PaintCase dotWidgetCase("DotWidget", &dotWidget);
+    PaintCase scoreScreenCase("ScoreScreen", &scoreScreen);
+    PaintCase statusBarCase("status bar", &statusBar);
+    StatusBarUpdateCase statusBarUpdateCase("status bar, new values", &statusBar);
+    PaintCase *paintCases[] = {&dotWidgetCase, &scoreScreenCase, &statusBarCase, &statusBarUpdateCase};
+    const int caseCount = sizeof(paintCases) / sizeof(paintCases[0]);
+
+    printf("%-24s %14s %14s %8s\n", "widget", "uncached us", "cached us", "speedup");
+    for (int caseIndex = 0; caseIndex < caseCount; ++caseIndex)
+    {
+        CachedText::setCacheEnabled(false);
+        const double uncachedUs = timePaint(*paintCases[caseIndex]);
+        CachedText::setCacheEnabled(true);
+        const double cachedUs = timePaint(*paintCases[caseIndex]);
+        printf("%-24s %14.1f %14.1f %7.2fx\n", paintCases[caseIndex]->m_name,
+               uncachedUs, cachedUs, uncachedUs / cachedUs);
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+# Benchmark of the widgets' paintEvent() with and without the CachedText
+# layout cache.  Prints the time per paint as a table.
+TEMPLATE = app
+TARGET = textbench
+CONFIG += console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+DEPENDPATH += ../..
+
+SOURCES += main.cpp \
+    ../../cachedtext.cpp \
+    ../../dot.cpp \
+    ../../dotwidget.cpp \
+    ../../frameprofiler.cpp \
+    ../../gradienttextstatusbar.cpp \
+    ../../latencymonitor.cpp \
+    ../../leaderboard.cpp \
+    ../../perfhud.cpp \
+    ../../safefile.cpp \
+    ../../scorescreen.cpp \
+    ../../sparkline.cpp
+
+HEADERS += \
+    ../../cachedtext.h \
+    ../../dot.h \
+    ../../dotwidget.h \
+    ../../frameprofiler.h \
+    ../../gradienttextstatusbar.h \
+    ../../latencymonitor.h \
+    ../../leaderboard.h \
+    ../../perfhud.h \
+    ../../safefile.h \
+    ../../scorescreen.h \
+    ../../sparkline.h
+
+DOTCORE_OUT_PWD = $$OUT_PWD/../../dotcore
+include(../../dotcore/dotcore.pri)
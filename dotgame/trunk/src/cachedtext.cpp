@@ -0,0 +1,128 @@
+/** ****************************************************************************
+ * @file cachedtext.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * CachedText is a line of text that is laid out once (as a QStaticText) and
+ * then only redrawn, until its content or font changes.  The widgets use it for
+ * all their labels, so a repaint does not have to shape the same glyphs again.
+ *
+ ******************************************************************************/
+
+#include "cachedtext.h"
+#include <QtGui/QTransform>
+
+bool CachedText::s_cacheEnabled = true;
+
+/** ****************************************************************************
+ * CachedText Constructor
+ *  @param text Text to draw.
+ *  @param font Font to draw the text in.
+*******************************************************************************/
+CachedText::CachedText(const QString &text, const QFont &font) :
+    m_text(text), m_font(font), m_prepared(false)
+{
+    m_staticText.setTextFormat(Qt::PlainText);
+    m_staticText.setPerformanceHint(QStaticText::AggressiveCaching);
+}
+
+/** ****************************************************************************
+ * Function: setText()
+ *   @return true if the text changed; it is laid out again at the next draw().
+*******************************************************************************/
+bool CachedText::setText(const QString &text)
+{
+    if (text == m_text)
+    {
+        return false;
+    }
+    m_text = text;
+    m_prepared = false;
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: setFont()
+ *
+*******************************************************************************/
+void CachedText::setFont(const QFont &font)
+{
+    if (font != m_font)
+    {
+        m_font = font;
+        m_prepared = false;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: prepare()
+ *   Done once per change of text or font, at the first draw() after it, so
+ *   texts that are never shown (or not yet, e.g. at startup) resolve no fonts.
+*******************************************************************************/
+void CachedText::prepare() const
+{
+    m_staticText.setText(m_text);
+    m_staticText.prepare(QTransform(), m_font);
+    m_prepared = true;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: draw()
+ *   Only the horizontal (left, right, center) and vertical (top, center)
+ *   alignments used by the game are supported.  A change of 'area', e.g. a
+ *   window resize, only moves the text; it does not lay it out again.
+ *   @param painter Painter to draw with; its font is changed to this text's.
+ *   @param area Rectangle to align the text in.
+ *   @param flags Qt::AlignmentFlag values, as for QPainter::drawText().
+*******************************************************************************/
+void CachedText::draw(QPainter *painter, const QRect &area, int flags) const
+{
+    painter->setFont(m_font);
+    if (!s_cacheEnabled)
+    {
+        painter->drawText(area, flags, m_text);
+        return;
+    }
+    if (!m_prepared)
+    {
+        prepare();
+    }
+    const QSizeF textSize = m_staticText.size();
+    qreal textX = area.left();
+    if (flags & Qt::AlignHCenter)
+    {
+        textX += (area.width() - textSize.width()) / 2;
+    }
+    else if (flags & Qt::AlignRight)
+    {
+        textX += area.width() - textSize.width();
+    }
+    qreal textY = area.top();
+    if (flags & Qt::AlignVCenter)
+    {
+        textY += (area.height() - textSize.height()) / 2;
+    }
+    painter->drawStaticText(QPointF(qRound(textX), qRound(textY)), m_staticText);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setCacheEnabled()
+ *   @param enabled false to lay out the text on every draw(), as before.
+*******************************************************************************/
+void CachedText::setCacheEnabled(bool enabled)
+{
+    s_cacheEnabled = enabled;
+    return;
+}
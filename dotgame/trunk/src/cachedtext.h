@@ -0,0 +1,88 @@
+/** ****************************************************************************
+ * @file cachedtext.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * CachedText is a line of text that is laid out once (as a QStaticText) and
+ * then only redrawn, until its content or font changes.  The widgets use it for
+ * all their labels, so a repaint does not have to shape the same glyphs again.
+ *
+ ******************************************************************************/
+
+#ifndef CACHEDTEXT_H
+#define CACHEDTEXT_H
+
+#include <QtCore/QString>
+#include <QtCore/QRect>
+#include <QtGui/QFont>
+#include <QtGui/QPainter>
+#include <QtGui/QStaticText>
+
+/** ****************************************************************************
+ * @class CachedText
+ *   One line of plain text with a cached layout.  draw() places it within a
+ *   rectangle with the same alignment flags as QPainter::drawText().
+*******************************************************************************/
+class CachedText
+{
+public:
+    explicit CachedText(const QString &text = QString(), const QFont &font = QFont());
+
+    /// Change the text; only re-lays out if it differs.  @return true if changed
+    bool setText(const QString &text);
+    /// Change the font; only re-lays out if it differs
+    void setFont(const QFont &font);
+    inline const QString &text() const;
+
+    /// Draw the text within 'area', aligned by Qt::AlignmentFlag 'flags'
+    void draw(QPainter *painter, const QRect &area, int flags) const;
+
+    /// Turn the layout cache on or off for all CachedText, e.g. to benchmark it
+    static void setCacheEnabled(bool enabled);
+    static inline bool isCacheEnabled();
+
+private:
+    /// Lay out m_text in m_font, ready for drawing; done by the first draw()
+    void prepare() const;
+
+    /// Text to draw
+    QString m_text;
+    /// Font to draw the text in
+    QFont m_font;
+    /// Laid out glyphs of m_text
+    mutable QStaticText m_staticText;
+    /// Has m_text been laid out in m_font since it last changed?
+    mutable bool m_prepared;
+
+    /// When false, draw() lays out the text every time, like drawText()
+    static bool s_cacheEnabled;
+};
+
+
+/** ****************************************************************************
+ * Function: text()
+ *
+*******************************************************************************/
+inline const QString &CachedText::text() const
+{
+    return m_text;
+}
+/** ****************************************************************************
+ * Function: isCacheEnabled()
+ *
+*******************************************************************************/
+inline bool CachedText::isCacheEnabled()
+{
+    return s_cacheEnabled;
+}
+
+#endif // CACHEDTEXT_H
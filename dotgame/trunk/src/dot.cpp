@@ -13,42 +13,31 @@
  * user tries to closely follow with their cursor to achieve a high m_score.
  *
  * The Dot class represents the dot that runs around the main window. It knows
- * its own motion vectors and how to draw itself, but only changes location
- * when instructed to (it doesn't have any timers of its own).
+ * how to draw itself and tells the window when it moves.  The motion itself is
+ * done by the headless DotSim of the game core, and only when instructed to
+ * (it doesn't have any timers of its own).
  *
  ******************************************************************************/
 
 #include "dot.h"
-#include <time.h>             // to ask for system time()
-#include <math.h>             // for sin(), cos(), pow(), sqrt()
+#include <QtGui/QImage>
+#include <QtGui/QLinearGradient>
 
 /** ****************************************************************************
  * Dot Constructor
  *  @param parent Pointer to the parent window widget
- *  @param location Position of the center of the Dot relative to parent widget.
+ *  @param simPtr Motion model of this Dot.  Its bounds are set to the parent size.
 *******************************************************************************/
-Dot::Dot(QWidget* parent, QPoint location) :
-    QObject(parent), m_parentLocPtr(parent), m_curLoc(location), m_curMoveVect(0,0),
-    m_moveDist(MOVE_DISTANCE_DEFAULT), m_motionWeight(MOTION_WEIGHT_DEFAULT),
-    m_dotSize(DOT_DIAM_DEFAULT,DOT_DIAM_DEFAULT)
+Dot::Dot(QWidget* parent, DotSim* simPtr) :
+    QObject(parent), m_simPtr(simPtr), m_skin(SKIN_CLASSIC)
 {
-    if (m_parentLocPtr == NULL)
+    if ((parent == NULL) || (m_simPtr == NULL))
     {
-        qDebug("dot::ctor: Must specify the dot's parent widget.");
+        qDebug("dot::ctor: Must specify the dot's parent widget and motion model.");
         return;
     }
-    srand(time(NULL));           // initialize random seed for motion vectors
-    setm_dotSize(DOT_DIAM_DEFAULT);  // sets dot size and m_moveDist
-    applyBoundaryCheck(m_curLoc);    // make sure Dot is placed within the window.
-    //qDebug("Dot checked, now at (%i,%i)", m_curLoc.x(), m_curLoc.y());
-
-    QLinearGradient gradient(QPointF(50, -20), QPointF(80, 20));
-    gradient.setColorAt(0.0, Qt::white);
-    gradient.setColorAt(1.0, QColor(0xa6, 0xce, 0x39));
-
-    m_circleBrush = QBrush(gradient);
-    m_circlePen = QPen(Qt::black);
-    m_circlePen.setWidth(1);
+    setBounds(parent->size());
+    m_simPtr->setPos(m_simPtr->getPos());    // make sure Dot is placed within the window.
     return;
 }
 
@@ -58,67 +47,103 @@ Dot::Dot(QWidget* parent, QPoint location) :
 *******************************************************************************/
 void Dot::updateLoc()
 {
-    QVector2D randMoveVect(0,0);
-    int tempRand = rand();
-    int randIntX = (tempRand % (2*m_moveDist + 1)) - m_moveDist;      // distance (-m_moveDist<= tempX <= m_moveDist)
-    randMoveVect.setX(randIntX);
-    tempRand = tempRand % 2;
-    if (tempRand == 0)
-    {
-        tempRand = -1;          // now tempRand is -1 or 1, the Y orientation.
-    }
-    //randMoveVect.setY(tempRand*(m_moveDist * sin(acos((float)randMoveVect.x()/(float)m_moveDist)) ));    // corresponding point on a circle
-    randMoveVect.setY(tempRand*sqrt(pow(m_moveDist,2) - pow(randMoveVect.x(),2)));    // corresponding point on a circle
-    /* To smooth out the random motion of the dot, do a weighted average with
-       previous motion vector, so the dot moves in sort of curved lines. */
-    m_curMoveVect = (m_curMoveVect * m_motionWeight) + (randMoveVect * (1-m_motionWeight));
-    m_curMoveVect = (m_curMoveVect.normalized() * m_moveDist);
-    QPoint offset = m_curMoveVect.toPoint();
-    m_curLoc += offset;
-    /* 1) Make sure that the dot doesn't move outside the window.
-     *  2) If the dot hits the edge, point it back towards the center.
-     *       We could rotate the vector, but inverting looks more natural,
-     *       like a 'bounce'.  */
-    const float invertWeight = -1.0;
-    if (m_curLoc.x() < 0)
-    {
-        m_curLoc.setX(0);
-        m_curMoveVect.setX(m_curMoveVect.x() * invertWeight);
-    }
-    else if (m_curLoc.x() > m_parentLocPtr->size().width())
-    {
-        m_curLoc.setX(m_parentLocPtr->size().width());
-        m_curMoveVect.setX(m_curMoveVect.x() * invertWeight);
-    }
-    if (m_curLoc.y() < 0)
-    {
-        m_curLoc.setY(0);
-        m_curMoveVect.setY(m_curMoveVect.y() * invertWeight);
-    }
-    else if (m_curLoc.y() > m_parentLocPtr->size().height())
-    {
-        m_curLoc.setY(m_parentLocPtr->size().height());
-        m_curMoveVect.setY(m_curMoveVect.y() * invertWeight);
-    }
-    //qDebug("dot::update dist=%i randX=%.2f randY=%.2f newVectX=%.2f newVectY=%.2f m_curLocX=%i m_curLocY=%i",
-    //       m_moveDist, randMoveVect.x(), randMoveVect.y(), m_curMoveVect.x(), m_curMoveVect.y(), m_curLoc.x(), m_curLoc.y());
-    emit newDotLoc(m_curLoc);
+    m_simPtr->updateLoc();
+    emit newDotLoc(getPos());
     return;
 } // function updateLoc()
 
+/** ****************************************************************************
+ * Function: notifyMoved()
+ *   The game core moved the DotSim directly (possibly several times), so
+ *   announce the resulting position once.
+*******************************************************************************/
+void Dot::notifyMoved() const
+{
+    emit newDotLoc(getPos());
+    return;
+}
+
 /** ****************************************************************************
  * Function: paint()
- *   Draws the dot on the given 'painter' canvas
+ *   Draws the dot on the given 'painter' canvas.  The dot only looks different
+ *   when its size or skin changes, so this is a single blit of the sprite.
 *******************************************************************************/
 void Dot::paint(QPainter *painter, QPaintEvent *event) const
 {
     Q_UNUSED(event);
-    painter->setBrush(m_circleBrush);
-    painter->setPen(m_circlePen);
-    painter->drawEllipse(m_curLoc,m_dotSize.width(),m_dotSize.height());
+    painter->drawPixmap(boundingRect().topLeft(), sprite());
     return;
 }
 
+/** ****************************************************************************
+ * Function: boundingRect()
+ *   Area covered by the sprite, centered on the Dot's position.
+*******************************************************************************/
+QRect Dot::boundingRect() const
+{
+    const int radius = spriteRadius(m_simPtr->getDotSize());
+    const QPoint center = getPos();
+    return QRect(center.x() - radius, center.y() - radius, 2*radius + 1, 2*radius + 1);
+}
+
+/** ****************************************************************************
+ * Function: sprite()
+ *   The cache slot for the current size and skin is filled the first time it
+ *   is asked for; after that it is just returned.
+*******************************************************************************/
+const QPixmap &Dot::sprite() const
+{
+    const uint dotDiam = m_simPtr->getDotSize();
+    QPixmap &cachedSprite = m_spriteCache[m_skin][dotDiam];
+    if (cachedSprite.isNull())
+    {
+        cachedSprite = renderSprite(dotDiam, m_skin);
+    }
+    return cachedSprite;
+}
+
+/** ****************************************************************************
+ * Function: renderSprite()
+ *   Draw the antialiased dot once into a premultiplied image.  The gradient
+ *   skin shades from a white highlight at the top-left of the dot to green at
+ *   its center and beyond; the mono skin is plain white.  The circle's center
+ *   lands on a whole pixel, so the sprite is blitted at boundingRect().topLeft()
+ *   without any resampling.
+ *   @param dotDiam Diameter of the dot, DOT_DIAM_MIN..DOT_DIAM_MAX.
+ *   @param skin Visual style to draw.
+*******************************************************************************/
+QPixmap Dot::renderSprite(uint dotDiam, dotSkin skin)
+{
+    const int radius = spriteRadius(dotDiam);
+    QImage spriteImage(2*radius + 1, 2*radius + 1, QImage::Format_ARGB32_Premultiplied);
+    spriteImage.fill(Qt::transparent);
+
+    QBrush circleBrush;
+    if (skin == SKIN_MONO)
+    {
+        circleBrush = QBrush(Qt::white);
+    }
+    else
+    {
+        // shade across the dot itself, from the top-left highlight
+        QLinearGradient gradient(QPointF(radius - int(dotDiam), radius - int(dotDiam)),
+                                 QPointF(radius, radius));
+        gradient.setColorAt(0.0, Qt::white);
+        gradient.setColorAt(1.0, QColor(0xa6, 0xce, 0x39));
+        circleBrush = QBrush(gradient);
+    }
+    QPen circlePen(Qt::black);
+    circlePen.setWidth(1);
+
+    QPainter spritePainter(&spriteImage);
+    spritePainter.setRenderHint(QPainter::Antialiasing);
+    spritePainter.setBrush(circleBrush);
+    spritePainter.setPen(circlePen);
+    spritePainter.drawEllipse(QPoint(radius, radius), int(dotDiam), int(dotDiam));
+    spritePainter.end();
+    return QPixmap::fromImage(spriteImage);
+}
+
 /** ****************************************************************************
  * Function: setPos()
  *   Manually give the Dot a new position
@@ -126,8 +151,19 @@ void Dot::paint(QPainter *painter, QPaintEvent *event) const
 void Dot::setPos(QPoint& newPos)
 {
     applyBoundaryCheck(newPos);
-    m_curLoc = newPos;
-    emit newDotLoc(m_curLoc);
+    m_simPtr->setPos(SimPoint(newPos.x(), newPos.y()));
+    emit newDotLoc(newPos);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setBounds()
+ *   Cache the size of the parent area so the motion model never has to ask
+ *   the widget for it.  Doesn't move the Dot; use setPos() for that.
+*******************************************************************************/
+void Dot::setBounds(const QSize& bounds)
+{
+    m_simPtr->setBounds(bounds.width(), bounds.height());
     return;
 }
 
@@ -139,14 +175,10 @@ void Dot::setPos(QPoint& newPos)
 *******************************************************************************/
 QPoint& Dot::applyBoundaryCheck(QPoint& tmpLoc) const
 {
-    if (tmpLoc.x() < 0)
-        tmpLoc.setX(0);
-    else if (tmpLoc.x() > m_parentLocPtr->size().width())
-        tmpLoc.setX(m_parentLocPtr->size().width());
-    if (tmpLoc.y() < 0)
-        tmpLoc.setY(0);
-    else if (tmpLoc.y() > m_parentLocPtr->size().height())
-        tmpLoc.setY(m_parentLocPtr->size().height());
+    SimPoint simLoc(tmpLoc.x(), tmpLoc.y());
+    m_simPtr->applyBoundaryCheck(simLoc);
+    tmpLoc.setX(simLoc.x);
+    tmpLoc.setY(simLoc.y);
     return tmpLoc;
 }
 
@@ -159,18 +191,22 @@ QPoint& Dot::applyBoundaryCheck(QPoint& tmpLoc) const
 *******************************************************************************/
 bool Dot::setm_dotSize(uint newSize)
 {
-    if ((newSize >= DOT_DIAM_MIN) && (newSize <= DOT_DIAM_MAX))
-    {
-        m_dotSize.setWidth(newSize);
-        m_dotSize.setHeight(newSize);
-        m_moveDist = sqrt(newSize / 2);
-        //qDebug("Dot::setm_dotSize: newSize=%i newm_moveDist=%i.", newSize, m_moveDist);
-        return true;
-    }
-    else
+    return m_simPtr->setDotSize(newSize);
+}
+
+/** ****************************************************************************
+ * Function: setSkin()
+ *   Sprites of every skin stay cached, so switching back and forth is free.
+ *   Announces the (unchanged) position so the Dot is redrawn.
+*******************************************************************************/
+void Dot::setSkin(dotSkin newSkin)
+{
+    if ((newSkin >= SKIN_CLASSIC) && (newSkin < SKIN_COUNT) && (newSkin != m_skin))
     {
-        return false;
+        m_skin = newSkin;
+        emit newDotLoc(getPos());
     }
+    return;
 }
 
 /** ****************************************************************************
@@ -179,11 +215,5 @@ bool Dot::setm_dotSize(uint newSize)
 *******************************************************************************/
 float Dot::calcPosErrorRatio(const QPoint& mousePos) const
 {
-    QPoint errorPos = mousePos - m_curLoc;
-    //uint errorDist = errorPos.manhattanLength();   // Less accurate but faster calculation
-    float errorDist = sqrt(pow(errorPos.x(),2) + pow(errorPos.y(),2));  // more accurate
-    float errorRatio = errorDist / m_moveDist;
-//    qDebug("Dot::calcPosErrorRatio: DotLoc=(%i,%i) mousePos=(%i,%i) errorPos=(%i,%i) errorDist%.2f errorRatio=%.2f",
-//           m_curLoc.x(), m_curLoc.y(), mousePos.x(), mousePos.y(), errorPos.x(), errorPos.y(), errorDist, errorRatio);
-    return errorRatio;
+    return m_simPtr->calcPosErrorRatio(SimPoint(mousePos.x(), mousePos.y()));
 }
@@ -13,8 +13,9 @@
  * user tries to closely follow with their cursor to achieve a high m_score.
  *
  * The Dot class represents the dot that runs around the main window. It knows
- * its own motion vectors and how to draw itself, but only changes location
- * when instructed to (it doesn't have any timers of its own).
+ * how to draw itself and tells the window when it moves.  The motion itself is
+ * done by the headless DotSim of the game core, and only when instructed to
+ * (it doesn't have any timers of its own).
  *
  ******************************************************************************/
 
@@ -30,54 +31,68 @@
 #include <QtGui/QBrush>
 #include <QtGui/QFont>
 #include <QtGui/QPen>
+#include <QtGui/QPixmap>
+#include "dotsim.h"
+#include "gamesim.h"
+
+/// Visual styles the Dot can be drawn in.
+enum dotSkin {
+    SKIN_CLASSIC = 0,   ///< green, shaded from white
+    SKIN_MONO,          ///< plain white, for low-colour displays
+    SKIN_COUNT
+};
 
 /** ****************************************************************************
  * @class Dot
- *   The Dot class represents the dot that runs around the main window. It knows
- *   its own motion vectors and how to draw itself, but only changes location
- *   when instructed to (it doesn't have any timers of its own).
+ *   The Dot class represents the dot that runs around the main window. It is a
+ *   view over a DotSim: it draws the dot and announces its moves, but only
+ *   changes location when instructed to (it doesn't have any timers of its own).
 *******************************************************************************/
 class Dot : public QObject
 {
     Q_OBJECT
 public:
-    explicit Dot(QWidget *parent, QPoint location);
+    explicit Dot(QWidget *parent, DotSim *simPtr);
     /// Repaint the Dot
     void paint(QPainter *painter, QPaintEvent *event) const;
     /// Manually give the Dot a new position
     void setPos(QPoint &newPos);
+    /// Cache the size of the area the Dot may move in
+    void setBounds(const QSize &bounds);
     inline const QPoint getPos() const;
     inline uint getDotSize() const;
+    inline dotSkin getSkin() const;
+    /// Area covered by the drawn Dot, including outline and antialiasing
+    QRect boundingRect() const;
     /// Verify that the position is not outside its window boundaries
     QPoint &applyBoundaryCheck(QPoint &tmpLoc) const;
     /// Calculate Position Error Ratio
     float calcPosErrorRatio(const QPoint &mousePos) const;
+    /// Announce a position change made directly on the DotSim
+    void notifyMoved() const;
+    /// Pre-rendered image of the dot for the current size and skin
+    const QPixmap &sprite() const;
 
-    /// Incremental distance the dot will move.  must NOT be zero.
-    static const uint MOVE_DISTANCE_DEFAULT =  3;
     /// Minimum programmable dot speed
-    static const uint DOT_SPEED_MIN         =  2;
+    static const uint DOT_SPEED_MIN         = GameSim::DOT_SPEED_MIN;
     /// Default speed of the dot, in milliseconds
-    static const uint DOT_SPEED_DEFAULT     = 40;
+    static const uint DOT_SPEED_DEFAULT     = GameSim::DOT_SPEED_DEFAULT;
     /// Maximum programmable dot speed
-    static const uint DOT_SPEED_MAX         = 50;
+    static const uint DOT_SPEED_MAX         = GameSim::DOT_SPEED_MAX;
     /// Minimum Diameter of the drawn dot
-    static const uint DOT_DIAM_MIN          =  8;
+    static const uint DOT_DIAM_MIN          = DotSim::DOT_DIAM_MIN;
     /// Diameter of the drawn dot, in pixels
-    static const uint DOT_DIAM_DEFAULT      = 20;
+    static const uint DOT_DIAM_DEFAULT      = DotSim::DOT_DIAM_DEFAULT;
     /// Maximum Diameter of the drawn dot
-    static const uint DOT_DIAM_MAX          = 50;
+    static const uint DOT_DIAM_MAX          = DotSim::DOT_DIAM_MAX;
     /// Minimum Dot Acceleration
-    static const uint DOT_ACCEL_MIN         =  0;
+    static const uint DOT_ACCEL_MIN         = GameSim::DOT_ACCEL_MIN;
     /// Number of milliseconds to speed up the dot movement by.
-    static const uint DOT_ACCEL_DEFAULT     =  1;
+    static const uint DOT_ACCEL_DEFAULT     = GameSim::DOT_ACCEL_DEFAULT;
     /// Maximum Dot Acceleration
-    static const uint DOT_ACCEL_MAX         =  5;
+    static const uint DOT_ACCEL_MAX         = GameSim::DOT_ACCEL_MAX;
     /// length of time (in ms) between m_dotSpeed increases
-    static const uint DOT_ACCELERATION_UPDATE_INTERVAL_MS = 2000;
-    /** Dot motion is a weighted sum of current direction and new random vector.
-        MOTION_WEIGHT should be 0.0<x<1.0 and represents the weight of the current vector component.*/
-    static const float MOTION_WEIGHT_DEFAULT = 0.7;
+    static const uint DOT_ACCELERATION_UPDATE_INTERVAL_MS = GameSim::DOT_ACCELERATION_UPDATE_INTERVAL_MS;
 
 signals:
     /// Manually tell the dot a new position
@@ -87,6 +102,8 @@ public slots:
     void updateLoc();
     /// Change the dot's visual size, in pixel diameter
     bool setm_dotSize(uint newSize);
+    /// Change the way the dot is drawn
+    void setSkin(dotSkin newSkin);
 private:
     /* Private non-defined function prototypes disables compiler generation. */
     /// prevent copy operator
@@ -94,25 +111,22 @@ private:
     /// prevent assignment operator
     Dot& operator=(const Dot&);
 
-    // Movement-related members:
-    /// Parent widget, for requesting window size
-    QWidget* m_parentLocPtr;
-    /// Current location of the dot
-    QPoint m_curLoc;
-    /// Current direction of motion
-    QVector2D m_curMoveVect;
-    /// Distance that dot should move when updated
-    uint m_moveDist;
-    /// Weight of the current vector component
-    const float m_motionWeight;
+    /// Render the dot once, for the sprite cache
+    static QPixmap renderSprite(uint dotDiam, dotSkin skin);
+    /// Distance from the Dot's center to the edge of its sprite
+    static inline int spriteRadius(uint dotDiam);
+
+    /// Room around the circle for the outline and antialiasing, in pixels
+    static const int SPRITE_MARGIN = 2;
+
+    /// Headless motion model, owned by the game simulation
+    DotSim* m_simPtr;
 
     // visualizataion-related members:
-    /// Size (W,H) of the dot to draw
-    QSize m_dotSize;
-    /// Brush for the fill color/pattern of the dot
-    QBrush m_circleBrush;
-    /// Line for the outside of the dot
-    QPen m_circlePen;
+    /// How the dot is drawn
+    dotSkin m_skin;
+    /// Rendered dots, built the first time each size/skin is painted
+    mutable QPixmap m_spriteCache[SKIN_COUNT][DOT_DIAM_MAX + 1];
 };
 
 
@@ -122,15 +136,32 @@ private:
 *******************************************************************************/
 inline const QPoint Dot::getPos() const
 {
-    return m_curLoc;
+    const SimPoint simPos = m_simPtr->getPos();
+    return QPoint(simPos.x, simPos.y);
 }
 /** ****************************************************************************
- * Function: getm_dotSize()
+ * Function: getDotSize()
  *
 *******************************************************************************/
 inline uint Dot::getDotSize() const
 {
-    return m_dotSize.width();
+    return m_simPtr->getDotSize();
+}
+/** ****************************************************************************
+ * Function: getSkin()
+ *
+*******************************************************************************/
+inline dotSkin Dot::getSkin() const
+{
+    return m_skin;
+}
+/** ****************************************************************************
+ * Function: spriteRadius()
+ *   paint() has always used the diameter as the ellipse radius.
+*******************************************************************************/
+inline int Dot::spriteRadius(uint dotDiam)
+{
+    return dotDiam + SPRITE_MARGIN;
 }
 
 #endif // DOT_H
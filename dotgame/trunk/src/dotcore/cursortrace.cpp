@@ -0,0 +1,100 @@
+/** ****************************************************************************
+ * @file cursortrace.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * CursorTrace is a fixed-size ring buffer of timestamped cursor positions.  The
+ * window pushes a sample for every mouse move; the game simulation pops them
+ * in time order as game time passes.  Samples closer together than the
+ * simulation can resolve are coalesced, so a 1000 Hz mouse can't flood it.
+ *
+ ******************************************************************************/
+
+#include "cursortrace.h"
+
+/** ****************************************************************************
+ * CursorTrace Constructor
+*******************************************************************************/
+CursorTrace::CursorTrace() :
+    m_head(0), m_count(0), m_coalescedSamples(0), m_droppedSamples(0)
+{
+}
+
+/** ****************************************************************************
+ * Function: push()
+ *   A sample within COALESCE_US of the newest one replaces that one's
+ *   position but keeps its time, so a burst becomes one sample per
+ *   COALESCE_US holding the latest position.
+ *   @param timeUs Game time of the sample, in microseconds.
+ *   @param pos Cursor position, in arena coordinates.
+ *   @param coalesce false to always add the sample, e.g. one already
+ *      coalesced when it was recorded.
+*******************************************************************************/
+void CursorTrace::push(int64_t timeUs, const SimPoint &pos, bool coalesce)
+{
+    if (m_count > 0)
+    {
+        CursorSample &newest = m_samples[(m_head + m_count - 1) & (CAPACITY - 1)];
+        if (timeUs < newest.timeUs)
+        {
+            timeUs = newest.timeUs;     // keep the ring in time order
+        }
+        if (coalesce && (timeUs - newest.timeUs < COALESCE_US))
+        {
+            newest.pos = pos;
+            ++m_coalescedSamples;
+            return;
+        }
+    }
+    if (m_count == CAPACITY)
+    {
+        m_head = (m_head + 1) & (CAPACITY - 1);     // overwrite the oldest
+        --m_count;
+        ++m_droppedSamples;
+    }
+    CursorSample &sample = m_samples[(m_head + m_count) & (CAPACITY - 1)];
+    sample.timeUs = timeUs;
+    sample.pos = pos;
+    ++m_count;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: pop()
+ *   @param sample Receives the oldest sample, if there is one in time.
+ *   @param upToUs Only samples at or before this game time are returned.
+ *   @return false if there is no sample at or before upToUs.
+*******************************************************************************/
+bool CursorTrace::pop(CursorSample &sample, int64_t upToUs)
+{
+    if ((m_count == 0) || (m_samples[m_head].timeUs > upToUs))
+    {
+        return false;
+    }
+    sample = m_samples[m_head];
+    m_head = (m_head + 1) & (CAPACITY - 1);
+    --m_count;
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: clear()
+ *
+*******************************************************************************/
+void CursorTrace::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_coalescedSamples = 0;
+    m_droppedSamples = 0;
+    return;
+}
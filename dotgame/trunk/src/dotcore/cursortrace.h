@@ -0,0 +1,103 @@
+/** ****************************************************************************
+ * @file cursortrace.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * CursorTrace is a fixed-size ring buffer of timestamped cursor positions.  The
+ * window pushes a sample for every mouse move; the game simulation pops them
+ * in time order as game time passes.  Samples closer together than the
+ * simulation can resolve are coalesced, so a 1000 Hz mouse can't flood it.
+ *
+ ******************************************************************************/
+
+#ifndef CURSORTRACE_H
+#define CURSORTRACE_H
+
+#include "dotsim.h"           // for SimPoint
+
+/** ****************************************************************************
+ * @struct CursorSample
+ *   Where the cursor was, and when, in game time.
+*******************************************************************************/
+struct CursorSample {
+    /// Game time of the sample, in microseconds
+    int64_t timeUs;
+    /// Cursor position, in arena coordinates
+    SimPoint pos;
+};
+
+/** ****************************************************************************
+ * @class CursorTrace
+ *   Single-threaded ring buffer of CursorSamples, oldest first.  When full, the
+ *   oldest sample is dropped to make room.
+*******************************************************************************/
+class CursorTrace
+{
+public:
+    CursorTrace();
+
+    /// Add a sample; timestamps must not go backwards (they are clamped)
+    void push(int64_t timeUs, const SimPoint &pos, bool coalesce = true);
+    /// Remove the oldest sample if it is no later than upToUs
+    bool pop(CursorSample &sample, int64_t upToUs);
+    /// Forget all samples
+    void clear();
+
+    inline unsigned int size() const;
+    inline unsigned int getCoalescedSamples() const;
+    inline unsigned int getDroppedSamples() const;
+
+    /// Number of samples held.  Power of two; ~256 ms of a 1000 Hz mouse.
+    static const unsigned int CAPACITY = 256;
+    /// Samples this close to the newest one only update its position
+    static const int64_t COALESCE_US = 1000;
+
+private:
+    /// The ring
+    CursorSample m_samples[CAPACITY];
+    /// Index of the oldest sample
+    unsigned int m_head;
+    /// Number of samples in the ring
+    unsigned int m_count;
+    /// Samples merged into the previous one
+    unsigned int m_coalescedSamples;
+    /// Samples lost because the ring was full
+    unsigned int m_droppedSamples;
+};
+
+
+/** ****************************************************************************
+ * Function: size()
+ *
+*******************************************************************************/
+inline unsigned int CursorTrace::size() const
+{
+    return m_count;
+}
+/** ****************************************************************************
+ * Function: getCoalescedSamples()
+ *
+*******************************************************************************/
+inline unsigned int CursorTrace::getCoalescedSamples() const
+{
+    return m_coalescedSamples;
+}
+/** ****************************************************************************
+ * Function: getDroppedSamples()
+ *
+*******************************************************************************/
+inline unsigned int CursorTrace::getDroppedSamples() const
+{
+    return m_droppedSamples;
+}
+
+#endif // CURSORTRACE_H
@@ -0,0 +1,8 @@
+# Link a project against the dotcore static library.
+# Set DOTCORE_OUT_PWD to the build directory of dotcore.pro before including.
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+LIBS += -L$$DOTCORE_OUT_PWD -ldotcore
+win32-msvc*: PRE_TARGETDEPS += $$DOTCORE_OUT_PWD/dotcore.lib
+else: PRE_TARGETDEPS += $$DOTCORE_OUT_PWD/libdotcore.a
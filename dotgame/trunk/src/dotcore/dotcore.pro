@@ -0,0 +1,25 @@
+# Headless simulation core of the Dot Game: dot motion and scoring, without Qt.
+# Built as a static library so the game, tests and batch tools share one copy.
+TEMPLATE = lib
+TARGET = dotcore
+CONFIG += staticlib
+CONFIG -= qt
+# Keep the library directly in the build directory (no debug/release subfolders)
+DESTDIR = $$OUT_PWD
+
+SOURCES += \
+    cursortrace.cpp \
+    dotsim.cpp \
+    gamereplay.cpp \
+    gamesim.cpp \
+    latencyhistogram.cpp \
+    swarmsim.cpp
+
+HEADERS += \
+    cursortrace.h \
+    dotrandom.h \
+    dotsim.h \
+    gamereplay.h \
+    gamesim.h \
+    latencyhistogram.h \
+    swarmsim.h
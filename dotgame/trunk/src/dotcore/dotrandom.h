@@ -0,0 +1,124 @@
+/** ****************************************************************************
+ * @file dotrandom.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * DotRandom is a small, fast random number generator (PCG32, see
+ * www.pcg-random.org) for the dot motion.  Every game has a seed and every dot
+ * its own stream, so a game can be replayed bit-exactly from its seed and
+ * simulations never share generator state.
+ *
+ ******************************************************************************/
+
+#ifndef DOTRANDOM_H
+#define DOTRANDOM_H
+
+#include <stdint.h>           // for uint32_t, uint64_t
+
+/** ****************************************************************************
+ * @class DotRandom
+ *   PCG32 generator: 64-bit state, 32-bit output, selectable stream.  Two
+ *   generators with the same seed but different streams are independent.
+*******************************************************************************/
+class DotRandom
+{
+public:
+    explicit inline DotRandom(uint64_t gameSeed = DEFAULT_SEED, uint64_t stream = 0);
+
+    /// Restart the sequence for a seed and stream
+    inline void seed(uint64_t gameSeed, uint64_t stream = 0);
+    /// Next 32 random bits
+    inline uint32_t next();
+    /// Random number 0 <= x < range, without a division
+    inline uint32_t bounded(uint32_t range);
+    /// The same, from 32 random bits already drawn (whose other bits are used too)
+    static inline uint32_t bounded(uint32_t randomBits, uint32_t range);
+
+    /// Spread the bits of a weak seed (like a time stamp) over all 64 bits
+    static inline uint64_t mixSeed(uint64_t value);
+
+    /// Seed used when none is given
+    static const uint64_t DEFAULT_SEED = 0x853c49e6748fea9bULL;
+
+private:
+    static const uint64_t MULTIPLIER = 6364136223846793005ULL;
+    uint64_t m_state;
+    /// Stream selector, always odd
+    uint64_t m_increment;
+};
+
+
+/** ****************************************************************************
+ * DotRandom Constructor
+ *  @param gameSeed Seed of the game.
+ *  @param stream Stream within the game, e.g. the index of the dot.
+*******************************************************************************/
+inline DotRandom::DotRandom(uint64_t gameSeed, uint64_t stream) :
+    m_state(0), m_increment(1)
+{
+    seed(gameSeed, stream);
+}
+/** ****************************************************************************
+ * Function: seed()
+ *
+*******************************************************************************/
+inline void DotRandom::seed(uint64_t gameSeed, uint64_t stream)
+{
+    m_state = 0;
+    m_increment = (stream << 1) | 1;
+    next();
+    m_state += gameSeed;
+    next();
+}
+/** ****************************************************************************
+ * Function: next()
+ *   One LCG step; the output is a permuted (xorshift, random rotate) copy of
+ *   the old state.
+*******************************************************************************/
+inline uint32_t DotRandom::next()
+{
+    const uint64_t oldState = m_state;
+    m_state = oldState * MULTIPLIER + m_increment;
+    const uint32_t xorShifted = static_cast<uint32_t>(((oldState >> 18) ^ oldState) >> 27);
+    const uint32_t rotate = static_cast<uint32_t>(oldState >> 59);
+    return (xorShifted >> rotate) | (xorShifted << ((32 - rotate) & 31));
+}
+/** ****************************************************************************
+ * Function: bounded()
+ *   Multiply-shift instead of modulo.  The bias is below range/2^32, which is
+ *   nothing for the handful of values the dot motion asks for.
+*******************************************************************************/
+inline uint32_t DotRandom::bounded(uint32_t range)
+{
+    return bounded(next(), range);
+}
+/** ****************************************************************************
+ * Function: bounded()
+ *   Uses the high bits of randomBits, so the low ones are still free.
+*******************************************************************************/
+inline uint32_t DotRandom::bounded(uint32_t randomBits, uint32_t range)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(randomBits) * range) >> 32);
+}
+/** ****************************************************************************
+ * Function: mixSeed()
+ *   SplitMix64 finalizer.
+*******************************************************************************/
+inline uint64_t DotRandom::mixSeed(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+#endif // DOTRANDOM_H
@@ -0,0 +1,209 @@
+/** ****************************************************************************
+ * @file dotsim.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * DotSim is the headless motion model of a single dot: the random walk, the
+ * boundary 'bounce' and the position error ratio.  It has no Qt dependency and
+ * caches its arena bounds, so it can run without any window at all.
+ *
+ ******************************************************************************/
+
+#include "dotsim.h"
+#include <math.h>             // for sqrt()
+
+const float DotSim::MOTION_WEIGHT_DEFAULT = 0.7f;
+
+/** ****************************************************************************
+ * Function: roundToInt()
+ *   Round half away from zero, the same as qRound(), so the core moves the dot
+ *   exactly like the QVector2D based code did.
+*******************************************************************************/
+static inline int roundToInt(double d)
+{
+    return (d >= 0.0) ? int(d + 0.5) : int(d - double(int(d - 1)) + 0.5) + int(d - 1);
+}
+
+/** ****************************************************************************
+ * DotSim Constructor
+ *  @param location Position of the center of the dot within the arena.
+ *  @param boundWidth Width of the arena, in pixels.
+ *  @param boundHeight Height of the arena, in pixels.
+ *  @param gameSeed Seed of the game; the same seed replays the same motion.
+ *  @param stream Random stream of this dot within the game.
+*******************************************************************************/
+DotSim::DotSim(SimPoint location, int boundWidth, int boundHeight,
+               uint64_t gameSeed, uint64_t stream) :
+    m_curLoc(location), m_curMoveVectX(0), m_curMoveVectY(0),
+    m_moveDist(MOVE_DISTANCE_DEFAULT), m_motionWeight(MOTION_WEIGHT_DEFAULT),
+    m_dotDiam(DOT_DIAM_DEFAULT), m_boundWidth(boundWidth), m_boundHeight(boundHeight),
+    m_random(gameSeed, stream)
+{
+    setDotSize(DOT_DIAM_DEFAULT);    // sets dot size and m_moveDist
+    applyBoundaryCheck(m_curLoc);    // make sure dot is placed within the arena.
+}
+
+/** ****************************************************************************
+ * Function: updateLoc()
+ *   Tells the dot to randomly generate a new location for itself.
+*******************************************************************************/
+void DotSim::updateLoc()
+{
+    const int moveDist = m_moveDist;
+    const uint32_t tempRand = m_random.next();
+    // distance (-m_moveDist<= tempX <= m_moveDist), from the high bits
+    int randIntX = static_cast<int>(DotRandom::bounded(tempRand, 2*moveDist + 1)) - moveDist;
+    const int ySign = (tempRand & 1) ? 1 : -1;       // the Y orientation, from the low bit
+    float randMoveX = randIntX;
+    float randMoveY = ySign * sqrt(double(moveDist*moveDist - randIntX*randIntX));    // corresponding point on a circle
+    /* To smooth out the random motion of the dot, do a weighted average with
+       previous motion vector, so the dot moves in sort of curved lines. */
+    m_curMoveVectX = (m_curMoveVectX * m_motionWeight) + (randMoveX * (1-m_motionWeight));
+    m_curMoveVectY = (m_curMoveVectY * m_motionWeight) + (randMoveY * (1-m_motionWeight));
+    double lenSquared = double(m_curMoveVectX)*double(m_curMoveVectX) +
+            double(m_curMoveVectY)*double(m_curMoveVectY);
+    if (lenSquared > 1e-12)
+    {
+        double len = sqrt(lenSquared);
+        m_curMoveVectX = float(m_curMoveVectX / len) * float(m_moveDist);
+        m_curMoveVectY = float(m_curMoveVectY / len) * float(m_moveDist);
+    }
+    else
+    {
+        m_curMoveVectX = 0;
+        m_curMoveVectY = 0;
+    }
+    m_curLoc.x += roundToInt(m_curMoveVectX);
+    m_curLoc.y += roundToInt(m_curMoveVectY);
+    /* 1) Make sure that the dot doesn't move outside the arena.
+     *  2) If the dot hits the edge, point it back towards the center.
+     *       We could rotate the vector, but inverting looks more natural,
+     *       like a 'bounce'.  */
+    const float invertWeight = -1.0;
+    if (m_curLoc.x < 0)
+    {
+        m_curLoc.x = 0;
+        m_curMoveVectX *= invertWeight;
+    }
+    else if (m_curLoc.x > m_boundWidth)
+    {
+        m_curLoc.x = m_boundWidth;
+        m_curMoveVectX *= invertWeight;
+    }
+    if (m_curLoc.y < 0)
+    {
+        m_curLoc.y = 0;
+        m_curMoveVectY *= invertWeight;
+    }
+    else if (m_curLoc.y > m_boundHeight)
+    {
+        m_curLoc.y = m_boundHeight;
+        m_curMoveVectY *= invertWeight;
+    }
+    return;
+} // function updateLoc()
+
+/** ****************************************************************************
+ * Function: seed()
+ *   Restart the random motion for a new game.  The motion vector is cleared
+ *   too, so the dot's path only depends on its position and the seed.
+*******************************************************************************/
+void DotSim::seed(uint64_t gameSeed, uint64_t stream)
+{
+    m_random.seed(gameSeed, stream);
+    m_curMoveVectX = 0;
+    m_curMoveVectY = 0;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setPos()
+ *   Manually give the dot a new position
+*******************************************************************************/
+void DotSim::setPos(SimPoint newPos)
+{
+    m_curLoc = applyBoundaryCheck(newPos);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setBounds()
+ *   Cache the arena size.  The dot itself is not moved; call setPos() or
+ *   applyBoundaryCheck() if it has to follow a shrinking arena.
+*******************************************************************************/
+void DotSim::setBounds(int width, int height)
+{
+    m_boundWidth = width;
+    m_boundHeight = height;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: applyBoundaryCheck()
+ *   Verify that the location is not outside the arena boundary.
+ *   Update the passed-in location to be within the boundaries.  Doesn't
+ *   actually modify the state of the dot, so it's more flexible.
+*******************************************************************************/
+SimPoint& DotSim::applyBoundaryCheck(SimPoint& tmpLoc) const
+{
+    if (tmpLoc.x < 0)
+        tmpLoc.x = 0;
+    else if (tmpLoc.x > m_boundWidth)
+        tmpLoc.x = m_boundWidth;
+    if (tmpLoc.y < 0)
+        tmpLoc.y = 0;
+    else if (tmpLoc.y > m_boundHeight)
+        tmpLoc.y = m_boundHeight;
+    return tmpLoc;
+}
+
+/** ****************************************************************************
+ * Function: setDotSize()
+ *     Dot size can be used to either adjust for screen size or to increase difficulty.
+ *     For screen size, as the dot size is decreased, the distance moved should decrease.
+ *     Linear scaling seemed to make the fast dots move faster, so use sqrt instead.
+ *   @return Returns true if size was changed, false if value out of range.
+*******************************************************************************/
+bool DotSim::setDotSize(unsigned int newSize)
+{
+    if ((newSize >= DOT_DIAM_MIN) && (newSize <= DOT_DIAM_MAX))
+    {
+        m_dotDiam = newSize;
+        m_moveDist = moveDistForSize(newSize);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/** ****************************************************************************
+ * Function: moveDistForSize()
+ *   Linear scaling seemed to make the fast dots move faster, so use sqrt.
+*******************************************************************************/
+unsigned int DotSim::moveDistForSize(unsigned int dotDiam)
+{
+    return sqrt(double(dotDiam / 2));
+}
+
+/** ****************************************************************************
+ * Function: calcPosErrorRatio()
+ *   Calculate current error distance and ratio with m_moveDist
+*******************************************************************************/
+float DotSim::calcPosErrorRatio(const SimPoint& cursorPos) const
+{
+    const float errorX = cursorPos.x - m_curLoc.x;
+    const float errorY = cursorPos.y - m_curLoc.y;
+    float errorDist = sqrt(errorX*errorX + errorY*errorY);
+    return errorDist / m_moveDist;
+}
@@ -0,0 +1,144 @@
+/** ****************************************************************************
+ * @file dotsim.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * DotSim is the headless motion model of a single dot: the random walk, the
+ * boundary 'bounce' and the position error ratio.  It has no Qt dependency and
+ * caches its arena bounds, so it can run without any window at all.
+ *
+ ******************************************************************************/
+
+#ifndef DOTSIM_H
+#define DOTSIM_H
+
+#include "dotrandom.h"
+
+/** ****************************************************************************
+ * @struct SimPoint
+ *   Integer pixel position, the Qt-free equivalent of a QPoint.
+*******************************************************************************/
+struct SimPoint {
+    SimPoint() : x(0), y(0) {}
+    SimPoint(int newX, int newY) : x(newX), y(newY) {}
+    int x;
+    int y;
+};
+
+/** ****************************************************************************
+ * @class DotSim
+ *   The motion model of a single dot.  Knows its own motion vector and the
+ *   size of the arena it lives in, but only moves when told to.
+*******************************************************************************/
+class DotSim
+{
+public:
+    explicit DotSim(SimPoint location = SimPoint(), int boundWidth = 0, int boundHeight = 0,
+                    uint64_t gameSeed = DotRandom::DEFAULT_SEED, uint64_t stream = 0);
+
+    /// Tell the dot to randomly change its location
+    void updateLoc();
+    /// Restart the random motion: new seed/stream, and no carried-over direction
+    void seed(uint64_t gameSeed, uint64_t stream = 0);
+    /// Manually give the dot a new position (boundary checked)
+    void setPos(SimPoint newPos);
+    /// Set the arena size; the dot is kept within (0,0)..(width,height)
+    void setBounds(int width, int height);
+    /// Verify that the position is not outside the arena boundaries
+    SimPoint &applyBoundaryCheck(SimPoint &tmpLoc) const;
+    /// Change the dot's diameter, which also sets the move distance
+    bool setDotSize(unsigned int newSize);
+    /// Calculate Position Error Ratio
+    float calcPosErrorRatio(const SimPoint &cursorPos) const;
+    /// Move distance that goes with a dot diameter
+    static unsigned int moveDistForSize(unsigned int dotDiam);
+
+    inline SimPoint getPos() const;
+    inline unsigned int getDotSize() const;
+    inline unsigned int getMoveDist() const;
+    inline int getBoundWidth() const;
+    inline int getBoundHeight() const;
+
+    /// Incremental distance the dot will move.  must NOT be zero.
+    static const unsigned int MOVE_DISTANCE_DEFAULT =  3;
+    /// Minimum Diameter of the drawn dot
+    static const unsigned int DOT_DIAM_MIN          =  8;
+    /// Diameter of the drawn dot, in pixels
+    static const unsigned int DOT_DIAM_DEFAULT      = 20;
+    /// Maximum Diameter of the drawn dot
+    static const unsigned int DOT_DIAM_MAX          = 50;
+    /** Dot motion is a weighted sum of current direction and new random vector.
+        MOTION_WEIGHT should be 0.0<x<1.0 and represents the weight of the current vector component.*/
+    static const float MOTION_WEIGHT_DEFAULT;
+
+private:
+    /// Current location of the dot
+    SimPoint m_curLoc;
+    /// Current direction of motion
+    float m_curMoveVectX;
+    float m_curMoveVectY;
+    /// Distance that dot should move when updated
+    unsigned int m_moveDist;
+    /// Weight of the current vector component
+    float m_motionWeight;
+    /// Diameter of the dot, in pixels
+    unsigned int m_dotDiam;
+    /// Cached arena size, so no window has to be asked on every tick
+    int m_boundWidth;
+    int m_boundHeight;
+    /// This dot's own random stream
+    DotRandom m_random;
+};
+
+
+/** ****************************************************************************
+ * Function: getPos()
+ *   What is the current position of the dot?
+*******************************************************************************/
+inline SimPoint DotSim::getPos() const
+{
+    return m_curLoc;
+}
+/** ****************************************************************************
+ * Function: getDotSize()
+ *   What is the diameter of the dot, in pixels?
+*******************************************************************************/
+inline unsigned int DotSim::getDotSize() const
+{
+    return m_dotDiam;
+}
+/** ****************************************************************************
+ * Function: getMoveDist()
+ *   How far does the dot move per update, in pixels?
+*******************************************************************************/
+inline unsigned int DotSim::getMoveDist() const
+{
+    return m_moveDist;
+}
+/** ****************************************************************************
+ * Function: getBoundWidth()
+ *
+*******************************************************************************/
+inline int DotSim::getBoundWidth() const
+{
+    return m_boundWidth;
+}
+/** ****************************************************************************
+ * Function: getBoundHeight()
+ *
+*******************************************************************************/
+inline int DotSim::getBoundHeight() const
+{
+    return m_boundHeight;
+}
+
+#endif // DOTSIM_H
@@ -0,0 +1,551 @@
+/** ****************************************************************************
+ * @file gamereplay.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Game replays: recording, decoding and playing back.  See gamereplay.h for
+ * the file layout.
+ *
+ ******************************************************************************/
+
+#include "gamereplay.h"
+
+/// Start of every replay file
+static const uint8_t REPLAY_MAGIC[4] = { 'D', 'O', 'T', 'R' };
+/// Bits of a record header holding the record type
+static const unsigned int RECORD_TYPE_BITS = 2;
+/// Scores are stored as fixed point, in thousandths
+static const float SCORE_SCALE = 1000.0f;
+/// Record times are stored in whole ms: game time only has ms steps, and
+///   GameSim rounds the cursor samples to them
+static const int64_t RECORD_TIME_UNIT_US = 1000;
+
+/** ****************************************************************************
+ * Function: zigzag()
+ *   Map signed to unsigned so small magnitudes get small varints:
+ *   0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+*******************************************************************************/
+static inline uint64_t zigzag(int64_t value)
+{
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+static inline int64_t unzigzag(uint64_t value)
+{
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+/** ****************************************************************************
+ * Function: interleave()
+ *   Merge the bits of two zigzagged deltas, x in the even bits and y in the
+ *   odd ones, so a small move in both fits one varint byte: |dx|,|dy| <= 3.
+*******************************************************************************/
+static inline uint64_t interleave(uint32_t x, uint32_t y)
+{
+    uint64_t value = 0;
+    for (unsigned int bit = 0; bit < 32; ++bit)
+    {
+        value |= (uint64_t((x >> bit) & 1) << (2*bit)) | (uint64_t((y >> bit) & 1) << (2*bit + 1));
+    }
+    return value;
+}
+static inline void deinterleave(uint64_t value, uint32_t &x, uint32_t &y)
+{
+    x = 0;
+    y = 0;
+    for (unsigned int bit = 0; bit < 32; ++bit)
+    {
+        x |= uint32_t((value >> (2*bit)) & 1) << bit;
+        y |= uint32_t((value >> (2*bit + 1)) & 1) << bit;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: appendVarint()
+ *   LEB128: seven bits per byte, low bits first, top bit set on all but the
+ *   last byte.
+*******************************************************************************/
+static void appendVarint(std::vector<uint8_t> &data, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        data.push_back(uint8_t(value | 0x80));
+        value >>= 7;
+    }
+    data.push_back(uint8_t(value));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: readVarint()
+ *   @return false if the data ends inside the varint or it is too long.
+*******************************************************************************/
+static bool readVarint(const uint8_t *&readPtr, const uint8_t *endPtr, uint64_t &value)
+{
+    value = 0;
+    for (unsigned int shift = 0; (shift < 64) && (readPtr < endPtr); shift += 7)
+    {
+        const uint8_t byte = *readPtr++;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** ****************************************************************************
+ * ReplayWriter Constructor
+*******************************************************************************/
+ReplayWriter::ReplayWriter() :
+    m_lastTimeUs(0)
+{
+}
+
+/** ****************************************************************************
+ * Function: begin()
+ *   Call after the game has been reset and before its first step.  Drops any
+ *   previous recording.
+*******************************************************************************/
+void ReplayWriter::begin(const GameSim &gameSim)
+{
+    m_data.clear();
+    for (unsigned int byteNum = 0; byteNum < sizeof(REPLAY_MAGIC); ++byteNum)
+    {
+        m_data.push_back(REPLAY_MAGIC[byteNum]);
+    }
+    m_data.push_back(REPLAY_FORMAT_VERSION);
+    const uint64_t seed = gameSim.getGameSeed();
+    for (unsigned int byteNum = 0; byteNum < 8; ++byteNum)
+    {
+        m_data.push_back(uint8_t(seed >> (8 * byteNum)));
+    }
+    const DotSim &dot = gameSim.dot();
+    m_lastDotPos = dot.getPos();
+    m_lastCursorPos = gameSim.getCursorPos();
+    m_lastTimeUs = 0;
+    appendVarint(m_data, uint64_t(dot.getBoundWidth()));
+    appendVarint(m_data, uint64_t(dot.getBoundHeight()));
+    appendVarint(m_data, zigzag(m_lastDotPos.x));
+    appendVarint(m_data, zigzag(m_lastDotPos.y));
+    appendVarint(m_data, zigzag(m_lastCursorPos.x));
+    appendVarint(m_data, zigzag(m_lastCursorPos.y));
+    appendVarint(m_data, dot.getDotSize());
+    appendVarint(m_data, gameSim.getDotSpeed());
+    appendVarint(m_data, gameSim.getDotAcceleration());
+    appendVarint(m_data, gameSim.getTimeLimit());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: appendRecord()
+ *   Record header and position, both as deltas from the previous ones.
+*******************************************************************************/
+void ReplayWriter::appendRecord(int type, int64_t timeUs, const SimPoint &pos, SimPoint &lastPos)
+{
+    appendVarint(m_data, (zigzag((timeUs - m_lastTimeUs) / RECORD_TIME_UNIT_US) << RECORD_TYPE_BITS) |
+                         uint64_t(type));
+    appendVarint(m_data, interleave(uint32_t(zigzag(int64_t(pos.x) - lastPos.x)),
+                                    uint32_t(zigzag(int64_t(pos.y) - lastPos.y))));
+    m_lastTimeUs = timeUs;
+    lastPos = pos;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: cursorSample()
+ *
+*******************************************************************************/
+void ReplayWriter::cursorSample(int64_t timeUs, const SimPoint &cursorPos)
+{
+    appendRecord(ReplayRecord::CURSOR, timeUs, cursorPos, m_lastCursorPos);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: statsSample()
+ *
+*******************************************************************************/
+void ReplayWriter::statsSample(int64_t timeUs, const SimPoint &dotPos)
+{
+    appendRecord(ReplayRecord::STATS, timeUs, dotPos, m_lastDotPos);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: settingsChanged()
+ *   All of them, whichever changed: it is rare, and the player then needs no
+ *   state to apply it.
+*******************************************************************************/
+void ReplayWriter::settingsChanged(int64_t timeUs, const GameSim &gameSim)
+{
+    const DotSim &dot = gameSim.dot();
+    appendVarint(m_data, (zigzag((timeUs - m_lastTimeUs) / RECORD_TIME_UNIT_US) << RECORD_TYPE_BITS) |
+                         uint64_t(ReplayRecord::SETTINGS));
+    m_lastTimeUs = timeUs;
+    appendVarint(m_data, uint64_t(dot.getBoundWidth()));
+    appendVarint(m_data, uint64_t(dot.getBoundHeight()));
+    appendVarint(m_data, zigzag(dot.getPos().x));
+    appendVarint(m_data, zigzag(dot.getPos().y));
+    appendVarint(m_data, dot.getDotSize());
+    appendVarint(m_data, gameSim.getDotSpeed());
+    appendVarint(m_data, gameSim.getDotAcceleration());
+    appendVarint(m_data, gameSim.getTimeLimit());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: finish()
+ *   @param reason Why the game ended.
+ *   @param score Final score, kept to three decimals.
+*******************************************************************************/
+void ReplayWriter::finish(gameOverReason reason, float score)
+{
+    appendVarint(m_data, uint64_t(ReplayRecord::END));
+    appendVarint(m_data, uint64_t(reason));
+    appendVarint(m_data, uint64_t(score * SCORE_SCALE + 0.5f));
+    return;
+}
+
+/** ****************************************************************************
+ * ReplayReader Constructor
+ *  @param data Start of the replay; not copied.
+ *  @param size Length of the replay in bytes.
+*******************************************************************************/
+ReplayReader::ReplayReader(const uint8_t *data, size_t size) :
+    m_readPtr(data), m_endPtr(data + size), m_valid(false), m_compactRecords(true),
+    m_lastTimeUs(0)
+{
+    const size_t FIXED_HEADER_SIZE = sizeof(REPLAY_MAGIC) + 1 + 8;
+    if ((data == NULL) || (size < FIXED_HEADER_SIZE))
+    {
+        return;
+    }
+    for (unsigned int byteNum = 0; byteNum < sizeof(REPLAY_MAGIC); ++byteNum)
+    {
+        if (m_readPtr[byteNum] != REPLAY_MAGIC[byteNum])
+        {
+            return;
+        }
+    }
+    m_readPtr += sizeof(REPLAY_MAGIC);
+    const uint8_t OLDEST_READABLE_VERSION = 2;
+    const uint8_t version = *m_readPtr++;
+    if ((version < OLDEST_READABLE_VERSION) || (version > REPLAY_FORMAT_VERSION))
+    {
+        return;
+    }
+    const uint8_t FIRST_COMPACT_VERSION = 4;
+    m_compactRecords = (version >= FIRST_COMPACT_VERSION);
+    m_config.gameSeed = 0;
+    for (unsigned int byteNum = 0; byteNum < 8; ++byteNum)
+    {
+        m_config.gameSeed |= uint64_t(*m_readPtr++) << (8 * byteNum);
+    }
+    uint64_t fields[10];
+    for (unsigned int fieldNum = 0; fieldNum < 10; ++fieldNum)
+    {
+        if (!readVarint(m_readPtr, m_endPtr, fields[fieldNum]))
+        {
+            return;
+        }
+    }
+    m_config.arenaWidth = static_cast<unsigned int>(fields[0]);
+    m_config.arenaHeight = static_cast<unsigned int>(fields[1]);
+    m_config.dotStart = SimPoint(int(unzigzag(fields[2])), int(unzigzag(fields[3])));
+    m_config.cursorStart = SimPoint(int(unzigzag(fields[4])), int(unzigzag(fields[5])));
+    m_config.dotDiam = static_cast<unsigned int>(fields[6]);
+    m_config.dotSpeedMs = static_cast<unsigned int>(fields[7]);
+    m_config.dotAcceleration = static_cast<unsigned int>(fields[8]);
+    m_config.timeLimitS = static_cast<unsigned int>(fields[9]);
+    m_lastDotPos = m_config.dotStart;
+    m_lastCursorPos = m_config.cursorStart;
+    m_valid = true;
+}
+
+/** ****************************************************************************
+ * Function: next()
+ *   @param record Filled in with the next record, positions and time absolute.
+ *   @return false at the end of the data, after the END record, or if the
+ *      data is cut short or corrupt.
+*******************************************************************************/
+bool ReplayReader::next(ReplayRecord &record)
+{
+    uint64_t header;
+    if (!m_valid || !readVarint(m_readPtr, m_endPtr, header))
+    {
+        return false;
+    }
+    const uint64_t type = header & ((1u << RECORD_TYPE_BITS) - 1);
+    if (type == ReplayRecord::END)
+    {
+        uint64_t reason;
+        uint64_t score;
+        m_valid = false;        // nothing may follow
+        if (!readVarint(m_readPtr, m_endPtr, reason) || !readVarint(m_readPtr, m_endPtr, score))
+        {
+            return false;
+        }
+        record.type = ReplayRecord::END;
+        record.timeUs = m_lastTimeUs;
+        record.reason = static_cast<gameOverReason>(reason);
+        record.score = float(score) / SCORE_SCALE;
+        return true;
+    }
+    if (type == ReplayRecord::SETTINGS)
+    {
+        uint64_t fields[8];
+        for (unsigned int fieldNum = 0; fieldNum < 8; ++fieldNum)
+        {
+            if (!readVarint(m_readPtr, m_endPtr, fields[fieldNum]))
+            {
+                m_valid = false;
+                return false;
+            }
+        }
+        m_lastTimeUs += recordTimeDelta(header);
+        record.type = ReplayRecord::SETTINGS;
+        record.timeUs = m_lastTimeUs;
+        record.settings = m_config;
+        record.settings.arenaWidth = static_cast<unsigned int>(fields[0]);
+        record.settings.arenaHeight = static_cast<unsigned int>(fields[1]);
+        record.settings.dotStart = SimPoint(int(unzigzag(fields[2])), int(unzigzag(fields[3])));
+        record.settings.dotDiam = static_cast<unsigned int>(fields[4]);
+        record.settings.dotSpeedMs = static_cast<unsigned int>(fields[5]);
+        record.settings.dotAcceleration = static_cast<unsigned int>(fields[6]);
+        record.settings.timeLimitS = static_cast<unsigned int>(fields[7]);
+        record.pos = record.settings.dotStart;
+        record.reason = NO_GAME_OVER;
+        record.score = 0;
+        return true;
+    }
+    uint64_t dx;
+    uint64_t dy;
+    if (m_compactRecords)
+    {
+        uint32_t packedX;
+        uint32_t packedY;
+        if (!readVarint(m_readPtr, m_endPtr, dx))
+        {
+            m_valid = false;
+            return false;
+        }
+        deinterleave(dx, packedX, packedY);
+        dx = packedX;
+        dy = packedY;
+    }
+    else if (!readVarint(m_readPtr, m_endPtr, dx) || !readVarint(m_readPtr, m_endPtr, dy))
+    {
+        m_valid = false;
+        return false;
+    }
+    SimPoint &lastPos = (type == ReplayRecord::CURSOR) ? m_lastCursorPos : m_lastDotPos;
+    lastPos.x += int(unzigzag(dx));
+    lastPos.y += int(unzigzag(dy));
+    m_lastTimeUs += recordTimeDelta(header);
+    record.type = static_cast<ReplayRecord::recordType>(type);
+    record.timeUs = m_lastTimeUs;
+    record.pos = lastPos;
+    record.reason = NO_GAME_OVER;
+    record.score = 0;
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: recordTimeDelta()
+ *
+*******************************************************************************/
+int64_t ReplayReader::recordTimeDelta(uint64_t header) const
+{
+    const int64_t delta = unzigzag(header >> RECORD_TYPE_BITS);
+    return m_compactRecords ? (delta * RECORD_TIME_UNIT_US) : delta;
+}
+
+/** ****************************************************************************
+ * ReplayPlayer Constructor
+ *  @param data Start of the replay; not copied.
+ *  @param size Length of the replay in bytes.
+*******************************************************************************/
+ReplayPlayer::ReplayPlayer(const uint8_t *data, size_t size) :
+    m_cursorReader(data, size), m_statsReader(data, size), m_cursorPending(false),
+    m_finished(false), m_mismatches(0), m_recordedReason(NO_GAME_OVER), m_recordedScore(0)
+{
+}
+
+/** ****************************************************************************
+ * Function: configure()
+ *   Put the game in the state the recording started from.  Does not attach the
+ *   player; call gameSim.setRecorder(&player) to have the replay checked.
+*******************************************************************************/
+void ReplayPlayer::configure(GameSim &gameSim) const
+{
+    const ReplayConfig &cfg = config();
+    applySettings(gameSim, cfg);
+    gameSim.resetGameStats(cfg.dotSpeedMs, cfg.gameSeed);
+    gameSim.setCursorPos(cfg.cursorStart);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: applySettings()
+ *   In the order the game applies them: the arena before the position, which
+ *   is checked against it.
+*******************************************************************************/
+void ReplayPlayer::applySettings(GameSim &gameSim, const ReplayConfig &settings)
+{
+    DotSim &dot = gameSim.dot();
+    dot.setBounds(int(settings.arenaWidth), int(settings.arenaHeight));
+    dot.setPos(settings.dotStart);
+    dot.setDotSize(settings.dotDiam);
+    gameSim.setDotSpeed(settings.dotSpeedMs);
+    gameSim.setDotAcceleration(settings.dotAcceleration);
+    gameSim.setTimeLimit(settings.timeLimitS);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: feedCursor()
+ *   Call before every step with the game time the step will reach.  The
+ *   samples were recorded as scored, so they are queued as they are, without
+ *   coalescing: each is scored in the step it was during the game (or, at a
+ *   step boundary, at the same time in the step before, which is the same).
+ *   Settings recorded at the start of this step are applied now; the file
+ *   has them before every sample scored after them.
+ *   @return true if settings were applied, so the views have to catch up.
+*******************************************************************************/
+bool ReplayPlayer::feedCursor(GameSim &gameSim, int64_t upToUs)
+{
+    const int64_t USEC_IN_MSEC = 1000;
+    const int64_t stepStartUs = int64_t(gameSim.getElapsedTimeMs()) * USEC_IN_MSEC;
+    bool settingsApplied = false;
+    while (!m_finished)
+    {
+        if (!m_cursorPending)
+        {
+            if (!m_cursorReader.next(m_pendingCursor))
+            {
+                m_finished = true;
+                break;
+            }
+            if (m_pendingCursor.type == ReplayRecord::END)
+            {
+                m_recordedReason = m_pendingCursor.reason;
+                m_recordedScore = m_pendingCursor.score;
+                m_finished = true;
+                break;
+            }
+            if ((m_pendingCursor.type != ReplayRecord::CURSOR) &&
+                (m_pendingCursor.type != ReplayRecord::SETTINGS))
+            {
+                continue;
+            }
+            m_cursorPending = true;
+        }
+        if (m_pendingCursor.type == ReplayRecord::SETTINGS)
+        {
+            if (m_pendingCursor.timeUs > stepStartUs)
+            {
+                break;
+            }
+            m_cursorPending = false;
+            applySettings(gameSim, m_pendingCursor.settings);
+            settingsApplied = true;
+            continue;
+        }
+        if (m_pendingCursor.timeUs > upToUs)
+        {
+            break;
+        }
+        m_cursorPending = false;
+        gameSim.addRecordedCursorSample(m_pendingCursor.timeUs, m_pendingCursor.pos);
+    }
+    return settingsApplied;
+}
+
+/** ****************************************************************************
+ * Function: checkResult()
+ *   Call when the replayed game is over.  Reads on to the recorded end if the
+ *   game ended before all samples were fed; a recording without an end (the
+ *   game didn't finish) has nothing to compare.  The score is compared as
+ *   stored, in thousandths.
+*******************************************************************************/
+void ReplayPlayer::checkResult(gameOverReason reason, float score)
+{
+    while (!m_finished)
+    {
+        if (!m_cursorReader.next(m_pendingCursor))
+        {
+            m_finished = true;
+            return;
+        }
+        if (m_pendingCursor.type == ReplayRecord::END)
+        {
+            m_recordedReason = m_pendingCursor.reason;
+            m_recordedScore = m_pendingCursor.score;
+            m_finished = true;
+        }
+    }
+    m_cursorPending = false;
+    if (m_recordedReason == NO_GAME_OVER)
+    {
+        return;
+    }
+    const uint64_t replayedScore = uint64_t(score * SCORE_SCALE + 0.5f);
+    const uint64_t recordedScore = uint64_t(m_recordedScore * SCORE_SCALE + 0.5f);
+    if ((reason != m_recordedReason) || (replayedScore != recordedScore))
+    {
+        ++m_mismatches;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: cursorSample()
+ *   Nothing to check: these are the samples feedCursor() queued.
+*******************************************************************************/
+void ReplayPlayer::cursorSample(int64_t, const SimPoint &)
+{
+    return;
+}
+
+/** ****************************************************************************
+ * Function: settingsChanged()
+ *   Nothing to check: feedCursor() applies recorded settings directly.
+*******************************************************************************/
+void ReplayPlayer::settingsChanged(int64_t, const GameSim &)
+{
+    return;
+}
+
+/** ****************************************************************************
+ * Function: statsSample()
+ *   Compare with the next recorded stat update.  Any difference means the
+ *   replay has diverged, e.g. the recording was made by a different build.
+*******************************************************************************/
+void ReplayPlayer::statsSample(int64_t timeUs, const SimPoint &dotPos)
+{
+    ReplayRecord expected;
+    do
+    {
+        if (!m_statsReader.next(expected) || (expected.type == ReplayRecord::END))
+        {
+            ++m_mismatches;     // more stat updates than were recorded
+            return;
+        }
+    } while (expected.type != ReplayRecord::STATS);
+    if ((expected.timeUs != timeUs) || (expected.pos.x != dotPos.x) || (expected.pos.y != dotPos.y))
+    {
+        ++m_mismatches;
+    }
+    return;
+}
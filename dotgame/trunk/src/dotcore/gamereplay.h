@@ -0,0 +1,265 @@
+/** ****************************************************************************
+ * @file gamereplay.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Game replays.  A game is fully determined by its seed, its settings and the
+ * cursor samples scored in it, so that is what is recorded, plus the dot
+ * position at every stat update to check the replay against.  Settings
+ * changed mid-game (sliders, time limit, window size) are recorded when they
+ * change.  Records are
+ * delta-encoded as zigzag varints: a typical record takes 2-3 bytes.
+ *
+ * File layout:
+ *   "DOTR", version byte, seed (8 bytes, little endian), then varints: arena
+ *   width and height, dot start x and y, cursor start x and y, dot diameter,
+ *   start speed, acceleration, time limit.
+ *   Records: varint (zigzag(time delta in ms) << 2 | type), then
+ *     cursor: zigzag dx and dy from the previous cursor sample, bits
+ *             interleaved into one varint
+ *     stats:  the same, from the previous dot position
+ *     settings: arena width and height, zigzag dot x and y (absolute), dot
+ *             diameter, speed, acceleration, time limit
+ *     end:    game over reason, score * 1000
+ *
+ ******************************************************************************/
+
+#ifndef GAMEREPLAY_H
+#define GAMEREPLAY_H
+
+#include "gamesim.h"
+#include <stddef.h>           // for size_t
+#include <vector>
+
+/** @struct ReplayConfig
+ *    Everything besides the cursor that a game depends on. */
+struct ReplayConfig {
+    uint64_t gameSeed;
+    unsigned int arenaWidth;
+    unsigned int arenaHeight;
+    SimPoint dotStart;
+    SimPoint cursorStart;
+    unsigned int dotDiam;
+    unsigned int dotSpeedMs;
+    unsigned int dotAcceleration;
+    unsigned int timeLimitS;
+};
+
+/** ****************************************************************************
+ * @class ReplayWriter
+ *   Records a game into memory while it is played.  Attach it to the GameSim
+ *   with setRecorder() after begin().
+*******************************************************************************/
+class ReplayWriter : public GameRecorder
+{
+public:
+    ReplayWriter();
+
+    /// Start a new recording; takes the settings from a freshly reset game
+    void begin(const GameSim &gameSim);
+    /// Close the recording with the result of the game
+    void finish(gameOverReason reason, float score);
+    /// The encoded replay so far
+    inline const std::vector<uint8_t> &data() const;
+
+    // GameRecorder
+    virtual void cursorSample(int64_t timeUs, const SimPoint &cursorPos);
+    virtual void statsSample(int64_t timeUs, const SimPoint &dotPos);
+    virtual void settingsChanged(int64_t timeUs, const GameSim &gameSim);
+
+private:
+    void appendRecord(int type, int64_t timeUs, const SimPoint &pos, SimPoint &lastPos);
+
+    std::vector<uint8_t> m_data;
+    int64_t m_lastTimeUs;
+    SimPoint m_lastCursorPos;
+    SimPoint m_lastDotPos;
+};
+
+/** @struct ReplayRecord
+ *    One decoded record of a replay. */
+struct ReplayRecord {
+    /// Kinds of record
+    enum recordType {
+        CURSOR = 0,     ///< pos is a cursor sample
+        STATS,          ///< pos is where the dot was at a stat update
+        END,            ///< reason and score of the finished game
+        SETTINGS        ///< settings changed before the step at timeUs
+    };
+    recordType type;
+    int64_t timeUs;
+    SimPoint pos;
+    gameOverReason reason;
+    float score;
+    /// The new settings of a SETTINGS record; dotStart is where the dot was
+    /// put, gameSeed and cursorStart are unused
+    ReplayConfig settings;
+};
+
+/** ****************************************************************************
+ * @class ReplayReader
+ *   Decodes a replay straight from its bytes, e.g. a memory-mapped file.  The
+ *   bytes must stay valid while the reader is used.
+*******************************************************************************/
+class ReplayReader
+{
+public:
+    ReplayReader(const uint8_t *data, size_t size);
+
+    /// Does the data start with a replay header this version can read?
+    inline bool isValid() const;
+    inline const ReplayConfig &config() const;
+    /// Decode the next record; false at the end of the data or on bad data
+    bool next(ReplayRecord &record);
+
+private:
+    /// Time since the previous record, in us, from a record header
+    int64_t recordTimeDelta(uint64_t header) const;
+
+    const uint8_t *m_readPtr;
+    const uint8_t *m_endPtr;
+    bool m_valid;
+    ReplayConfig m_config;
+    /// Version 2 and 3 files have record times in us and separate dx, dy
+    bool m_compactRecords;
+    int64_t m_lastTimeUs;
+    SimPoint m_lastCursorPos;
+    SimPoint m_lastDotPos;
+};
+
+/** ****************************************************************************
+ * @class ReplayPlayer
+ *   Plays a replay back into a GameSim, and checks the dot against the
+ *   recording at every stat update.  Attach it to the GameSim with
+ *   setRecorder() for the checks.
+*******************************************************************************/
+class ReplayPlayer : public GameRecorder
+{
+public:
+    /// The bytes must stay valid while the player is used
+    ReplayPlayer(const uint8_t *data, size_t size);
+
+    inline bool isValid() const;
+    inline const ReplayConfig &config() const;
+
+    /// Reset a GameSim to the recorded settings, ready to step
+    void configure(GameSim &gameSim) const;
+    /// Queue the recorded cursor samples up to game time upToUs, and apply
+    /// the settings changed before the next step; true if there were any
+    bool feedCursor(GameSim &gameSim, int64_t upToUs);
+    /// Compare the end of the replayed game with the recorded end
+    void checkResult(gameOverReason reason, float score);
+
+    /// All cursor samples have been fed
+    inline bool isFinished() const;
+    /// Stat updates where the dot was not where the recording had it, plus
+    /// one if the game ended differently (reason or score)
+    inline unsigned int getMismatches() const;
+    /// Result as recorded; NO_GAME_OVER if the recording has no end
+    inline gameOverReason getRecordedReason() const;
+    inline float getRecordedScore() const;
+
+    // GameRecorder
+    virtual void cursorSample(int64_t timeUs, const SimPoint &cursorPos);
+    virtual void statsSample(int64_t timeUs, const SimPoint &dotPos);
+    virtual void settingsChanged(int64_t timeUs, const GameSim &gameSim);
+
+private:
+    /// Put the arena, dot and settings of a game, but not its seed, into gameSim
+    static void applySettings(GameSim &gameSim, const ReplayConfig &settings);
+
+    /* The cursor samples are fed ahead of the stat updates they are checked
+       against, so each has its own reader over the same bytes. */
+    ReplayReader m_cursorReader;
+    ReplayReader m_statsReader;
+    /// Cursor sample or settings read but not yet due, valid if m_cursorPending
+    ReplayRecord m_pendingCursor;
+    bool m_cursorPending;
+    bool m_finished;
+    unsigned int m_mismatches;
+    gameOverReason m_recordedReason;
+    float m_recordedScore;
+};
+
+/// Version of the file layout written by ReplayWriter
+///   2: cursor samples are recorded as scored, after coalescing
+///   3: settings records; version 2 files are read as well
+///   4: record times in ms, which every game time now is; dx and dy in one varint
+static const uint8_t REPLAY_FORMAT_VERSION = 4;
+
+
+/** ****************************************************************************
+ * Function: data()
+ *
+*******************************************************************************/
+inline const std::vector<uint8_t> &ReplayWriter::data() const
+{
+    return m_data;
+}
+/** ****************************************************************************
+ * Function: isValid()
+ *
+*******************************************************************************/
+inline bool ReplayReader::isValid() const
+{
+    return m_valid;
+}
+inline bool ReplayPlayer::isValid() const
+{
+    return m_cursorReader.isValid();
+}
+/** ****************************************************************************
+ * Function: config()
+ *
+*******************************************************************************/
+inline const ReplayConfig &ReplayReader::config() const
+{
+    return m_config;
+}
+inline const ReplayConfig &ReplayPlayer::config() const
+{
+    return m_cursorReader.config();
+}
+/** ****************************************************************************
+ * Function: isFinished()
+ *
+*******************************************************************************/
+inline bool ReplayPlayer::isFinished() const
+{
+    return m_finished;
+}
+/** ****************************************************************************
+ * Function: getMismatches()
+ *   Non-zero means the replay diverged from the recorded game.
+*******************************************************************************/
+inline unsigned int ReplayPlayer::getMismatches() const
+{
+    return m_mismatches;
+}
+/** ****************************************************************************
+ * Function: getRecordedReason()
+ *
+*******************************************************************************/
+inline gameOverReason ReplayPlayer::getRecordedReason() const
+{
+    return m_recordedReason;
+}
+/** ****************************************************************************
+ * Function: getRecordedScore()
+ *
+*******************************************************************************/
+inline float ReplayPlayer::getRecordedScore() const
+{
+    return m_recordedScore;
+}
+
+#endif // GAMEREPLAY_H
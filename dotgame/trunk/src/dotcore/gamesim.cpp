@@ -0,0 +1,360 @@
+/** ****************************************************************************
+ * @file gamesim.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * GameSim is the headless game simulation: it owns the DotSim, keeps the
+ * running error-ratio average, integrates the score, speeds the dot up and
+ * enforces the time limit.  Time only advances through step(), so the game can
+ * run as fast as the CPU allows in tests and batch tools.  The cursor is fed in
+ * as timestamped samples, and the error is integrated over all of them.
+ *
+ ******************************************************************************/
+
+#include "gamesim.h"
+#include <math.h>             // for pow()
+
+const float GameSim::CURSOR_DISTANCE_GAMEOVER = 30;   //10;
+const float GameSim::RUNNING_AVERAGE_ERROR_DEFAULT = 3.0;
+
+/** ****************************************************************************
+ * GameSim Constructor
+ *  @param dotLocation Starting position of the dot within the arena.
+ *  @param boundWidth Width of the arena, in pixels.
+ *  @param boundHeight Height of the arena, in pixels.
+ *  @param gameSeed Seed for the dot's random motion.
+*******************************************************************************/
+GameSim::GameSim(SimPoint dotLocation, int boundWidth, int boundHeight, uint64_t gameSeed) :
+    m_dot(dotLocation, boundWidth, boundHeight, gameSeed), m_dotSpeed(DOT_SPEED_DEFAULT),
+    m_dotAcceleration(DOT_ACCEL_DEFAULT), m_gameLength(GAME_LENGTH_DEFAULT_S),
+    m_elapsedGameTimeMs(0), m_runningAvgErrorRatio(RUNNING_AVERAGE_ERROR_DEFAULT),
+    m_score(0.0), m_gameSeed(gameSeed), m_dotAccumMs(0), m_statsAccumMs(0), m_accelAccumMs(0),
+    m_cursorPos(dotLocation), m_errorIntegral(0.0), m_errorIntegralUs(0), m_profilerPtr(NULL),
+    m_recorderPtr(NULL)
+{
+}
+
+/** ****************************************************************************
+ * Function: step()
+ *   Advance the game by 'dtMs' milliseconds.  Each part of the game keeps its
+ *   own remainder, so the result does not depend on how the time is sliced.
+ *   Order within a step is always: dot motion, game stats, acceleration,
+ *   time limit.  Stops early if the game ends.  The cursor error is integrated
+ *   over the step against the dot's position after its moves.
+ *   @param dtMs Game time to advance, in milliseconds.
+*******************************************************************************/
+GameSim::StepResult GameSim::step(unsigned int dtMs)
+{
+    StepResult result = {0, 0, false, NO_GAME_OVER};
+    const int64_t USEC_IN_MSEC = 1000;
+    const int64_t stepStartUs = int64_t(m_elapsedGameTimeMs) * USEC_IN_MSEC;
+
+    if (m_profilerPtr != NULL)
+    {
+        m_profilerPtr->beginPhase(StepProfiler::MOTION);
+    }
+    m_dotAccumMs += dtMs;
+    while (m_dotAccumMs >= m_dotSpeed)
+    {
+        m_dotAccumMs -= m_dotSpeed;
+        m_dot.updateLoc();
+        ++result.dotMoves;
+    }
+    if (m_profilerPtr != NULL)
+    {
+        m_profilerPtr->endPhase(StepProfiler::MOTION);
+        m_profilerPtr->beginPhase(StepProfiler::STATS);
+    }
+    integrateCursorError(stepStartUs, stepStartUs + int64_t(dtMs) * USEC_IN_MSEC);
+
+    m_statsAccumMs += dtMs;
+    while ((m_statsAccumMs >= GAME_UPDATE_INTERVAL_MS) && (result.gameOver == NO_GAME_OVER))
+    {
+        m_statsAccumMs -= GAME_UPDATE_INTERVAL_MS;
+        ++result.statUpdates;
+        result.gameOver = calcGameStats();
+    }
+    if (m_profilerPtr != NULL)
+    {
+        m_profilerPtr->endPhase(StepProfiler::STATS);
+    }
+    if (result.gameOver != NO_GAME_OVER)
+    {
+        return result;
+    }
+
+    if (m_dotAcceleration > 0)
+    {
+        m_accelAccumMs += dtMs;
+        while (m_accelAccumMs >= DOT_ACCELERATION_UPDATE_INTERVAL_MS)
+        {
+            m_accelAccumMs -= DOT_ACCELERATION_UPDATE_INTERVAL_MS;
+            result.speedChanged |= increaseDotSpeed();
+        }
+    }
+
+    result.gameOver = advanceElapsedTime(dtMs);
+    return result;
+}
+
+/** ****************************************************************************
+ * Function: step()
+ *   Convenience for callers with one cursor position per step, like batch
+ *   tools: queue it at the current game time, then step.
+ *   @param dtMs Game time to advance, in milliseconds.
+ *   @param cursorPos Cursor position to score against, in arena coordinates.
+*******************************************************************************/
+GameSim::StepResult GameSim::step(unsigned int dtMs, const SimPoint &cursorPos)
+{
+    const int64_t USEC_IN_MSEC = 1000;
+    addCursorSample(int64_t(m_elapsedGameTimeMs) * USEC_IN_MSEC, cursorPos);
+    return step(dtMs);
+}
+
+/** ****************************************************************************
+ * Function: addCursorSample()
+ *   The time is rounded to the nearest millisecond, the simulation step: finer
+ *   only costs replay size.  Samples in the same millisecond coalesce.
+ *   @param timeUs Game time the cursor was at cursorPos, in microseconds.
+ *      Samples later than the game time are kept until the game gets there.
+ *   @param cursorPos Cursor position, in arena coordinates.
+*******************************************************************************/
+void GameSim::addCursorSample(int64_t timeUs, const SimPoint &cursorPos)
+{
+    const int64_t USEC_IN_MSEC = 1000;
+    m_cursorTrace.push(((timeUs + USEC_IN_MSEC/2) / USEC_IN_MSEC) * USEC_IN_MSEC, cursorPos);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: addRecordedCursorSample()
+ *   Which samples coalesce depends on which are still queued, and so on when
+ *   they were fed in; a recorded one was scored as it is.
+*******************************************************************************/
+void GameSim::addRecordedCursorSample(int64_t timeUs, const SimPoint &cursorPos)
+{
+    m_cursorTrace.push(timeUs, cursorPos, false);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: integrateCursorError()
+ *   The cursor is taken to stay where it was until its next sample, so each
+ *   sample counts for as long as it was the cursor position.  The recorder
+ *   gets each sample here, as scored: a late one at the start of the span.
+ *   A sample where the cursor already was changes nothing, so it is dropped
+ *   rather than splitting the span, and isn't recorded.
+*******************************************************************************/
+void GameSim::integrateCursorError(int64_t fromUs, int64_t toUs)
+{
+    int64_t spanStartUs = fromUs;
+    CursorSample sample;
+    while (m_cursorTrace.pop(sample, toUs))
+    {
+        if ((sample.pos.x == m_cursorPos.x) && (sample.pos.y == m_cursorPos.y))
+        {
+            continue;
+        }
+        if (sample.timeUs > spanStartUs)
+        {
+            m_errorIntegral += double(m_dot.calcPosErrorRatio(m_cursorPos)) * (sample.timeUs - spanStartUs);
+            m_errorIntegralUs += sample.timeUs - spanStartUs;
+            spanStartUs = sample.timeUs;
+        }
+        if (m_recorderPtr != NULL)
+        {
+            m_recorderPtr->cursorSample(spanStartUs, sample.pos);
+        }
+        m_cursorPos = sample.pos;
+    }
+    m_errorIntegral += double(m_dot.calcPosErrorRatio(m_cursorPos)) * (toUs - spanStartUs);
+    m_errorIntegralUs += toUs - spanStartUs;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: calcGameStats()
+ *     1) Average the error ratio between cursor and dot since the last call.
+ *     2) Calculate a running score
+ *     3) Is the game over due to distance?
+*******************************************************************************/
+gameOverReason GameSim::calcGameStats()
+{
+    if (m_recorderPtr != NULL)
+    {
+        const int64_t USEC_IN_MSEC = 1000;
+        m_recorderPtr->statsSample(int64_t(m_elapsedGameTimeMs) * USEC_IN_MSEC, m_dot.getPos());
+    }
+    float posErrorRatio = m_dot.calcPosErrorRatio(m_cursorPos);
+    if (m_errorIntegralUs > 0)
+    {
+        posErrorRatio = m_errorIntegral / m_errorIntegralUs;
+    }
+    m_errorIntegral = 0.0;
+    m_errorIntegralUs = 0;
+    m_runningAvgErrorRatio = (m_runningAvgErrorRatio * (ERROR_AVERAGING_RATIO - 1)
+                         + posErrorRatio) / ERROR_AVERAGING_RATIO;
+    float distScoreComp = 10 * (CURSOR_DISTANCE_GAMEOVER - m_runningAvgErrorRatio) /
+            CURSOR_DISTANCE_GAMEOVER;
+    float speedScoreComp = static_cast<float>(DOT_SPEED_MAX - m_dotSpeed) /
+            (DOT_SPEED_MAX - DOT_SPEED_MIN);
+    float compositeScoreInc = pow(distScoreComp,3) * speedScoreComp / 40;
+    m_score += compositeScoreInc;
+    if (m_runningAvgErrorRatio >= CURSOR_DISTANCE_GAMEOVER)
+    {
+        return DISTANCE;
+    }
+    return NO_GAME_OVER;
+}
+
+/** ****************************************************************************
+ * Function: increaseDotSpeed()
+ *   @return true if the speed changed, false if already at the fastest speed.
+*******************************************************************************/
+bool GameSim::increaseDotSpeed()
+{
+    const unsigned int oldSpeed = m_dotSpeed;
+    if (m_dotSpeed < DOT_SPEED_MIN + m_dotAcceleration)
+    {
+        m_dotSpeed = DOT_SPEED_MIN;
+    }
+    else
+    {
+        m_dotSpeed -= m_dotAcceleration;
+    }
+    return (m_dotSpeed != oldSpeed);
+}
+
+/** ****************************************************************************
+ * Function: advanceElapsedTime()
+ *   @param elapsedMs Game time that has passed, in milliseconds.
+ *   @return TIME_LIMIT once the game length has been reached.
+*******************************************************************************/
+gameOverReason GameSim::advanceElapsedTime(unsigned int elapsedMs)
+{
+    m_elapsedGameTimeMs += elapsedMs;
+    if ((m_gameLength != INFINITE_TIME) && (getElapsedTime() >= m_gameLength))
+    {
+        return TIME_LIMIT;
+    }
+    return NO_GAME_OVER;
+}
+
+/** ****************************************************************************
+ * Function: resetGameStats()
+ *   @param startSpeedMs Dot speed to start the new game with.
+ *   @param gameSeed Seed for the dot's random motion in the new game.
+ *   Just leave the dot in the same location for the next game.
+*******************************************************************************/
+void GameSim::resetGameStats(unsigned int startSpeedMs, uint64_t gameSeed)
+{
+    m_gameSeed = gameSeed;
+    m_dot.seed(gameSeed);
+    m_score = 0;
+    m_elapsedGameTimeMs = 0;
+    m_runningAvgErrorRatio = RUNNING_AVERAGE_ERROR_DEFAULT;
+    m_dotAccumMs = 0;
+    m_statsAccumMs = 0;
+    m_accelAccumMs = 0;
+    m_cursorTrace.clear();      // the cursor stays where it is, at m_cursorPos
+    m_errorIntegral = 0.0;
+    m_errorIntegralUs = 0;
+    setDotSpeed(startSpeedMs);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setDotSpeed()
+ *   @param newSpeedMs dot speed in milliseconds between position updates.
+ *   @return false if the value is out of range.
+*******************************************************************************/
+bool GameSim::setDotSpeed(unsigned int newSpeedMs)
+{
+    if ((newSpeedMs >= DOT_SPEED_MIN) && (newSpeedMs <= DOT_SPEED_MAX))
+    {
+        m_dotSpeed = newSpeedMs;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/** ****************************************************************************
+ * Function: setDotAcceleration()
+ *   @param newAcceleration Rate at which the dot moves faster.
+*******************************************************************************/
+void GameSim::setDotAcceleration(unsigned int newAcceleration)
+{
+    m_dotAcceleration = newAcceleration;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setStepProfiler()
+ *   @param profilerPtr Told when each phase of step() begins and ends, or
+ *      NULL (the default) for no profiling.  Not owned by the GameSim.
+*******************************************************************************/
+void GameSim::setStepProfiler(StepProfiler *profilerPtr)
+{
+    m_profilerPtr = profilerPtr;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setRecorder()
+ *   @param recorderPtr Told about every cursor sample and stat update, or
+ *      NULL (the default).  Not owned by the GameSim.
+*******************************************************************************/
+void GameSim::setRecorder(GameRecorder *recorderPtr)
+{
+    m_recorderPtr = recorderPtr;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setCursorPos()
+ *   A replay has to start with the cursor where the recorded game had it.
+*******************************************************************************/
+void GameSim::setCursorPos(const SimPoint &cursorPos)
+{
+    m_cursorPos = cursorPos;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: notifySettingsChanged()
+ *   The game only depends on its seed, its cursor and these settings, so a
+ *   replay has to know when they changed: call after changing the arena, the
+ *   dot's size or position, the speed, acceleration or time limit mid-game.
+ *   Changes the GameSim makes itself, like speeding up, need no call.
+*******************************************************************************/
+void GameSim::notifySettingsChanged()
+{
+    if (m_recorderPtr != NULL)
+    {
+        const int64_t USEC_IN_MSEC = 1000;
+        m_recorderPtr->settingsChanged(int64_t(m_elapsedGameTimeMs) * USEC_IN_MSEC, *this);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setTimeLimit()
+ *   @param timeLimitS Game length in seconds, or INFINITE_TIME.
+*******************************************************************************/
+void GameSim::setTimeLimit(unsigned int timeLimitS)
+{
+    m_gameLength = timeLimitS;
+    return;
+}
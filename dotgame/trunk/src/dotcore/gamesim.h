@@ -0,0 +1,302 @@
+/** ****************************************************************************
+ * @file gamesim.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * GameSim is the headless game simulation: it owns the DotSim, keeps the
+ * running error-ratio average, integrates the score, speeds the dot up and
+ * enforces the time limit.  Time only advances through step(), so the game can
+ * run as fast as the CPU allows in tests and batch tools.  The cursor is fed in
+ * as timestamped samples, and the error is integrated over all of them.
+ *
+ ******************************************************************************/
+
+#ifndef GAMESIM_H
+#define GAMESIM_H
+
+#include "dotsim.h"
+#include "cursortrace.h"
+#include <stddef.h>           // for NULL
+
+class GameSim;
+
+/// Possible reason for the Dot Game ending.
+enum gameOverReason {
+    NO_GAME_OVER = 0,
+    TIME_LIMIT,
+    DISTANCE
+};
+
+/** ****************************************************************************
+ * @class StepProfiler
+ *   Interface for timing the phases of GameSim::step() from outside the core,
+ *   which has no clock of its own.
+*******************************************************************************/
+class StepProfiler
+{
+public:
+    /// Phases of a step
+    enum stepPhase {
+        MOTION = 0,     ///< dot movement
+        STATS,          ///< cursor error, averaging and score
+        PHASE_COUNT
+    };
+    virtual ~StepProfiler() {}
+    virtual void beginPhase(stepPhase phase) = 0;
+    virtual void endPhase(stepPhase phase) = 0;
+};
+
+/** ****************************************************************************
+ * @class GameRecorder
+ *   Interface for watching the inputs and results of a game, e.g. to record a
+ *   replay: every cursor sample fed in, and the dot at every stat update.
+*******************************************************************************/
+class GameRecorder
+{
+public:
+    virtual ~GameRecorder() {}
+    /// A cursor sample was scored: after coalescing, at the game time it took effect
+    virtual void cursorSample(int64_t timeUs, const SimPoint &cursorPos) = 0;
+    /// The cursor was scored against the dot at dotPos
+    virtual void statsSample(int64_t timeUs, const SimPoint &dotPos) = 0;
+    /// The arena, dot or settings were changed from outside, before the step at timeUs
+    virtual void settingsChanged(int64_t timeUs, const GameSim &gameSim) = 0;
+};
+
+/** ****************************************************************************
+ * @class GameSim
+ *   The game rules without any window: dot motion, error-ratio averaging,
+ *   score integration, acceleration and the game time limit.
+*******************************************************************************/
+class GameSim
+{
+public:
+    explicit GameSim(SimPoint dotLocation = SimPoint(), int boundWidth = 0, int boundHeight = 0,
+                     uint64_t gameSeed = DotRandom::DEFAULT_SEED);
+
+    /** @struct StepResult
+     *    What happened during one call to step(). */
+    struct StepResult {
+        /// Number of times the dot moved
+        unsigned int dotMoves;
+        /// Number of cursor samples scored
+        unsigned int statUpdates;
+        /// The dot speed was increased by the acceleration
+        bool speedChanged;
+        /// Reason the game ended during this step, or NO_GAME_OVER
+        gameOverReason gameOver;
+    };
+
+    /// Advance the game by dtMs milliseconds, scoring the queued cursor samples
+    StepResult step(unsigned int dtMs);
+    /// Advance the game by dtMs milliseconds with the cursor at cursorPos
+    StepResult step(unsigned int dtMs, const SimPoint &cursorPos);
+    /// Queue where the cursor was at game time timeUs (microseconds)
+    void addCursorSample(int64_t timeUs, const SimPoint &cursorPos);
+    /// Queue a sample as a GameRecorder got it, without coalescing it again
+    void addRecordedCursorSample(int64_t timeUs, const SimPoint &cursorPos);
+
+    /// Score the cursor since the last call: update the error-ratio average and the score
+    gameOverReason calcGameStats();
+    /// Make the dot faster by the current acceleration
+    bool increaseDotSpeed();
+    /// Count game time, and check it against the time limit
+    gameOverReason advanceElapsedTime(unsigned int elapsedMs);
+    /// Reset score, time, averages and the dot's random motion for a new game
+    void resetGameStats(unsigned int startSpeedMs, uint64_t gameSeed);
+
+    bool setDotSpeed(unsigned int newSpeedMs);
+    void setDotAcceleration(unsigned int newAcceleration);
+    void setTimeLimit(unsigned int timeLimitS);
+    /// Time the phases of every step, or NULL to stop
+    void setStepProfiler(StepProfiler *profilerPtr);
+    /// Report cursor samples and stat updates, or NULL to stop
+    void setRecorder(GameRecorder *recorderPtr);
+    /// Where the cursor is taken to be until its first sample arrives
+    void setCursorPos(const SimPoint &cursorPos);
+    /// Tell the recorder about changes made between steps, through dot() or a setter
+    void notifySettingsChanged();
+
+    inline DotSim &dot();
+    inline const DotSim &dot() const;
+    inline unsigned int getDotSpeed() const;
+    inline unsigned int getDotAcceleration() const;
+    inline unsigned int getTimeLimit() const;
+    inline float getErrorRatio() const;
+    inline float getScore() const;
+    inline unsigned int getElapsedTime() const;
+    inline unsigned int getElapsedTimeMs() const;
+    inline uint64_t getGameSeed() const;
+    inline const CursorTrace &cursorTrace() const;
+    inline SimPoint getCursorPos() const;
+
+    /// Minimum programmable dot speed
+    static const unsigned int DOT_SPEED_MIN         =  2;
+    /// Default speed of the dot, in milliseconds
+    static const unsigned int DOT_SPEED_DEFAULT     = 40;
+    /// Maximum programmable dot speed
+    static const unsigned int DOT_SPEED_MAX         = 50;
+    /// Minimum Dot Acceleration
+    static const unsigned int DOT_ACCEL_MIN         =  0;
+    /// Number of milliseconds to speed up the dot movement by.
+    static const unsigned int DOT_ACCEL_DEFAULT     =  1;
+    /// Maximum Dot Acceleration
+    static const unsigned int DOT_ACCEL_MAX         =  5;
+    /// length of time (in ms) between m_dotSpeed increases
+    static const unsigned int DOT_ACCELERATION_UPDATE_INTERVAL_MS = 2000;
+    /// Game length for no time limit; all values >0 are actual times in seconds
+    static const unsigned int INFINITE_TIME         =  0;
+    /// Amount of time (seconds) for a timed game to last
+    static const unsigned int GAME_LENGTH_DEFAULT_S = 10;
+    /// length of time (in ms) between game stat updates
+    static const unsigned int GAME_UPDATE_INTERVAL_MS = 80;
+    /// Number of samples to average in the Position Error Ratio
+    static const unsigned int ERROR_AVERAGING_RATIO = 16;
+    /// Maximum allowed distance between mouse cursor and the dot
+    static const float CURSOR_DISTANCE_GAMEOVER;
+    /// initial errorDistance value.  Non-zero to quickly stabilize the averaging.
+    static const float RUNNING_AVERAGE_ERROR_DEFAULT;
+
+private:
+    /// Add the error between the cursor samples and the dot over a time span
+    void integrateCursorError(int64_t fromUs, int64_t toUs);
+
+    /// The simulated dot
+    DotSim m_dot;
+    /// how many milliseconds between dot movements
+    unsigned int m_dotSpeed;
+    /// how fast the m_dotSpeed is increased
+    unsigned int m_dotAcceleration;
+    /// Requested Game Length, in seconds.  INFINITE_TIME for no limit.
+    unsigned int m_gameLength;
+    /// Total game time, excluding paused time.
+    unsigned int m_elapsedGameTimeMs;
+    /// Running average of error ratio/distance
+    float m_runningAvgErrorRatio;
+    /// Cumulative game score
+    float m_score;
+    /// Seed of the current game; the dot uses stream 0
+    uint64_t m_gameSeed;
+    /// Time carried over to the next dot move, stat update and speed-up
+    unsigned int m_dotAccumMs;
+    unsigned int m_statsAccumMs;
+    unsigned int m_accelAccumMs;
+    /// Cursor samples not yet scored
+    CursorTrace m_cursorTrace;
+    /// Cursor position as of the last scored sample
+    SimPoint m_cursorPos;
+    /// Error ratio integrated over time since the last stat update, and that time
+    double m_errorIntegral;
+    int64_t m_errorIntegralUs;
+    /// Optional phase timing, NULL when not profiling
+    StepProfiler *m_profilerPtr;
+    /// Optional game recording, NULL when not recording
+    GameRecorder *m_recorderPtr;
+};
+
+
+/** ****************************************************************************
+ * Function: dot()
+ *
+*******************************************************************************/
+inline DotSim &GameSim::dot()
+{
+    return m_dot;
+}
+inline const DotSim &GameSim::dot() const
+{
+    return m_dot;
+}
+/** ****************************************************************************
+ * Function: getDotSpeed()
+ *   Milliseconds between dot movements.  Lower number is faster.
+*******************************************************************************/
+inline unsigned int GameSim::getDotSpeed() const
+{
+    return m_dotSpeed;
+}
+/** ****************************************************************************
+ * Function: getDotAcceleration()
+ *
+*******************************************************************************/
+inline unsigned int GameSim::getDotAcceleration() const
+{
+    return m_dotAcceleration;
+}
+/** ****************************************************************************
+ * Function: getTimeLimit()
+ *   Game length in seconds, or INFINITE_TIME.
+*******************************************************************************/
+inline unsigned int GameSim::getTimeLimit() const
+{
+    return m_gameLength;
+}
+/** ****************************************************************************
+ * Function: getErrorRatio()
+ *
+*******************************************************************************/
+inline float GameSim::getErrorRatio() const
+{
+    return m_runningAvgErrorRatio;
+}
+/** ****************************************************************************
+ * Function: getScore()
+ *
+*******************************************************************************/
+inline float GameSim::getScore() const
+{
+    return m_score;
+}
+/** ****************************************************************************
+ * Function: getElapsedTime()
+ *   Game time in whole seconds.
+*******************************************************************************/
+inline unsigned int GameSim::getElapsedTime() const
+{
+    return m_elapsedGameTimeMs / 1000;
+}
+/** ****************************************************************************
+ * Function: getElapsedTimeMs()
+ *
+*******************************************************************************/
+inline unsigned int GameSim::getElapsedTimeMs() const
+{
+    return m_elapsedGameTimeMs;
+}
+
+/** ****************************************************************************
+ * Function: getGameSeed()
+ *   Seed of the current game.  The same seed, start position and cursor
+ *   input replay the game exactly.
+*******************************************************************************/
+inline uint64_t GameSim::getGameSeed() const
+{
+    return m_gameSeed;
+}
+/** ****************************************************************************
+ * Function: cursorTrace()
+ *   The queued cursor samples and their coalesce/drop counts.
+*******************************************************************************/
+inline const CursorTrace &GameSim::cursorTrace() const
+{
+    return m_cursorTrace;
+}
+/** ****************************************************************************
+ * Function: getCursorPos()
+ *   Cursor position as of the last scored sample.
+*******************************************************************************/
+inline SimPoint GameSim::getCursorPos() const
+{
+    return m_cursorPos;
+}
+
+#endif // GAMESIM_H
@@ -0,0 +1,138 @@
+/** ****************************************************************************
+ * @file latencyhistogram.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * LatencyHistogram counts durations in log-linear buckets (32 per power of
+ * two, so within ~3%) from 1 us to over half an hour, in a fixed-size table.
+ * Recording is a few shifts and an increment, cheap enough to leave on while
+ * playing; percentiles are read from the counts.
+ *
+ ******************************************************************************/
+
+#include "latencyhistogram.h"
+#include <string.h>           // for memset()
+
+/** ****************************************************************************
+ * LatencyHistogram Constructor
+*******************************************************************************/
+LatencyHistogram::LatencyHistogram() :
+    m_count(0), m_max(0)
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+}
+
+/** ****************************************************************************
+ * Function: record()
+ *   @param durationUs Duration to count, in microseconds.
+*******************************************************************************/
+void LatencyHistogram::record(int64_t durationUs)
+{
+    if (durationUs < 0)
+    {
+        durationUs = 0;
+    }
+    if (durationUs > m_max)
+    {
+        m_max = durationUs;
+    }
+    ++m_buckets[bucketIndex(durationUs)];
+    ++m_count;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: clear()
+ *
+*******************************************************************************/
+void LatencyHistogram::clear()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_max = 0;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: percentile()
+ *   @param percent 0.0 to 100.0, e.g. 99.0 for the p99.
+ *   @return The highest duration of the bucket the percentile falls in (never
+ *      more than the longest recorded), or 0 if nothing has been recorded.
+*******************************************************************************/
+int64_t LatencyHistogram::percentile(double percent) const
+{
+    if (m_count == 0)
+    {
+        return 0;
+    }
+    // rank of the sample at 'percent', counting from 1
+    uint32_t rank = static_cast<uint32_t>((percent / 100.0) * m_count + 0.5);
+    if (rank < 1)
+    {
+        rank = 1;
+    }
+    else if (rank > m_count)
+    {
+        rank = m_count;
+    }
+    uint32_t seen = 0;
+    for (int index = 0; index < BUCKET_COUNT; ++index)
+    {
+        seen += m_buckets[index];
+        if (seen >= rank)
+        {
+            const int64_t highest = bucketHighest(index);
+            return (highest < m_max) ? highest : m_max;
+        }
+    }
+    return m_max;
+}
+
+/** ****************************************************************************
+ * Function: bucketIndex()
+ *   Values below 2*SUB_BUCKETS have a bucket each.  Above that, each power of
+ *   two is split into SUB_BUCKETS: the bucket is picked by the top
+ *   SUB_BUCKET_BITS+1 bits of the value.
+*******************************************************************************/
+int LatencyHistogram::bucketIndex(int64_t durationUs)
+{
+    if (durationUs > MAX_DURATION_US)
+    {
+        durationUs = MAX_DURATION_US;
+    }
+    uint32_t value = static_cast<uint32_t>(durationUs);
+    if (value < 2 * SUB_BUCKETS)
+    {
+        return value;
+    }
+    int shift = 0;
+    while ((value >> shift) >= 2 * SUB_BUCKETS)
+    {
+        ++shift;
+    }
+    return shift * SUB_BUCKETS + (value >> shift);
+}
+
+/** ****************************************************************************
+ * Function: bucketHighest()
+ *   The largest value that falls into a bucket; the inverse of bucketIndex().
+*******************************************************************************/
+int64_t LatencyHistogram::bucketHighest(int index)
+{
+    if (index < 2 * SUB_BUCKETS)
+    {
+        return index;
+    }
+    const int shift = (index / SUB_BUCKETS) - 1;
+    const int64_t lowest = int64_t(index - shift * SUB_BUCKETS) << shift;
+    return lowest + (int64_t(1) << shift) - 1;
+}
@@ -0,0 +1,81 @@
+/** ****************************************************************************
+ * @file latencyhistogram.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * LatencyHistogram counts durations in log-linear buckets (32 per power of
+ * two, so within ~3%) from 1 us to over half an hour, in a fixed-size table.
+ * Recording is a few shifts and an increment, cheap enough to leave on while
+ * playing; percentiles are read from the counts.
+ *
+ ******************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <stdint.h>           // for uint32_t, int64_t
+
+/** ****************************************************************************
+ * @class LatencyHistogram
+ *   Histogram of durations in microseconds, with percentiles.
+*******************************************************************************/
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    /// Count one duration, in microseconds.  Negative counts as zero.
+    void record(int64_t durationUs);
+    /// Forget all durations
+    void clear();
+    /// Duration that 'percent' of the recorded ones are at or below, in us
+    int64_t percentile(double percent) const;
+
+    inline uint32_t count() const;
+    inline int64_t getMax() const;
+
+    /// Buckets per power of two; sets the precision
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    /// Longest duration kept exactly; longer ones go into the last bucket
+    static const int64_t MAX_DURATION_US = (int64_t(1) << 31) - 1;
+    /// Buckets needed to cover 0..MAX_DURATION_US
+    static const int BUCKET_COUNT = (31 - SUB_BUCKET_BITS) * SUB_BUCKETS + SUB_BUCKETS;
+
+private:
+    static int bucketIndex(int64_t durationUs);
+    static int64_t bucketHighest(int index);
+
+    uint32_t m_buckets[BUCKET_COUNT];
+    uint32_t m_count;
+    int64_t m_max;
+};
+
+
+/** ****************************************************************************
+ * Function: count()
+ *   How many durations were recorded?
+*******************************************************************************/
+inline uint32_t LatencyHistogram::count() const
+{
+    return m_count;
+}
+/** ****************************************************************************
+ * Function: getMax()
+ *   Longest duration recorded, exactly, in microseconds.
+*******************************************************************************/
+inline int64_t LatencyHistogram::getMax() const
+{
+    return m_max;
+}
+
+#endif // LATENCYHISTOGRAM_H
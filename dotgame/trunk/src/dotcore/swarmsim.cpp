@@ -0,0 +1,229 @@
+/** ****************************************************************************
+ * @file swarmsim.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * SwarmSim moves many dots at once for the 'swarm' mode.  Instead of one
+ * object per dot it keeps every attribute in its own contiguous float array
+ * (structure of arrays), so one tick is a single vectorized pass over all dots
+ * doing the same job as DotSim::updateLoc(): weighted blend, normalize, bounce.
+ *
+ ******************************************************************************/
+
+#include "swarmsim.h"
+#include <math.h>             // for sqrt()
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define SWARMSIM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+/** ****************************************************************************
+ * SwarmSim Constructor
+ *  @param boundWidth Width of the arena, in pixels.
+ *  @param boundHeight Height of the arena, in pixels.
+ *  @param gameSeed Seed for the random motion of all dots.
+*******************************************************************************/
+SwarmSim::SwarmSim(int boundWidth, int boundHeight, uint64_t gameSeed) :
+    m_boundWidth(boundWidth), m_boundHeight(boundHeight),
+    m_motionWeight(DotSim::MOTION_WEIGHT_DEFAULT), m_gameSeed(gameSeed)
+{
+}
+
+/** ****************************************************************************
+ * Function: addDot()
+ *   @param location Starting position, boundary checked.
+ *   @param dotDiam Diameter of the dot, which sets its move distance the same
+ *      way as DotSim::setDotSize().  Out of range uses the default diameter.
+ *   @return Index of the new dot.
+*******************************************************************************/
+unsigned int SwarmSim::addDot(SimPoint location, unsigned int dotDiam)
+{
+    if ((dotDiam < DotSim::DOT_DIAM_MIN) || (dotDiam > DotSim::DOT_DIAM_MAX))
+    {
+        dotDiam = DotSim::DOT_DIAM_DEFAULT;
+    }
+    m_posX.push_back(location.x < 0 ? 0 : (location.x > m_boundWidth ? m_boundWidth : location.x));
+    m_posY.push_back(location.y < 0 ? 0 : (location.y > m_boundHeight ? m_boundHeight : location.y));
+    m_vectX.push_back(0);
+    m_vectY.push_back(0);
+    m_moveDist.push_back(DotSim::moveDistForSize(dotDiam));
+    m_randX.push_back(0);
+    m_randSign.push_back(1);
+    m_random.push_back(DotRandom(m_gameSeed, m_posX.size() - 1));
+    return m_posX.size() - 1;
+}
+
+/** ****************************************************************************
+ * Function: clear()
+ *
+*******************************************************************************/
+void SwarmSim::clear()
+{
+    m_posX.clear();
+    m_posY.clear();
+    m_vectX.clear();
+    m_vectY.clear();
+    m_moveDist.clear();
+    m_randX.clear();
+    m_randSign.clear();
+    m_random.clear();
+    return;
+}
+
+/** ****************************************************************************
+ * Function: reserve()
+ *
+*******************************************************************************/
+void SwarmSim::reserve(unsigned int count)
+{
+    m_posX.reserve(count);
+    m_posY.reserve(count);
+    m_vectX.reserve(count);
+    m_vectY.reserve(count);
+    m_moveDist.reserve(count);
+    m_randX.reserve(count);
+    m_randSign.reserve(count);
+    m_random.reserve(count);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setBounds()
+ *   Cache the arena size.  Dots outside a shrunk arena bounce back in on
+ *   their next update.
+*******************************************************************************/
+void SwarmSim::setBounds(int width, int height)
+{
+    m_boundWidth = width;
+    m_boundHeight = height;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: generateRandomMoves()
+ *   The random X offset (-moveDist <= x <= moveDist) and Y orientation of each
+ *   dot.  This is the only scalar part of a tick; the Y component on the circle
+ *   is calculated in the vectorized pass.
+*******************************************************************************/
+void SwarmSim::generateRandomMoves()
+{
+    const unsigned int count = m_posX.size();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const int moveDist = static_cast<int>(m_moveDist[i]);
+        const uint32_t tempRand = m_random[i].next();
+        m_randX[i] = static_cast<float>(static_cast<int>(DotRandom::bounded(tempRand, 2*moveDist + 1)) -
+                                        moveDist);
+        m_randSign[i] = (tempRand & 1) ? 1.0f : -1.0f;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: updateLoc()
+ *   Move every dot one step.  Per dot this is DotSim::updateLoc():
+ *     1) random point on a circle of radius moveDist,
+ *     2) weighted average with the previous motion vector,
+ *     3) normalize to moveDist and move,
+ *     4) clamp to the arena and invert the vector component that hit the edge.
+ *   Four dots are handled per SSE2 instruction where available.
+*******************************************************************************/
+void SwarmSim::updateLoc()
+{
+    generateRandomMoves();
+
+    const unsigned int count = m_posX.size();
+    const float weight = m_motionWeight;
+    const float randWeight = 1.0f - m_motionWeight;
+    const float maxX = static_cast<float>(m_boundWidth);
+    const float maxY = static_cast<float>(m_boundHeight);
+    float *posX = count ? &m_posX[0] : NULL;
+    float *posY = count ? &m_posY[0] : NULL;
+    float *vectX = count ? &m_vectX[0] : NULL;
+    float *vectY = count ? &m_vectY[0] : NULL;
+    const float *moveDist = count ? &m_moveDist[0] : NULL;
+    const float *randX = count ? &m_randX[0] : NULL;
+    const float *randSign = count ? &m_randSign[0] : NULL;
+    unsigned int i = 0;
+
+#ifdef SWARMSIM_USE_SSE2
+    const __m128 weight4 = _mm_set1_ps(weight);
+    const __m128 randWeight4 = _mm_set1_ps(randWeight);
+    const __m128 zero4 = _mm_setzero_ps();
+    const __m128 tiny4 = _mm_set1_ps(1e-12f);
+    const __m128 maxX4 = _mm_set1_ps(maxX);
+    const __m128 maxY4 = _mm_set1_ps(maxY);
+    const __m128 signBit4 = _mm_set1_ps(-0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 dist = _mm_loadu_ps(moveDist + i);
+        const __m128 rx = _mm_loadu_ps(randX + i);
+        const __m128 ry = _mm_mul_ps(_mm_loadu_ps(randSign + i),
+                                     _mm_sqrt_ps(_mm_max_ps(zero4, _mm_sub_ps(_mm_mul_ps(dist, dist),
+                                                                              _mm_mul_ps(rx, rx)))));
+        __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vectX + i), weight4), _mm_mul_ps(rx, randWeight4));
+        __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(vectY + i), weight4), _mm_mul_ps(ry, randWeight4));
+        const __m128 lenSquared = _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy));
+        const __m128 nonZero = _mm_cmpgt_ps(lenSquared, tiny4);
+        // zero-length vectors stay zero; the mask also hides the 0/0 lanes.
+        const __m128 scale = _mm_and_ps(nonZero, _mm_div_ps(dist, _mm_sqrt_ps(_mm_max_ps(lenSquared, tiny4))));
+        vx = _mm_mul_ps(vx, scale);
+        vy = _mm_mul_ps(vy, scale);
+        __m128 px = _mm_add_ps(_mm_loadu_ps(posX + i), vx);
+        __m128 py = _mm_add_ps(_mm_loadu_ps(posY + i), vy);
+        // lanes that left the arena get their vector component inverted (sign bit flipped)
+        const __m128 outX = _mm_or_ps(_mm_cmplt_ps(px, zero4), _mm_cmpgt_ps(px, maxX4));
+        const __m128 outY = _mm_or_ps(_mm_cmplt_ps(py, zero4), _mm_cmpgt_ps(py, maxY4));
+        vx = _mm_xor_ps(vx, _mm_and_ps(outX, signBit4));
+        vy = _mm_xor_ps(vy, _mm_and_ps(outY, signBit4));
+        px = _mm_min_ps(_mm_max_ps(px, zero4), maxX4);
+        py = _mm_min_ps(_mm_max_ps(py, zero4), maxY4);
+        _mm_storeu_ps(vectX + i, vx);
+        _mm_storeu_ps(vectY + i, vy);
+        _mm_storeu_ps(posX + i, px);
+        _mm_storeu_ps(posY + i, py);
+    }
+#endif
+
+    // Remaining dots (or all of them without SSE2); simple enough to auto-vectorize.
+    for (; i < count; ++i)
+    {
+        const float dist = moveDist[i];
+        const float rx = randX[i];
+        const float rSquared = dist*dist - rx*rx;
+        const float ry = randSign[i] * sqrtf(rSquared > 0 ? rSquared : 0);
+        float vx = (vectX[i] * weight) + (rx * randWeight);
+        float vy = (vectY[i] * weight) + (ry * randWeight);
+        const float lenSquared = vx*vx + vy*vy;
+        const float scale = (lenSquared > 1e-12f) ? (dist / sqrtf(lenSquared)) : 0.0f;
+        vx *= scale;
+        vy *= scale;
+        float px = posX[i] + vx;
+        float py = posY[i] + vy;
+        if ((px < 0) || (px > maxX))
+        {
+            vx = -vx;
+            px = (px < 0) ? 0 : maxX;
+        }
+        if ((py < 0) || (py > maxY))
+        {
+            vy = -vy;
+            py = (py < 0) ? 0 : maxY;
+        }
+        vectX[i] = vx;
+        vectY[i] = vy;
+        posX[i] = px;
+        posY[i] = py;
+    }
+    return;
+} // function updateLoc()
@@ -0,0 +1,127 @@
+/** ****************************************************************************
+ * @file swarmsim.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * SwarmSim moves many dots at once for the 'swarm' mode.  Instead of one
+ * object per dot it keeps every attribute in its own contiguous float array
+ * (structure of arrays), so one tick is a single vectorized pass over all dots
+ * doing the same job as DotSim::updateLoc(): weighted blend, normalize, bounce.
+ *
+ ******************************************************************************/
+
+#ifndef SWARMSIM_H
+#define SWARMSIM_H
+
+#include "dotsim.h"
+#include <stddef.h>           // for NULL
+#include <vector>
+
+/** ****************************************************************************
+ * @class SwarmSim
+ *   Structure-of-arrays random walk for thousands of dots.  Positions are kept
+ *   as floats; callers round them when drawing.
+*******************************************************************************/
+class SwarmSim
+{
+public:
+    explicit SwarmSim(int boundWidth = 0, int boundHeight = 0,
+                      uint64_t gameSeed = DotRandom::DEFAULT_SEED);
+
+    /// Add a dot, returns its index.  The index is also its random stream.
+    unsigned int addDot(SimPoint location, unsigned int dotDiam = DotSim::DOT_DIAM_DEFAULT);
+    /// Remove all dots
+    void clear();
+    /// Reserve storage for 'count' dots, so adding them doesn't reallocate
+    void reserve(unsigned int count);
+    /// Set the arena size; all dots are kept within (0,0)..(width,height)
+    void setBounds(int width, int height);
+    /// Move every dot one step, in one pass
+    void updateLoc();
+
+    inline unsigned int size() const;
+    inline float getX(unsigned int index) const;
+    inline float getY(unsigned int index) const;
+    /// Direct read access to the position arrays, for drawing
+    inline const float *posX() const;
+    inline const float *posY() const;
+
+private:
+    /// Fill m_randX/m_randSign with the random part of this tick's move
+    void generateRandomMoves();
+
+    int m_boundWidth;
+    int m_boundHeight;
+    /// Weight of the current vector component, see DotSim::MOTION_WEIGHT_DEFAULT
+    float m_motionWeight;
+    /// Seed shared by all dots; each dot draws from its own stream of it
+    uint64_t m_gameSeed;
+
+    // One entry per dot in each array:
+    /// Current location of the dots
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    /// Current direction of motion
+    std::vector<float> m_vectX;
+    std::vector<float> m_vectY;
+    /// Distance that each dot moves when updated
+    std::vector<float> m_moveDist;
+    /// Scratch: random X offset and Y orientation (-1 or 1) for this tick
+    std::vector<float> m_randX;
+    std::vector<float> m_randSign;
+    /// Random generator of each dot
+    std::vector<DotRandom> m_random;
+};
+
+
+/** ****************************************************************************
+ * Function: size()
+ *   How many dots are in the swarm?
+*******************************************************************************/
+inline unsigned int SwarmSim::size() const
+{
+    return m_posX.size();
+}
+/** ****************************************************************************
+ * Function: getX()
+ *
+*******************************************************************************/
+inline float SwarmSim::getX(unsigned int index) const
+{
+    return m_posX[index];
+}
+/** ****************************************************************************
+ * Function: getY()
+ *
+*******************************************************************************/
+inline float SwarmSim::getY(unsigned int index) const
+{
+    return m_posY[index];
+}
+/** ****************************************************************************
+ * Function: posX()
+ *
+*******************************************************************************/
+inline const float *SwarmSim::posX() const
+{
+    return m_posX.empty() ? NULL : &m_posX[0];
+}
+/** ****************************************************************************
+ * Function: posY()
+ *
+*******************************************************************************/
+inline const float *SwarmSim::posY() const
+{
+    return m_posY.empty() ? NULL : &m_posY[0];
+}
+
+#endif // SWARMSIM_H
@@ -0,0 +1,150 @@
+/** ****************************************************************************
+ * @file dotdeclarative.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The DotDeclarative: the QML dot, moved from C++.  See dotdeclarative.h.
+ *
+ ******************************************************************************/
+
+#include "dotdeclarative.h"
+#include <QtGui/QPainter>
+#include <QtCore/qmath.h>     // for qCeil()
+
+/** ****************************************************************************
+ * DotDeclarative Constructor
+ *   @param parent Parent QML item
+ ******************************************************************************/
+DotDeclarative::DotDeclarative(QDeclarativeItem *parent) :
+    QDeclarativeItem(parent),
+    m_color(Qt::white), m_borderColor(Qt::black), m_fixedSprite(false)
+{
+    setFlag(QGraphicsItem::ItemHasNoContents, false);
+}
+
+/** ****************************************************************************
+ * Function: paint()
+ *   One blit; the dot is only drawn again when it changes.
+*******************************************************************************/
+void DotDeclarative::paint(QPainter *painter,
+           const QStyleOptionGraphicsItem *option,
+           QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    if (m_sprite.isNull())
+    {
+        renderSprite();
+    }
+    painter->drawPixmap(0, 0, m_sprite);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setColor()
+ *
+*******************************************************************************/
+void DotDeclarative::setColor(const QColor &newColor)
+{
+    if (newColor != m_color)
+    {
+        m_color = newColor;
+        if (!m_fixedSprite)
+        {
+            m_sprite = QPixmap();
+            update();
+        }
+        emit colorChanged();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setBorderColor()
+ *
+*******************************************************************************/
+void DotDeclarative::setBorderColor(const QColor &newColor)
+{
+    if (newColor != m_borderColor)
+    {
+        m_borderColor = newColor;
+        if (!m_fixedSprite)
+        {
+            m_sprite = QPixmap();
+            update();
+        }
+        emit borderColorChanged();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setCenter()
+ *   Called once per frame the dot moved.  Only the item's position changes,
+ *   so the scene just moves the cached pixmap.
+*******************************************************************************/
+void DotDeclarative::setCenter(const QPoint &center)
+{
+    setPos(center.x() - int(width())/2, center.y() - int(height())/2);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setSprite()
+ *   The item is resized to the sprite and stays centered where it was.  With
+ *   an odd-sized sprite, like the Dot's, the center lands on its middle pixel.
+ *   @param sprite The dot to draw, e.g. DotWidget::getDotSprite().
+*******************************************************************************/
+void DotDeclarative::setSprite(const QPixmap &sprite)
+{
+    const QPoint center(int(x()) + int(width())/2, int(y()) + int(height())/2);
+    m_fixedSprite = true;
+    m_sprite = sprite;
+    setWidth(sprite.width());
+    setHeight(sprite.height());
+    setCenter(center);
+    update();
+    return;
+}
+
+/** ****************************************************************************
+ * Function: geometryChanged()
+ *   A new size needs a new sprite, unless it was given by setSprite(); a new
+ *   position doesn't.
+*******************************************************************************/
+void DotDeclarative::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QDeclarativeItem::geometryChanged(newGeometry, oldGeometry);
+    if ((newGeometry.size() != oldGeometry.size()) && !m_fixedSprite)
+    {
+        m_sprite = QPixmap();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: renderSprite()
+ *   The same circle the QML Rectangle drew: filled, with a one pixel border,
+ *   antialiased.
+*******************************************************************************/
+void DotDeclarative::renderSprite()
+{
+    const QSize spriteSize(qMax(1, qCeil(width())), qMax(1, qCeil(height())));
+    m_sprite = QPixmap(spriteSize);
+    m_sprite.fill(Qt::transparent);
+    QPainter spritePainter(&m_sprite);
+    spritePainter.setRenderHint(QPainter::Antialiasing);
+    spritePainter.setBrush(m_color);
+    spritePainter.setPen(QPen(m_borderColor, 1));
+    spritePainter.drawEllipse(QRectF(0.5, 0.5, width() - 1, height() - 1));
+    return;
+}
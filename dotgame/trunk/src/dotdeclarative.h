@@ -0,0 +1,100 @@
+/** ****************************************************************************
+ * @file dotdeclarative.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The DotDeclarative is the dot of the QML layer, as a C++ item ("GameDot"
+ * in "QtItems 1.0").  It is moved from C++ by setCenter(), so a dot move runs
+ * no JavaScript and no bindings, and it paints a pixmap rendered only when
+ * its size or colors change.  setSprite() gives it the game's own dot instead,
+ * at the game's size and skin.
+ *
+ ******************************************************************************/
+
+#ifndef DOTDECLARATIVE_H
+#define DOTDECLARATIVE_H
+
+#include <QDeclarativeItem>
+#include <QtCore/QPoint>
+#include <QtGui/QColor>
+#include <QtGui/QPixmap>
+
+/** ****************************************************************************
+ * @class DotDeclarative
+ *   A round dot for QML, drawn from a cached pixmap and placed by its center.
+*******************************************************************************/
+class DotDeclarative : public QDeclarativeItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(QColor borderColor READ borderColor WRITE setBorderColor NOTIFY borderColorChanged)
+public:
+    explicit DotDeclarative(QDeclarativeItem *parent = 0);
+
+    void paint(QPainter *painter,
+               const QStyleOptionGraphicsItem *option,
+               QWidget *widget = 0);
+
+    inline QColor color() const;
+    void setColor(const QColor &newColor);
+    inline QColor borderColor() const;
+    void setBorderColor(const QColor &newColor);
+
+    /// Move the dot so it is centered on 'center', in the parent's coordinates
+    void setCenter(const QPoint &center);
+    /// Draw this pixmap from now on, and take its size; the colors are unused
+    void setSprite(const QPixmap &sprite);
+
+protected:
+    virtual void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    DotDeclarative(const DotDeclarative&);
+    /// prevent assignment operator
+    DotDeclarative& operator=(const DotDeclarative&);
+
+    /// Draw the dot into m_sprite at the current size and colors
+    void renderSprite();
+
+    QColor m_color;
+    QColor m_borderColor;
+    /// The rendered dot; null until the first paint after a change
+    QPixmap m_sprite;
+    /// m_sprite came from setSprite(), so it is kept as it is
+    bool m_fixedSprite;
+
+signals:
+    void colorChanged();
+    void borderColorChanged();
+};
+
+
+/** ****************************************************************************
+ * Function: color()
+ *
+*******************************************************************************/
+inline QColor DotDeclarative::color() const
+{
+    return m_color;
+}
+/** ****************************************************************************
+ * Function: borderColor()
+ *
+*******************************************************************************/
+inline QColor DotDeclarative::borderColor() const
+{
+    return m_borderColor;
+}
+
+#endif // DOTDECLARATIVE_H
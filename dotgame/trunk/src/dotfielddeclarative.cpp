@@ -0,0 +1,104 @@
+/** ****************************************************************************
+ * @file dotfielddeclarative.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The DotFieldDeclarative: the playing field as a QML scene item.  See
+ * dotfielddeclarative.h.
+ *
+ ******************************************************************************/
+
+#include "dotfielddeclarative.h"
+#include "dotwidget.h"
+#include <QtGui/QPainter>
+#include <QtGui/QStyleOptionGraphicsItem>
+
+/** ****************************************************************************
+ * DotFieldDeclarative Constructor
+ *   The field only takes cursor moves (through the view's viewport); clicks
+ *   go through to the QML below it.
+ ******************************************************************************/
+DotFieldDeclarative::DotFieldDeclarative(DotWidget *dotWidgetPtr, QDeclarativeItem *parent) :
+    QDeclarativeItem(parent),
+    m_dotWidgetPtr(dotWidgetPtr), m_filledItemPtr(NULL)
+{
+    setFlag(QGraphicsItem::ItemHasNoContents, false);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);     // for exposedRect
+    setAcceptedMouseButtons(Qt::NoButton);
+    m_dotWidgetPtr->setFieldItem(this);
+}
+
+/** DotFieldDeclarative Destructor */
+DotFieldDeclarative::~DotFieldDeclarative()
+{
+    if (m_dotWidgetPtr != NULL)
+    {
+        m_dotWidgetPtr->setFieldItem(NULL);
+    }
+}
+
+/** ****************************************************************************
+ * Function: paint()
+ *   Only the exposed part is drawn, as DotWidget::paintEvent() would.
+*******************************************************************************/
+void DotFieldDeclarative::paint(QPainter *painter,
+           const QStyleOptionGraphicsItem *option,
+           QWidget *widget)
+{
+    Q_UNUSED(widget);
+    m_dotWidgetPtr->paintField(painter, QRegion(option->exposedRect.toAlignedRect()));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: fill()
+ *
+*******************************************************************************/
+void DotFieldDeclarative::fill(QDeclarativeItem *itemPtr)
+{
+    if (m_filledItemPtr != NULL)
+    {
+        m_filledItemPtr->disconnect(this);
+    }
+    m_filledItemPtr = itemPtr;
+    if (m_filledItemPtr != NULL)
+    {
+        QObject::connect(m_filledItemPtr, SIGNAL(widthChanged()), this, SLOT(filledItemResized()));
+        QObject::connect(m_filledItemPtr, SIGNAL(heightChanged()), this, SLOT(filledItemResized()));
+        filledItemResized();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: filledItemResized()
+ *
+*******************************************************************************/
+void DotFieldDeclarative::filledItemResized()
+{
+    setSize(QSizeF(m_filledItemPtr->width(), m_filledItemPtr->height()));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: geometryChanged()
+ *   The game plays in the field, so its arena follows the item's size.
+*******************************************************************************/
+void DotFieldDeclarative::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QDeclarativeItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+    {
+        m_dotWidgetPtr->setFieldSize(newGeometry.size().toSize());
+    }
+    return;
+}
@@ -0,0 +1,68 @@
+/** ****************************************************************************
+ * @file dotfielddeclarative.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The DotFieldDeclarative puts the DotWidget's playing field into the QML
+ * scene, so the field, the dot and the control panel are drawn as items of
+ * one view instead of two stacked widgets.  It covers its parent item, and
+ * is drawn by DotWidget::paintField(); the DotWidget itself stays hidden.
+ *
+ ******************************************************************************/
+
+#ifndef DOTFIELDDECLARATIVE_H
+#define DOTFIELDDECLARATIVE_H
+
+#include <QDeclarativeItem>
+#include <QtCore/QPointer>
+
+class DotWidget;
+
+/** ****************************************************************************
+ * @class DotFieldDeclarative
+ *   Scene item showing a DotWidget's field: texts and overlay, but no dot.
+*******************************************************************************/
+class DotFieldDeclarative : public QDeclarativeItem
+{
+    Q_OBJECT
+public:
+    /// @param dotWidgetPtr Game to show; it is told to draw here.  Not owned.
+    explicit DotFieldDeclarative(DotWidget *dotWidgetPtr, QDeclarativeItem *parent = 0);
+    ~DotFieldDeclarative();
+
+    void paint(QPainter *painter,
+               const QStyleOptionGraphicsItem *option,
+               QWidget *widget = 0);
+
+    /// Cover this item, following its size; usually the QML root
+    void fill(QDeclarativeItem *itemPtr);
+
+protected:
+    virtual void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    DotFieldDeclarative(const DotFieldDeclarative&);
+    /// prevent assignment operator
+    DotFieldDeclarative& operator=(const DotFieldDeclarative&);
+
+    /// Cleared if the DotWidget goes first, as the window closes
+    QPointer<DotWidget> m_dotWidgetPtr;
+    /// Item being covered, or NULL
+    QDeclarativeItem *m_filledItemPtr;
+
+private slots:
+    void filledItemResized();
+};
+
+#endif // DOTFIELDDECLARATIVE_H
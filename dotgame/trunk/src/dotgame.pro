@@ -1,7 +1,6 @@
 # Add more folders to ship with the application, here
-folder_01.source = qml/dotgame
-folder_01.target = qml
-DEPLOYMENTFOLDERS = folder_01
+# (none: main.qml is built in from dotgame.qrc, so nothing is read at startup)
+DEPLOYMENTFOLDERS =
 
 # Additional import path used to resolve QML modules in Creator's code model
 QML_IMPORT_PATH =
@@ -35,7 +34,24 @@ SOURCES += main.cpp \
     dotwidget.cpp \
     dot.cpp \
     gradienttextstatusbar.cpp \
-    scorescreen.cpp
+    scorescreen.cpp \
+    scorejournal.cpp \
+    leaderboard.cpp \
+    scorestore.cpp \
+    safefile.cpp \
+    cachedtext.cpp \
+    latencymonitor.cpp \
+    frameprofiler.cpp \
+    perfhud.cpp \
+    sparkline.cpp \
+    dotdeclarative.cpp \
+    dotfielddeclarative.cpp \
+    qsliderdeclarative.cpp \
+    startuptimeline.cpp
+
+# Headless simulation core, built by ../dotgame_all.pro before this project.
+DOTCORE_OUT_PWD = $$OUT_PWD/dotcore
+include(dotcore/dotcore.pri)
 
 # Please do not modify the following two lines. Required for deployment.
 include(qmlapplicationviewer/qmlapplicationviewer.pri)
@@ -46,7 +62,23 @@ HEADERS += \
     dotwidget.h \
     dot.h \
     gradienttextstatusbar.h \
-    scorescreen.h
+    scorescreen.h \
+    scorejournal.h \
+    leaderboard.h \
+    scorestore.h \
+    safefile.h \
+    cachedtext.h \
+    latencymonitor.h \
+    frameprofiler.h \
+    perfhud.h \
+    sparkline.h \
+    dotdeclarative.h \
+    dotfielddeclarative.h \
+    qsliderdeclarative.h \
+    startuptimeline.h
+
+RESOURCES += \
+    dotgame.qrc
 
 #FORMS += \
 #    mainwindow.ui
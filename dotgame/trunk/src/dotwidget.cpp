@@ -12,54 +12,82 @@
  * The DotGame is a Qt application involving a randomly walking dot that the
  * user tries to closely follow with their cursor to achieve a high m_score.
  *
- * The DotWidget object is the main playing field for the game. It contains the
- * animated dot object, calculates distance and m_scores, and contains the main
- * game state machine.
+ * The DotWidget object is the main playing field for the game. It is a view over
+ * the headless GameSim core (which moves the dot and calculates distance and
+ * scores), draws the animated dot, and contains the main game state machine.
  *
  ******************************************************************************/
 
 #include "dotwidget.h"
 #include <QtCore/QSize>
 #include <QtGui/QResizeEvent>
-#include <math.h>             // for pow(), sqrt()
+#include <QtGui/QPaintEvent>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QCursor>
+#include <QtGui/QFontMetrics>
+#include <QtGui/QGraphicsItem>
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
 #include <stdio.h>            // for itoa(), snprintf()
 
+/** ****************************************************************************
+ * GameStateSnapshot Constructor
+ *   The state before any game.
+*******************************************************************************/
+GameStateSnapshot::GameStateSnapshot() :
+    errorRatio(0.0), score(0), elapsedTime(0), dotSpeed(0), statUpdates(0),
+    dotSize(0), skin(SKIN_CLASSIC)
+{
+}
+
 /** ****************************************************************************
  * DotWidget Constructor
  *  @param parent Pointer to the parent window widget
  *  @param winSize Current size od the DotWidget, so Dot is placed in the center
 *******************************************************************************/
 DotWidget::DotWidget(QWidget *parent, QSize winSize) :
-    QWidget(parent), m_gameDotPtr(NULL), m_dotSpeed(Dot::DOT_SPEED_DEFAULT),
-    m_dotSpeedUserSetting(Dot::DOT_SPEED_DEFAULT), m_dotAcceleration(Dot::DOT_ACCEL_DEFAULT),
-    m_dotTimer(this), m_accelerationTimer(this), m_gameStatsTimer(this),
-    m_secondTimerPtr(this), m_elapsedGameTime(0), m_gameLength(GAME_LENGTH_DEFAULT_S),
+    QWidget(parent),
+    m_gameSim(SimPoint(winSize.width()/2, winSize.height()/2), winSize.width(), winSize.height()),
+    m_gameDotPtr(NULL), m_dotSpeedUserSetting(Dot::DOT_SPEED_DEFAULT),
+    m_nextGameSeed(0), m_nextGameSeedSet(false),
+    m_frameTimer(this), m_stepAccumNs(0), m_missedDeadlines(0), m_droppedSimTimeMs(0),
     m_gameState(PAUSED), m_lastGameOverReason(NO_GAME_OVER),
-    m_runningAvgErrorRatio(RUNNING_AVERAGE_ERROR_DEFAULT), m_score(0.0),
-    m_backgroundBrush(QBrush(QColor(Qt::blue), Qt::BDiagPattern))
+    m_backgroundBrush(QBrush(QColor(Qt::blue), Qt::BDiagPattern)),
+    m_paintedPixels(0), m_paintedPixelsPerSecond(0), m_statUpdates(0),
+    m_signalDeliveries(0), m_signalDeliveriesPerSecond(0), m_latencyMonitorPtr(NULL),
+    m_frameProfilerPtr(NULL), m_replayPlayerPtr(NULL), m_replayFilePtr(NULL),
+    m_replayFullSpeed(false), m_liveDotSpeedUserSetting(Dot::DOT_SPEED_DEFAULT),
+    m_fieldItemPtr(NULL)
 {
     resize(winSize);
-    QPoint dotLoc((winSize.width()/2),(winSize.height()/2));
-    m_gameDotPtr = new Dot(this,dotLoc);
-    // when the Dot changes its location, redraw the widget.
+    m_gameDotPtr = new Dot(this, &m_gameSim.dot());
+    // when the Dot changes its location, redraw only where it was and where it is.
     //    use update() for scheduled redraw, or repaint() for immediate redraw.
-    connect(m_gameDotPtr, SIGNAL(newDotLoc(const QPoint)), this, SLOT(update()));    // scheduled redraw
-    connect(m_gameDotPtr, SIGNAL(newDotLoc(const QPoint)), this, SLOT(newDotPosQpnt(const QPoint)));    // inform higher levels
+    connect(m_gameDotPtr, SIGNAL(newDotLoc(const QPoint)), this, SLOT(updateDotRegion(const QPoint)));    // scheduled redraw
+    // higher levels are told through newGameState(), once per frame
+    qRegisterMetaType<GameStateSnapshot>("GameStateSnapshot");
 
     m_textFontSmall.setPointSize(8);
     m_textFontLarge.setPointSize(16);
-    setScoreText(0);     // initialize the m_scoreString.
+    m_scoreText.setFont(m_textFontLarge);
+    setScoreText(0);     // initialize the m_scoreText.
+    m_pausedText = CachedText(tr("Paused"), m_textFontLarge);
+    m_clickToResumeText = CachedText(tr("Click to Start/Resume"), m_textFontSmall);
+    m_followTheDotText = CachedText(tr("Follow the Dot to get a High Score!"), m_textFontSmall);
+    m_beatTheClockText = CachedText(tr("You Beat the Clock!!"), m_textFontLarge);
+    m_gameOverText = CachedText(tr("Game Over"), m_textFontLarge);
+    m_clickForNewGameText = CachedText(tr("Click to Start a New Game"), m_textFontSmall);
+    m_lastDotRect = m_gameDotPtr->boundingRect();
+    m_paintStatsClock.start();
+    m_deliveriesClock.start();
+    setMouseTracking(true);     // cursor samples come from mouse moves, not polling
+    m_frameProfilerPtr = new FrameProfiler(this);
+    m_frameProfilerPtr->watchPaint(this, SECTION_PAINT_DOT);
 
-    m_dotTimer.setInterval(Dot::DOT_SPEED_DEFAULT);
-    m_gameStatsTimer.setInterval(GAME_UPDATE_INTERVAL_MS);
-    m_accelerationTimer.setInterval(Dot::DOT_ACCELERATION_UPDATE_INTERVAL_MS);
-    connect(&m_dotTimer, SIGNAL(timeout()), m_gameDotPtr, SLOT(updateLoc()));
-    connect(&m_gameStatsTimer, SIGNAL(timeout()), this, SLOT(calcGameStats()));
-    connect(&m_accelerationTimer, SIGNAL(timeout()), this, SLOT(increaseDotSpeed()));
-    const int MSEC_IN_SEC = 1000;
-    m_secondTimerPtr.setInterval(MSEC_IN_SEC);
-    QObject::connect(&m_secondTimerPtr, SIGNAL(timeout()),
-                     this, SLOT(updateElapsedGameTime()));
+    // One timer drives the whole game; dot speed, stats, acceleration and
+    //    the time limit are all paced by the simulation inside runFrame().
+    m_frameTimer.setInterval(FRAME_INTERVAL_MS);
+    connect(&m_frameTimer, SIGNAL(timeout()), this, SLOT(runFrame()));
 }
 
 /** DotWidget Destructor */
@@ -68,6 +96,9 @@ DotWidget::~DotWidget()
     // ONLY delete objects that are not in the window hierarchy
     if (m_gameDotPtr != NULL)
         delete m_gameDotPtr;
+    m_gameSim.setRecorder(NULL);
+    delete m_replayPlayerPtr;
+    delete m_replayFilePtr;
 }
 
 
@@ -82,6 +113,7 @@ void DotWidget::initialize()
     QSize widgSize(this->size());
     QPoint newDotLoc((widgSize.width()/2),(widgSize.height()/2));
     m_gameDotPtr->setPos(newDotLoc);
+    publishGameState();
     return;
 }
 
@@ -92,49 +124,81 @@ void DotWidget::initialize()
 void DotWidget::paintEvent(QPaintEvent *event)
 {
     QPainter painter(this);
-    //painter.fillRect(event->rect(), background);   // DEBUG: disable background to see the QML.
-    painter.setRenderHint(QPainter::Antialiasing);
-    m_gameDotPtr->paint(&painter, event);
-    painter.setFont(m_textFontLarge);
-    painter.drawText(0, size().height()/30, size().width(), size().height(),
-                     Qt::AlignHCenter, m_scoreString);
+    paintField(&painter, event->region());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: paintField()
+ *   The widget's paintEvent(), or the scene item's paint().  In a scene the
+ *   Dot is an item of its own, so it isn't drawn here.
+*******************************************************************************/
+void DotWidget::paintField(QPainter *painter, const QRegion &exposed)
+{
+    // count what is actually repainted, to verify the dirty-rectangle savings
+    foreach (const QRect& paintedRect, exposed.rects())
+    {
+        m_paintedPixels += paintedRect.width() * paintedRect.height();
+    }
+    const qint64 statsIntervalMs = m_paintStatsClock.elapsed();
+    const qint64 MSEC_IN_SEC = 1000;
+    if (statsIntervalMs >= MSEC_IN_SEC)
+    {
+        m_paintedPixelsPerSecond = (m_paintedPixels * MSEC_IN_SEC) / statsIntervalMs;
+        m_paintedPixels = 0;
+        m_paintStatsClock.start();
+    }
+
+    //painter->fillRect(exposed.boundingRect(), background);   // DEBUG: disable background to see the QML.
+    painter->setRenderHint(QPainter::Antialiasing);
+    if ((m_fieldItemPtr == NULL) && exposed.intersects(m_lastDotRect))
+    {
+        m_gameDotPtr->paint(painter, NULL);
+    }
+    // the labels are laid out once; a paint only places them
+    m_scoreText.draw(painter, QRect(0, size().height()/30, size().width(), size().height()),
+                     Qt::AlignHCenter);
     switch (m_gameState)
     {
     case RUNNING:
         break;  // don't print any extra text
     case PAUSED:
-        painter.setFont(m_textFontLarge);
-        // drawText(x position, y position, width, height, flags, text);
-        painter.drawText(0, size().height()*2/3, size().width(),
-                         size().height(), Qt::AlignHCenter, tr("Paused"));
-        painter.setFont(m_textFontSmall);
-        painter.drawText(0, size().height()*5/6, size().width(),
-                         size().height(), Qt::AlignHCenter, tr("Click to Start/Resume"));
-        painter.drawText(0, size().height()*9/10, size().width(),
-                         size().height(), Qt::AlignHCenter, tr("Follow the Dot to get a High Score!"));
+        // draw(painter, area (x position, y position, width, height), flags);
+        m_pausedText.draw(painter, QRect(0, size().height()*2/3, size().width(),
+                          size().height()), Qt::AlignHCenter);
+        m_clickToResumeText.draw(painter, QRect(0, size().height()*5/6, size().width(),
+                                 size().height()), Qt::AlignHCenter);
+        m_followTheDotText.draw(painter, QRect(0, size().height()*9/10, size().width(),
+                                size().height()), Qt::AlignHCenter);
         break;
     case GAMEOVER:
-        painter.setFont(m_textFontLarge);
         if (m_lastGameOverReason == TIME_LIMIT)
         {
-            painter.drawText(0, size().height()*2/3, size().width(),
-                             size().height(), Qt::AlignHCenter, tr("You Beat the Clock!!"));
+            m_beatTheClockText.draw(painter, QRect(0, size().height()*2/3, size().width(),
+                                    size().height()), Qt::AlignHCenter);
         }
         else if (m_lastGameOverReason == DISTANCE)
         {
-            painter.drawText(0, size().height()*2/3, size().width(),
-                             size().height(), Qt::AlignHCenter, tr("Game Over"));
+            m_gameOverText.draw(painter, QRect(0, size().height()*2/3, size().width(),
+                                size().height()), Qt::AlignHCenter);
         }
-        painter.setFont(m_textFontSmall);
-        painter.drawText(0, size().height()*5/6, size().width(),
-                         size().height(), Qt::AlignHCenter, tr("Click to Start a New Game"));
+        m_clickForNewGameText.draw(painter, QRect(0, size().height()*5/6, size().width(),
+                                   size().height()), Qt::AlignHCenter);
         break;
     default:
-        qDebug("DotWidget::paintEvent: Unknown m_gameState!");
+        qDebug("DotWidget::paintField: Unknown m_gameState!");
         break;
     }
+    if (isHudVisible() && exposed.intersects(m_perfHud.rect()))
+    {
+        m_perfHud.paint(painter);
+    }
+    if (m_latencyMonitorPtr != NULL)
+    {
+        m_latencyMonitorPtr->markPaintDone();
+    }
     return;
-} // function paintEvent
+} // function paintField
 
 /** ****************************************************************************
  * Function: mousePressEvent()
@@ -148,6 +212,118 @@ void DotWidget::mousePressEvent(QMouseEvent *event)
     return;
 } // function mousePressEvent
 
+/** ****************************************************************************
+ * Function: mouseMoveEvent()
+ *   Called for every mouse move over the window (mouse tracking is on).
+*******************************************************************************/
+void DotWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    addCursorSample(event->pos());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: eventFilter() reimplemented from QObject
+ *   Widgets installed by trackCursorOver() cover the DotWidget and get its
+ *   mouse moves; take a sample from each and let the widget have it too.
+*******************************************************************************/
+bool DotWidget::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::MouseMove)
+    {
+        const QMouseEvent *mouseEvent = static_cast<QMouseEvent*>(event);
+        // a field item sits at the origin of the scene, the viewport's top left
+        addCursorSample((m_fieldItemPtr != NULL) ? mouseEvent->pos() :
+                                                   mapFromGlobal(mouseEvent->globalPos()));
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
+/** ****************************************************************************
+ * Function: trackCursorOver()
+ *   @param widgetPtr Widget stacked over the DotWidget, e.g. the QML viewport.
+*******************************************************************************/
+void DotWidget::trackCursorOver(QWidget *widgetPtr)
+{
+    widgetPtr->setMouseTracking(true);
+    widgetPtr->installEventFilter(this);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: addCursorSample()
+ *   Stamp the sample with the game time it belongs to: the game time of the
+ *   last frame plus the real time that the next frame will simulate.
+*******************************************************************************/
+void DotWidget::addCursorSample(const QPoint &cursorPos)
+{
+    if ((m_gameState != RUNNING) || isReplaying())    // a replay brings its own cursor
+    {
+        return;
+    }
+    const qint64 NSEC_IN_USEC = 1000;
+    const qint64 USEC_IN_MSEC = 1000;
+    const qint64 sampleTimeUs = qint64(m_gameSim.getElapsedTimeMs()) * USEC_IN_MSEC +
+            (m_frameClock.nsecsElapsed() + m_stepAccumNs) / NSEC_IN_USEC;
+    m_gameSim.addCursorSample(sampleTimeUs, SimPoint(cursorPos.x(), cursorPos.y()));
+    if (m_latencyMonitorPtr != NULL)
+    {
+        m_latencyMonitorPtr->markInput();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setLatencyMonitor()
+ *   @param monitorPtr Monitor to mark the stages of every frame on, or NULL
+ *      to stop measuring.  Not owned by the DotWidget.
+*******************************************************************************/
+void DotWidget::setLatencyMonitor(LatencyMonitor *monitorPtr)
+{
+    m_latencyMonitorPtr = monitorPtr;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setHudVisible()
+ *   The frame profiler only runs while the overlay is shown, so a hidden
+ *   overlay costs nothing.
+*******************************************************************************/
+void DotWidget::setHudVisible(bool visible)
+{
+    m_frameProfilerPtr->setEnabled(visible);
+    m_gameSim.setStepProfiler(visible ? m_frameProfilerPtr : NULL);
+    if (visible)
+    {
+        m_perfHud.refresh(*m_frameProfilerPtr, m_signalDeliveriesPerSecond,
+                          m_missedDeadlines, m_droppedSimTimeMs);
+    }
+    updateField(m_perfHud.rect());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: toggleHud()
+ *
+*******************************************************************************/
+void DotWidget::toggleHud()
+{
+    setHudVisible(!isHudVisible());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: cycleDotSkin()
+ *   Draws the Dot in the next skin, back to the first after the last.  Only
+ *   its look changes, so it is allowed during a replay too.
+*******************************************************************************/
+void DotWidget::cycleDotSkin()
+{
+    m_gameDotPtr->setSkin(static_cast<dotSkin>((getDotSkin() + 1) % SKIN_COUNT));
+    publishGameState();
+    return;
+}
+
 /** ****************************************************************************
  * Function: resizeEvent() reimplemented from QWidget
  *   Called after the window is resized, but before it is redrawn.
@@ -157,46 +333,97 @@ void DotWidget::mousePressEvent(QMouseEvent *event)
 void DotWidget::resizeEvent(QResizeEvent *event)
 {
     //qDebug("DotWidget::resizeEvent: window size is now %i by %i", size().width(), size().height());
-    if ((m_gameDotPtr != NULL) && (event->oldSize().width() > 0))
+    fieldResized(event->oldSize());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setFieldSize()
+ *   A hidden widget gets its resizeEvent() only when shown, so when the field
+ *   is drawn in a scene the resize is handled here instead.
+*******************************************************************************/
+void DotWidget::setFieldSize(const QSize &newSize)
+{
+    const QSize oldSize = size();
+    resize(newSize);
+    if (!isVisible() && (newSize != oldSize))
+    {
+        fieldResized(oldSize);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: fieldResized()
+ *   Keeps the Dot at the same offset from the center of the field.
+*******************************************************************************/
+void DotWidget::fieldResized(const QSize &oldSize)
+{
+    if (isReplaying())
+    {
+        return;     // the replay keeps the recorded arena, or it would diverge
+    }
+    if (m_gameDotPtr != NULL)
+    {
+        m_gameDotPtr->setBounds(size());    // cache the new arena size in the game core
+    }
+    if ((m_gameDotPtr != NULL) && (oldSize.width() > 0))
     {
         // adjust the position of the dot to retain relative offset from center.
         QPoint dotPos(m_gameDotPtr->getPos());
-        dotPos.setX(dotPos.x()+((size().width() - event->oldSize().width())/2));
-        dotPos.setY(dotPos.y()+((size().height() - event->oldSize().height())/2));
+        dotPos.setX(dotPos.x()+((size().width() - oldSize.width())/2));
+        dotPos.setY(dotPos.y()+((size().height() - oldSize.height())/2));
         m_gameDotPtr->applyBoundaryCheck(dotPos);   // affects the dotPos, not the actual gameDot yet
         m_gameDotPtr->setPos(dotPos);
-        //qDebug("DotWidget::resizeEvent: width was %i now %i moved dot by %i", size().width(), event->oldSize().width(), adjX);
-        //qDebug("DotWidget::resizeEvent: height was %i now %i moved dot by %i", size().height(), event->oldSize().height(), adjY);
+        publishGameState();
+        //qDebug("DotWidget::fieldResized: width was %i now %i", size().width(), oldSize.width());
     }
+    m_gameSim.notifySettingsChanged();      // the recording gets the new arena
     return;
 }
 
 /** ****************************************************************************
  * Function: setm_dotSize()
- *
+ *   Published straight away, so the views resize their dot even while paused.
+ *   Ignored during a replay, which has the recorded size.
 *******************************************************************************/
 bool DotWidget::setDotSize(const int newSize)
 {
+    if (isReplaying())
+    {
+        return false;
+    }
     bool result = m_gameDotPtr->setm_dotSize(newSize);
-    update();
+    m_gameSim.notifySettingsChanged();
+    m_lastDotRect = m_gameDotPtr->boundingRect();
+    updateField();
+    publishGameState();
     return result;
 }
 
 /** ****************************************************************************
  * Function: userSetDotSpeedNeg()
  *   @param newSpeedMs dot speed in milliseconds between position updates.
- *   Sets the timer interval for how often the dot moves.  During each game, the
+ *   Sets how often the dot moves.  During each game, the
  *   m_dotSpeed may increase. Use the user setting as the new default speed for
  *   the dot at the beginning of a new game.
 *******************************************************************************/
 bool DotWidget::setDotSpeedNeg(const int newSpeedMs)
 {
+    if (isReplaying())
+    {
+        return false;   // the replay has the recorded speeds
+    }
     // Speed slider values were inverted so that the bigger/slower numbers were on the left side.
     uint newSpeedMsAbs = abs(newSpeedMs);
     if ((newSpeedMsAbs >= Dot::DOT_SPEED_MIN) && (newSpeedMsAbs <= Dot::DOT_SPEED_MAX))
     {
-        m_dotTimer.setInterval(newSpeedMsAbs);
-        m_dotSpeed = newSpeedMsAbs;
+        if (newSpeedMsAbs != m_gameSim.getDotSpeed())
+        {
+            // not when the slider just follows the acceleration
+            m_gameSim.setDotSpeed(newSpeedMsAbs);
+            m_gameSim.notifySettingsChanged();
+        }
         if (m_gameState != RUNNING)
         {
             // While RUNNING, speed can change automatically.  Otherwise, user
@@ -219,70 +446,112 @@ bool DotWidget::setDotSpeedNeg(const int newSpeedMs)
 void DotWidget::setDotAcceleration(const int newAcceleration)
 {
     //qDebug("DotWidget::setm_dotAcceleration: newAcceleration=%i", newAcceleration);
-    if (newAcceleration >= 0)
+    if ((newAcceleration >= 0) && !isReplaying())
     {
-        m_dotAcceleration = newAcceleration;
-    }
-    if ((newAcceleration > 0) && (m_gameState == RUNNING))
-    {
-        m_accelerationTimer.start();
-    }
-    else
-    {
-        m_accelerationTimer.stop();
+        m_gameSim.setDotAcceleration(newAcceleration);
+        m_gameSim.notifySettingsChanged();
     }
     return;
 }
 
 /** ****************************************************************************
- * Function: increaseDotSpeed()
- *
+ * Function: runFrame()
+ *   The game loop, called by the one frame timer.  Real time since the last
+ *   frame is added to an accumulator and simulated in fixed SIM_STEP_MS steps
+ *   (catching up after a late frame), each running dot motion, game stats,
+ *   acceleration and the time limit in that order.  The results are then
+ *   published once per frame, so there is at most one repaint and one
+ *   newGameState() per frame, however many steps ran.
 *******************************************************************************/
-void DotWidget::increaseDotSpeed()
+void DotWidget::runFrame()
 {
-    //qDebug("DotWidget::increaseDotSpeed: Oldspeed=%i accel=%i", m_dotSpeed, m_dotAcceleration);
-    m_dotSpeed -= m_dotAcceleration;
-    if (m_dotSpeed < Dot::DOT_SPEED_MIN)
+    if (m_gameState != RUNNING)
     {
-        m_dotSpeed = Dot::DOT_SPEED_MIN;
-        m_accelerationTimer.stop();
+        return;
+    }
+    m_frameProfilerPtr->beginFrame();
+    const qint64 NSEC_IN_MSEC = 1000000;
+    const qint64 frameNs = m_frameClock.nsecsElapsed();
+    m_frameClock.start();
+    if (frameNs > 2 * FRAME_INTERVAL_MS * NSEC_IN_MSEC)
+    {
+        ++m_missedDeadlines;      // a whole frame was skipped
+    }
+    m_stepAccumNs += frameNs;
+    qint64 dueSteps = m_stepAccumNs / (SIM_STEP_MS * NSEC_IN_MSEC);
+    m_stepAccumNs -= dueSteps * SIM_STEP_MS * NSEC_IN_MSEC;
+    if (isReplaying() && m_replayFullSpeed)
+    {
+        dueSteps = REPLAY_FULL_SPEED_STEPS;
+    }
+    else if (dueSteps > MAX_CATCH_UP_STEPS)
+    {
+        // Too far behind (e.g. window dragged, machine suspended): drop the rest.
+        m_droppedSimTimeMs += (dueSteps - MAX_CATCH_UP_STEPS) * SIM_STEP_MS;
+        dueSteps = MAX_CATCH_UP_STEPS;
+        ++m_missedDeadlines;
     }
-    emit newDotSpeedNeg(-m_dotSpeed);
-    return;
-}
 
-/** ****************************************************************************
- * Function: calcGameStats()
- *     1) Calculate the error distance between mouse pointer and dot location.
- *     2) Calculate a running m_score
- *     3) Is the game over due to distance?
-*******************************************************************************/
-void DotWidget::calcGameStats()
-{
-    QPoint mousePosition = mapFromGlobal(QCursor::pos());
-    float posErrorRatio = m_gameDotPtr->calcPosErrorRatio(mousePosition);
-    m_runningAvgErrorRatio = (m_runningAvgErrorRatio * (ERROR_AVERAGING_RATIO - 1)
-                         + posErrorRatio) / ERROR_AVERAGING_RATIO;
-//    QPoint dotPos = m_gameDotPtr->getPos();
-//    qDebug("DotWidget::calcGameStats: mousePos=(%i,%i) dotPos=%i,%i) errorRatio=%.2f runAverage=%.2f",
-//           mousePosition.x(), mousePosition.y(), dotPos.x(), dotPos.y(), posErrorRatio, m_runningAvgErrorRatio);
-    emit newFollowDistanceRatio(m_runningAvgErrorRatio, m_elapsedGameTime);
-    float distm_scoreComp = 10 * (CURSOR_DISTANCE_GAMEOVER - m_runningAvgErrorRatio) /
-            CURSOR_DISTANCE_GAMEOVER;
-    float speedm_scoreComp = static_cast<float>(Dot::DOT_SPEED_MAX - m_dotSpeed) /
-            (Dot::DOT_SPEED_MAX - Dot::DOT_SPEED_MIN);
-    float compositem_scoreInc = pow(distm_scoreComp,3) * speedm_scoreComp / 40;
-    m_score += compositem_scoreInc;
-//    qDebug("DotWidget::calcGameStats: distm_score=%.2f speedm_score=%.2f comp=%.2f newm_score=%.2f",
-//           distm_scoreComp, speedm_scoreComp, compositem_scoreInc, m_score);
-    setScoreText(m_score);
-    if (m_runningAvgErrorRatio >= CURSOR_DISTANCE_GAMEOVER)
+    uint dotMoves = 0;
+    uint statUpdates = 0;
+    bool speedChanged = false;
+    bool settingsReplayed = false;
+    gameOverReason reason = NO_GAME_OVER;
+    for (qint64 stepNum = 0; (stepNum < dueSteps) && (reason == NO_GAME_OVER); ++stepNum)
+    {
+        if (isReplaying())
+        {
+            const qint64 USEC_IN_MSEC = 1000;
+            settingsReplayed |= m_replayPlayerPtr->feedCursor(m_gameSim,
+                    qint64(m_gameSim.getElapsedTimeMs() + SIM_STEP_MS) * USEC_IN_MSEC);
+        }
+        GameSim::StepResult result = m_gameSim.step(SIM_STEP_MS);     // scores the queued cursor samples
+        dotMoves += result.dotMoves;
+        statUpdates += result.statUpdates;
+        speedChanged |= result.speedChanged;
+        reason = result.gameOver;
+    }
+
+    if (m_latencyMonitorPtr != NULL)
+    {
+        m_latencyMonitorPtr->markUpdate(dotMoves > 0);
+    }
+    if (settingsReplayed)
     {
-        //qDebug("DotWidget::calcGameStats: Distance Limit reached, GameOver");
-        setGameOver(DISTANCE);
+        // the recorded game changed its size or speed here
+        m_lastDotRect = m_gameDotPtr->boundingRect();
+        updateField();
+        speedChanged = true;
+    }
+    if (dotMoves > 0)
+    {
+        m_gameDotPtr->notifyMoved();     // one redraw, however often it moved
+    }
+    if (statUpdates > 0)
+    {
+        m_statUpdates += statUpdates;
+        setScoreText(getScore());
+    }
+    if (speedChanged)
+    {
+        emit newDotSpeedNeg(-static_cast<int>(m_gameSim.getDotSpeed()));
+    }
+    if ((dotMoves > 0) || (statUpdates > 0) || speedChanged || (reason != NO_GAME_OVER))
+    {
+        publishGameState();     // before gameOver(), so the views show the final state
+    }
+    if (isHudVisible() && m_perfHud.refresh(*m_frameProfilerPtr, m_signalDeliveriesPerSecond,
+                                            m_missedDeadlines, m_droppedSimTimeMs))
+    {
+        updateField(m_perfHud.rect());
+    }
+    if (reason != NO_GAME_OVER)
+    {
+        //qDebug("DotWidget::runFrame: GameOver, reason=%i", reason);
+        setGameOver(reason);
     }
     return;
-}
+} // function runFrame
 
 /** ****************************************************************************
  * Function: setTimeLimit()
@@ -291,9 +560,14 @@ void DotWidget::calcGameStats()
 bool DotWidget::setTimeLimit(const int timeLimit)
 {
     qDebug("DotWidget::setTimeLimit: value=%i", timeLimit);
+    if (isReplaying())
+    {
+        return false;   // the replay has the recorded time limit
+    }
     if (timeLimit >= 0)
     {
-        m_gameLength = timeLimit;
+        m_gameSim.setTimeLimit(timeLimit);
+        m_gameSim.notifySettingsChanged();
         return true;
     }
     else
@@ -304,21 +578,14 @@ bool DotWidget::setTimeLimit(const int timeLimit)
 }
 
 /** ****************************************************************************
- * Function: updatem_elapsedGameTime()
- *
+ * Function: setGameSeed()
+ *   @param gameSeed Seed for the dot motion of the next game started.  Without
+ *      it, each game is seeded from the clock.
 *******************************************************************************/
-void DotWidget::updateElapsedGameTime()
+void DotWidget::setGameSeed(const quint64 gameSeed)
 {
-    if (m_gameState == RUNNING)
-    {
-        m_elapsedGameTime += 1;       // assumes the time increment is 1 second.
-        if ((m_elapsedGameTime >= m_gameLength) && (m_gameLength != INFINITE))
-        {
-            //qDebug("DotWidget::updatem_elapsedGameTime: Time Limit reached, GameOver");
-            setGameOver(TIME_LIMIT);
-        }
-    }
-    // else do nothing, don't increment 'elapsedTime'.
+    m_nextGameSeed = gameSeed;
+    m_nextGameSeedSet = true;
     return;
 }
 
@@ -331,7 +598,7 @@ void DotWidget::setBackgroundColor(const int newHSVcolor)
     QColor tempHSV;
     tempHSV.setHsv(newHSVcolor,255,150);
     m_backgroundBrush.setColor(tempHSV);
-    update();
+    updateField();
     return;
 }
 
@@ -342,7 +609,106 @@ void DotWidget::setBackgroundColor(const int newHSVcolor)
 void DotWidget::setScoreText(const uint newScore)
 {
     //qDebug("DotWidget::setm_score: m_score=%5i", newm_score);
-    snprintf(m_scoreString, SCORE_STRING_LENGTH, "m_score: %5i", newScore);
+    char newScoreString[SCORE_STRING_LENGTH];
+    snprintf(newScoreString, SCORE_STRING_LENGTH, "m_score: %5i", newScore);
+    if (m_scoreText.setText(QString::fromLatin1(newScoreString)))
+    {
+        updateField(scoreTextRect());     // only the text, and only when it changed
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setFieldItem()
+ *   While the field is drawn in a scene the widget stays hidden: the item's
+ *   paint() calls paintField(), and repaints go to the item.  The scene has
+ *   its own dot item, moved by the views of newGameState().
+ *   @param itemPtr Item covering the field, at the scene origin.  Not owned.
+*******************************************************************************/
+void DotWidget::setFieldItem(QGraphicsItem *itemPtr)
+{
+    m_fieldItemPtr = itemPtr;
+    setFieldCursor((m_gameState == RUNNING) ? Qt::CrossCursor : Qt::ArrowCursor);
+    updateField();
+    return;
+}
+
+/** ****************************************************************************
+ * Function: updateField()
+ *
+*******************************************************************************/
+void DotWidget::updateField()
+{
+    if (m_fieldItemPtr != NULL)
+    {
+        m_fieldItemPtr->update();
+    }
+    else
+    {
+        update();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: updateField()
+ *   @param rect Area of the field to repaint, in field coordinates
+*******************************************************************************/
+void DotWidget::updateField(const QRect &rect)
+{
+    if (m_fieldItemPtr != NULL)
+    {
+        m_fieldItemPtr->update(QRectF(rect));
+    }
+    else
+    {
+        update(rect);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setFieldCursor()
+ *
+*******************************************************************************/
+void DotWidget::setFieldCursor(Qt::CursorShape shape)
+{
+    if (m_fieldItemPtr != NULL)
+    {
+        m_fieldItemPtr->setCursor(shape);
+    }
+    else
+    {
+        setCursor(shape);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scoreTextRect()
+ *   The score is drawn centered at the top; invalidate the full width so any
+ *   length of text is covered.
+*******************************************************************************/
+QRect DotWidget::scoreTextRect() const
+{
+    QFontMetrics largeMetrics(m_textFontLarge);
+    return QRect(0, size().height()/30, size().width(), largeMetrics.height() + 1);
+}
+
+/** ****************************************************************************
+ * Function: updateDotRegion()
+ *   The Dot moved: repaint where it was and where it is now, instead of the
+ *   whole widget.
+*******************************************************************************/
+void DotWidget::updateDotRegion(const QPoint loc)
+{
+    Q_UNUSED(loc);
+    const QRect newDotRect = m_gameDotPtr->boundingRect();
+    if (m_fieldItemPtr == NULL)
+    {
+        update(m_lastDotRect.united(newDotRect));   // a scene moves its own dot item
+    }
+    m_lastDotRect = newDotRect;
     return;
 }
 
@@ -353,6 +719,10 @@ void DotWidget::setScoreText(const uint newScore)
 void DotWidget::startGame()
 {
     resetGameStats();
+    if (m_latencyMonitorPtr != NULL)
+    {
+        m_latencyMonitorPtr->reset();   // latency is reported per game
+    }
     unpauseGame();
     return;
 }
@@ -363,11 +733,8 @@ void DotWidget::startGame()
 *******************************************************************************/
 void DotWidget::pauseGame()
 {
-    setCursor(Qt::ArrowCursor);
-    m_dotTimer.stop();
-    m_gameStatsTimer.stop();
-    m_accelerationTimer.stop();
-    m_secondTimerPtr.stop();
+    setFieldCursor(Qt::ArrowCursor);
+    m_frameTimer.stop();
     m_gameState = PAUSED;
     return;
 }
@@ -378,15 +745,27 @@ void DotWidget::pauseGame()
 *******************************************************************************/
 void DotWidget::unpauseGame()
 {
-    setCursor(Qt::CrossCursor);
-    m_dotTimer.start();
-    m_gameStatsTimer.start();
-    if (m_dotAcceleration > 0)
+    setFieldCursor(Qt::CrossCursor);
+    // paused time doesn't count, so restart the clock and the remainder.
+    m_frameClock.start();
+    m_frameProfilerPtr->discardFrame();     // the pause is not a frame
+    m_stepAccumNs = 0;
+    m_frameTimer.start();
+    m_gameState = RUNNING;
+    if (m_gameSim.getElapsedTimeMs() == 0)
     {
-        m_accelerationTimer.start();
+        // a new game: its deadlines are counted over all of it, pauses or not
+        m_missedDeadlines = 0;
+        m_droppedSimTimeMs = 0;
     }
-    m_secondTimerPtr.start();
-    m_gameState = RUNNING;
+    if ((m_gameSim.getElapsedTimeMs() == 0) && !isReplaying())
+    {
+        // a new game: record it from its settings before the first sample
+        m_replayWriter.begin(m_gameSim);
+        m_gameSim.setRecorder(&m_replayWriter);
+    }
+    // the cursor may have moved while paused; one poll, then mouse moves only.
+    addCursorSample(mapFromGlobal(QCursor::pos()));
     return;
 }
 
@@ -396,15 +775,23 @@ void DotWidget::unpauseGame()
 *******************************************************************************/
 void DotWidget::resetGameStats()
 {
-    m_score = 0;
-    setScoreText(m_score);
-    m_elapsedGameTime = 0;
-    if (m_dotAcceleration > 0)
+    // Every game gets its own seed, so it can be replayed from it.
+    quint64 gameSeed = m_nextGameSeed;
+    if (!m_nextGameSeedSet)
+    {
+        gameSeed = DotRandom::mixSeed(QDateTime::currentMSecsSinceEpoch());
+    }
+    m_nextGameSeedSet = false;
+    m_gameSim.resetGameStats(m_gameSim.getDotAcceleration() > 0 ?
+                                 m_dotSpeedUserSetting : m_gameSim.getDotSpeed(),
+                             gameSeed);
+    setScoreText(0);
+    m_statUpdates = 0;
+    if (m_gameSim.getDotAcceleration() > 0)
     {
-        m_dotSpeed = m_dotSpeedUserSetting;
-        emit newDotSpeedNeg(-m_dotSpeed);
+        emit newDotSpeedNeg(-static_cast<int>(m_gameSim.getDotSpeed()));
     }
-    m_runningAvgErrorRatio = RUNNING_AVERAGE_ERROR_DEFAULT;
+    publishGameState();
     // just leave the dot in the same location for the next game.
     return;
 }
@@ -418,19 +805,159 @@ void DotWidget::setGameOver(const gameOverReason& reason)
     m_lastGameOverReason = reason;
     pauseGame();
     m_gameState = GAMEOVER;
-    update();    // redraw to show final game state, GAMEOVER text
+    m_gameSim.setRecorder(NULL);
+    if (!isReplaying())
+    {
+        // written off the GUI thread by whoever listens, e.g. the ScoreStore.
+        //    A minute of play with a 125 Hz mouse chasing the dot is around 6.5KB.
+        m_replayWriter.finish(reason, m_gameSim.getScore());
+        const std::vector<uint8_t> &data = m_replayWriter.data();
+        emit replayRecorded(QByteArray(reinterpret_cast<const char *>(&data[0]), int(data.size())));
+    }
+    updateField();    // redraw to show final game state, GAMEOVER text
     emit gameOver(reason);   // tell MainWindow.
+    if (isReplaying())
+    {
+        m_replayPlayerPtr->checkResult(reason, m_gameSim.getScore());
+        emit replayChecked(m_replayFilePtr->fileName(), m_replayPlayerPtr->getMismatches(),
+                           m_gameSim.getScore(), m_replayPlayerPtr->getRecordedScore());
+        endReplay();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: playReplay()
+ *   The file is memory-mapped and decoded as the game runs.  Live cursor input
+ *   is ignored until the replay ends; it then behaves as a finished game.
+ *   @param fileName Replay sent by replayRecorded() and saved.  replayChecked()
+ *      follows when it ends.
+ *   @param fullSpeed Run REPLAY_FULL_SPEED_STEPS steps per frame, rather than
+ *      real time, e.g. to check a batch of replays quickly.
+ *   @return false if the file can't be read as a replay.
+*******************************************************************************/
+bool DotWidget::playReplay(const QString &fileName, bool fullSpeed)
+{
+    if (isReplaying())
+    {
+        endReplay();
+    }
+    pauseGame();
+    // the replay runs with the recorded settings; these come back after it
+    m_liveSettings.dotDiam = getDotSize();
+    m_liveSettings.dotSpeedMs = m_gameSim.getDotSpeed();
+    m_liveSettings.dotAcceleration = m_gameSim.getDotAcceleration();
+    m_liveSettings.timeLimitS = m_gameSim.getTimeLimit();
+    m_liveDotSpeedUserSetting = m_dotSpeedUserSetting;
+    m_replayFilePtr = new QFile(fileName);
+    const uchar *data = NULL;
+    if (m_replayFilePtr->open(QIODevice::ReadOnly))
+    {
+        data = m_replayFilePtr->map(0, m_replayFilePtr->size());
+    }
+    if (data != NULL)
+    {
+        m_replayPlayerPtr = new ReplayPlayer(data, size_t(m_replayFilePtr->size()));
+    }
+    if ((m_replayPlayerPtr == NULL) || !m_replayPlayerPtr->isValid())
+    {
+        qDebug("DotWidget::playReplay: %s is not a replay", qPrintable(fileName));
+        endReplay();
+        return false;
+    }
+    m_replayFullSpeed = fullSpeed;
+    m_replayPlayerPtr->configure(m_gameSim);
+    m_gameSim.setRecorder(m_replayPlayerPtr);
+    m_gameDotPtr->notifyMoved();
+    setScoreText(0);
+    m_statUpdates = 0;
+    emit newDotSpeedNeg(-static_cast<int>(m_gameSim.getDotSpeed()));
+    publishGameState();
+    if (m_latencyMonitorPtr != NULL)
+    {
+        m_latencyMonitorPtr->reset();
+    }
+    unpauseGame();
+    updateField();
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: endReplay()
+ *   A replay that matches its recording has no mismatches and ends with the
+ *   same score.  The recorded arena, dot size, speed, acceleration and time
+ *   limit were only for the replay: the next game gets the field's own size,
+ *   the Dot in its center, and the settings from before playReplay().
+*******************************************************************************/
+void DotWidget::endReplay()
+{
+    const bool configured = (m_replayPlayerPtr != NULL) && m_replayPlayerPtr->isValid();
+    if (m_replayPlayerPtr != NULL)
+    {
+        qDebug("DotWidget::endReplay: %u mismatches, score %.3f replayed, %.3f recorded",
+               m_replayPlayerPtr->getMismatches(), m_gameSim.getScore(),
+               m_replayPlayerPtr->getRecordedScore());
+    }
+    m_gameSim.setRecorder(NULL);
+    delete m_replayPlayerPtr;
+    m_replayPlayerPtr = NULL;
+    delete m_replayFilePtr;     // also unmaps it
+    m_replayFilePtr = NULL;
+    if (configured)
+    {
+        m_gameDotPtr->setBounds(size());
+        m_gameDotPtr->setm_dotSize(m_liveSettings.dotDiam);
+        QPoint center(width()/2, height()/2);
+        m_gameDotPtr->setPos(center);
+        m_lastDotRect = m_gameDotPtr->boundingRect();
+        m_gameSim.setDotAcceleration(m_liveSettings.dotAcceleration);
+        m_gameSim.setTimeLimit(m_liveSettings.timeLimitS);
+        m_gameSim.setDotSpeed(m_liveSettings.dotSpeedMs);
+        emit newDotSpeedNeg(-static_cast<int>(m_gameSim.getDotSpeed()));
+        m_dotSpeedUserSetting = m_liveDotSpeedUserSetting;     // after the slider echoed it
+        updateField();
+        publishGameState();
+    }
     return;
 }
 
 /** ****************************************************************************
- * Function: newDotPosQpnt()
- *  temporary function to call empty newDotPos in QML.
+ * Function: gameState()
+ *
+*******************************************************************************/
+GameStateSnapshot DotWidget::gameState() const
+{
+    GameStateSnapshot state;
+    state.dotPos = m_gameDotPtr->getPos();
+    const SimPoint cursorPos = m_gameSim.getCursorPos();
+    state.cursorPos = QPoint(cursorPos.x, cursorPos.y);
+    state.errorRatio = m_gameSim.getErrorRatio();
+    state.score = getScore();
+    state.elapsedTime = m_gameSim.getElapsedTime();
+    state.dotSpeed = m_gameSim.getDotSpeed();
+    state.statUpdates = m_statUpdates;
+    state.dotSize = getDotSize();
+    state.skin = getDotSkin();
+    return state;
+}
+
+/** ****************************************************************************
+ * Function: publishGameState()
+ *   The deliveries are counted per connected slot, so a view added later
+ *   shows up in getSignalDeliveriesPerSecond().
 *******************************************************************************/
-void DotWidget::newDotPosQpnt(const QPoint loc) const
+void DotWidget::publishGameState()
 {
-    QVariant dotLocQvar(loc);
-    emit newDotLoc(dotLocQvar);
+    emit newGameState(gameState());
+    m_signalDeliveries += receivers(SIGNAL(newGameState(GameStateSnapshot)));
+    const qint64 MSEC_IN_SEC = 1000;
+    const qint64 intervalMs = m_deliveriesClock.elapsed();
+    if (intervalMs >= MSEC_IN_SEC)
+    {
+        m_signalDeliveriesPerSecond = (qint64(m_signalDeliveries) * MSEC_IN_SEC) / intervalMs;
+        m_signalDeliveries = 0;
+        m_deliveriesClock.start();
+    }
     return;
 }
 
@@ -446,7 +973,14 @@ void DotWidget::screenClicked()
         pauseGame();
         break;
     case PAUSED:
-        unpauseGame();
+        if ((m_gameSim.getElapsedTimeMs() == 0) && !isReplaying())
+        {
+            startGame();    // the session's first game: give it its own seed too
+        }
+        else
+        {
+            unpauseGame();
+        }
         break;
     case GAMEOVER:
         startGame();
@@ -455,6 +989,6 @@ void DotWidget::screenClicked()
         qDebug("DotWidget::mousePressEvent: Unknown gameState!");
         break;
     }
-    update();    // redraw
+    updateField();    // redraw
     return;
 }
@@ -12,9 +12,12 @@
  * The DotGame is a Qt application involving a randomly walking dot that the
  * user tries to closely follow with their cursor to achieve a high m_score.
  *
- * The DotWidget object is the main playing field for the game. It contains the
- * animated dot object, calculates distance and m_scores, and contains the main
- * game state machine.
+ * The DotWidget object is the main playing field for the game. It is a view over
+ * the headless GameSim core (which moves the dot and calculates distance and
+ * scores), draws the animated dot, and contains the main game state machine.
+ * However fast the game runs, the rest of the window hears about it once per
+ * frame, through one GameStateSnapshot.  The DotWidget can also stay hidden
+ * and draw its field into an item of a QGraphicsScene; see setFieldItem().
  *
  ******************************************************************************/
 
@@ -24,8 +27,20 @@
 #include <QtGui/QWidget>
 #include <QtGui/QBrush>
 #include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 #include "dot.h"          // to create a dot object in the frame
-#include <QVariant>
+#include "gamesim.h"      // headless game rules, gameOverReason
+#include "cachedtext.h"   // laid-out labels
+#include "latencymonitor.h"
+#include "frameprofiler.h"
+#include "perfhud.h"
+#include "gamereplay.h"   // game recording and playback
+#include <QtCore/QPoint>
+#include <QtCore/QMetaType>
+#include <QtCore/QByteArray>
+
+class QFile;
+class QGraphicsItem;
 
 /// Possible game states for the Dot Game.
 enum dotGameState {
@@ -33,23 +48,38 @@ enum dotGameState {
     RUNNING,
     GAMEOVER
 };
-/// Possible reason for the Dot Game ending.
-enum gameOverReason {
-    NO_GAME_OVER = 0,
-    TIME_LIMIT,
-    DISTANCE
-};
-/// Possible game time modes.  Either infinite, or a certain time in seconds.
-enum gameTimeMode {
-    INFINITE = 0
-    // all values >0 are treated as actual times
+
+/** ****************************************************************************
+ * @struct GameStateSnapshot
+ *   Everything shown about the running game, as of the end of one frame.
+ *   Made once per frame and passed by value, so every view sees the same one.
+*******************************************************************************/
+struct GameStateSnapshot {
+    GameStateSnapshot();
+
+    /// Centre of the dot, and where the cursor was last scored, in pixels
+    QPoint dotPos;
+    QPoint cursorPos;
+    /// Running average of the cursor distance, over the dot movement distance
+    float errorRatio;
+    uint score;
+    /// Game time, in seconds
+    uint elapsedTime;
+    /// Time between dot moves, in ms
+    uint dotSpeed;
+    /// Stat updates so far this game; errorRatio and score change only with it
+    uint statUpdates;
+    /// Diameter of the dot, in pixels, and how it is drawn
+    uint dotSize;
+    dotSkin skin;
 };
+Q_DECLARE_METATYPE(GameStateSnapshot)
 
 /** ****************************************************************************
  * @class DotWidget
- *   The DotWidget object is the main playing field for the game. It contains the
- *   animated dot object, calculates distance and m_scores, and contains the main
- *   game state machine.
+ *   The DotWidget object is the main playing field for the game. It is a view
+ *   over the headless GameSim core, draws the animated dot, and contains the
+ *   main game state machine.
 *******************************************************************************/
 class DotWidget : public QWidget
 {
@@ -64,29 +94,80 @@ public:
     inline dotGameState getGameState() const;
     inline uint getScore() const;
     inline uint getDotSize() const;
+    inline dotSkin getDotSkin() const;
+    inline const QPixmap &getDotSprite() const;
     inline uint getDotSpeed() const;
     inline float getErrorRatio() const;
     inline uint getElapsedTime() const;
+    inline quint64 getGameSeed() const;
+    inline uint getMissedDeadlines() const;
+    inline uint getDroppedSimTimeMs() const;
+    inline uint getPaintedPixelsPerSecond() const;
+    inline uint getSignalDeliveriesPerSecond() const;
+    /// The game as it is now; newGameState() sends the same once per frame
+    GameStateSnapshot gameState() const;
+
+    /// Use a fixed seed for the next game, e.g. to replay it
+    void setGameSeed(const quint64 gameSeed);
+
+    /// Also take cursor samples from mouse moves over a widget stacked on top
+    void trackCursorOver(QWidget *widgetPtr);
+
+    /// Report input, frame and paint times to a LatencyMonitor; NULL for none
+    void setLatencyMonitor(LatencyMonitor *monitorPtr);
+
+    /// Draw the field into this scene item instead of the widget; NULL for the widget
+    void setFieldItem(QGraphicsItem *itemPtr);
+    /// Resize the playing field, also while the widget is hidden
+    void setFieldSize(const QSize &newSize);
+    /// Draw the texts, overlay and (unless in a scene) the Dot within 'exposed'
+    void paintField(QPainter *painter, const QRegion &exposed);
+
+    /// Play a recorded game, instead of the user, until it ends
+    bool playReplay(const QString &fileName, bool fullSpeed);
+    inline bool isReplaying() const;
+
+    /// Frame timing behind the performance overlay; watch more paints with it
+    inline FrameProfiler *frameProfiler() const;
+    inline bool isHudVisible() const;
 
-    /// Maximum allowed distance between mouse cursor and the dot
-    static const float CURSOR_DISTANCE_GAMEOVER = 30;   //10;
     /// Amount of time (seconds) for a timed game to last
-    static const uint GAME_LENGTH_DEFAULT_S = 10;
+    static const uint GAME_LENGTH_DEFAULT_S = GameSim::GAME_LENGTH_DEFAULT_S;
     /// length of time (in ms) between game stat updates
-    static const uint GAME_UPDATE_INTERVAL_MS = 80;
-    /// Number of samples to average in the Position Error Ratio
-    static const uint ERROR_AVERAGING_RATIO = 16;
-    /// initial errorDistance value.  Non-zero to quickly stabilize the averaging.
-    static const float RUNNING_AVERAGE_ERROR_DEFAULT = 3.0;
+    static const uint GAME_UPDATE_INTERVAL_MS = GameSim::GAME_UPDATE_INTERVAL_MS;
+    /// length of time (in ms) between frames, ~60Hz
+    static const uint FRAME_INTERVAL_MS = 16;
+    /// fixed simulation step, in ms.  Divides every dot speed exactly.
+    static const uint SIM_STEP_MS = 1;
+    /// Most simulation steps run in one frame; any time beyond is dropped.
+    static const uint MAX_CATCH_UP_STEPS = 250;
+    /// Simulation steps per frame when a replay is played at full speed
+    static const uint REPLAY_FULL_SPEED_STEPS = 1000;
 
 
 protected:
     virtual void paintEvent(QPaintEvent *event);
     virtual void mousePressEvent(QMouseEvent *event);
+    virtual void mouseMoveEvent(QMouseEvent *event);
     virtual void resizeEvent(QResizeEvent *event);
+    virtual bool eventFilter(QObject *watched, QEvent *event);
 private:
     void setScoreText(const uint newScore);
 
+    /// Queue a cursor position, in widget coordinates, for the game to score
+    void addCursorSample(const QPoint &cursorPos);
+
+    /// Area of the widget covered by the score text
+    QRect scoreTextRect() const;
+
+    /// Repaint all, or part, of the field: the widget or the scene item
+    void updateField();
+    void updateField(const QRect &rect);
+    /// The field changed size from oldSize: keep the Dot in it
+    void fieldResized(const QSize &oldSize);
+    /// Cursor shown over the field
+    void setFieldCursor(Qt::CursorShape shape);
+
     /// Pause the game by stopping dot position updates and game timers
     void pauseGame();
 
@@ -96,41 +177,46 @@ private:
     /// Reset all dotGame timers, averages, and m_scores
     void resetGameStats();
 
+    /// Report how the replay that just ended matched, close it, and go back to
+    /// the settings and arena of the live game
+    void endReplay();
+
+    /// Send gameState() to every view, and count the deliveries
+    void publishGameState();
+
     /* Private non-defined function prototypes disables compiler generation. */
     /// prevent copy operator
     DotWidget(const DotWidget&);
     /// prevent assignment operator
     DotWidget& operator=(const DotWidget&);
 
-    /// Dot object in this window widget
-    Dot* m_gameDotPtr;
+    /// Headless game rules: dot motion, error averaging, score, time limit
+    GameSim m_gameSim;
 
-    /// how many milliseconds between dot movements
-    uint m_dotSpeed;
+    /// Dot object in this window widget, drawing m_gameSim's dot
+    Dot* m_gameDotPtr;
 
     /// What did the user set their default speed to?
     uint m_dotSpeedUserSetting;
 
-    /// how fast the m_dotSpeed is increased
-    uint m_dotAcceleration;
-
-    /// Timer for Dot position updates (timer interval = speed)
-    QTimer m_dotTimer;
+    /// Seed requested for the next game, valid if m_nextGameSeedSet
+    quint64 m_nextGameSeed;
+    bool m_nextGameSeedSet;
 
-    /// Timer for when the Dot Speed increases
-    QTimer m_accelerationTimer;
+    /// The one game loop timer: each timeout runs the due simulation steps
+    QTimer m_frameTimer;
 
-    /// Timer for game stat calculations
-    QTimer m_gameStatsTimer;
+    /// Real time since the previous frame
+    QElapsedTimer m_frameClock;
 
-    /// for periodic update of the elapsed game time
-    QTimer m_secondTimerPtr;
+    /// Real time not yet simulated, in nanoseconds
+    qint64 m_stepAccumNs;
 
-    /// Total game time, excluding paused time.  Valid range <24hours due to QTime.
-    uint m_elapsedGameTime;
+    /// Frames this game that came more than a frame late, or had to drop time
+    uint m_missedDeadlines;
 
-    /// Requested Game Length, in seconds.  Up to 9 hours.
-    uint m_gameLength;
+    /// Real time this game that was not simulated because the loop fell too far behind
+    uint m_droppedSimTimeMs;
 
     /// Current state of the game
     dotGameState m_gameState;
@@ -138,15 +224,17 @@ private:
     /// why did the last game end?
     gameOverReason m_lastGameOverReason;
 
-    /// Running average of error ratio/distance
-    float m_runningAvgErrorRatio;
-
-    /// Cumulative game m_score
-    float m_score;
-
     /// Game m_score as a string
     static const size_t SCORE_STRING_LENGTH = 32;
-    char m_scoreString[SCORE_STRING_LENGTH];
+    CachedText m_scoreText;
+
+    /// Fixed game state labels, laid out once
+    CachedText m_pausedText;
+    CachedText m_clickToResumeText;
+    CachedText m_followTheDotText;
+    CachedText m_beatTheClockText;
+    CachedText m_gameOverText;
+    CachedText m_clickForNewGameText;
 
     /// Background color
     QBrush m_backgroundBrush;
@@ -157,26 +245,80 @@ private:
     /// font for main text
     QFont m_textFontLarge;
 
+    /// Where the Dot was last drawn, to be erased when it moves
+    QRect m_lastDotRect;
+
+    /// Pixels repainted since m_paintStatsClock was started
+    qint64 m_paintedPixels;
+
+    /// Start of the current painted-pixels measuring interval
+    QElapsedTimer m_paintStatsClock;
+
+    /// Pixels repainted per second, over the last full interval
+    uint m_paintedPixelsPerSecond;
+
+    /// Stat updates so far this game, for GameStateSnapshot::statUpdates
+    uint m_statUpdates;
+
+    /// newGameState() deliveries (one per connected slot) since m_deliveriesClock started
+    uint m_signalDeliveries;
+    QElapsedTimer m_deliveriesClock;
+    /// Deliveries per second, over the last full interval
+    uint m_signalDeliveriesPerSecond;
+
+    /// Latency instrumentation, NULL unless enabled
+    LatencyMonitor *m_latencyMonitorPtr;
+
+    /// Per-frame timing; only collects while the overlay is visible
+    FrameProfiler *m_frameProfilerPtr;
+
+    /// Performance overlay
+    PerfHud m_perfHud;
+
+    /// Recording of the current game, saved when it ends
+    ReplayWriter m_replayWriter;
+
+    /// Replay being played, and its memory-mapped file; NULL when not replaying
+    ReplayPlayer *m_replayPlayerPtr;
+    QFile *m_replayFilePtr;
+
+    /// Run the replay as fast as possible, rather than in real time
+    bool m_replayFullSpeed;
+
+    /// Settings from before the replay, which endReplay() puts back
+    ReplayConfig m_liveSettings;
+    uint m_liveDotSpeedUserSetting;
+
+    /// Scene item the field is drawn in, or NULL to draw this widget
+    QGraphicsItem *m_fieldItemPtr;
+
 signals:
-    /// A new ratio has been calculated = (cursor to dot distance / movement distance)
-    void newFollowDistanceRatio(const float errorDistRatio, const uint m_elapsedGameTime) const;
+    /// The game changed this frame; sent at most once per frame
+    void newGameState(const GameStateSnapshot &state) const;
     /// A new Dot update rate has been set.
     void newDotSpeedNeg(const int m_dotSpeedNeg) const;
     /// The Dot Game has ended, due to the reason included.
     void gameOver(const gameOverReason reason) const;
-    void newDotLoc(const QVariant) const;
+    /// A game was played to its end; its replay, to be saved
+    void replayRecorded(const QByteArray &replay) const;
+    /// A replay has ended; it matched its recording if mismatches is 0
+    void replayChecked(const QString &fileName, uint mismatches,
+                       float replayedScore, float recordedScore) const;
 public slots:
     bool setDotSize(const int newSize);
     bool setDotSpeedNeg(const int newSpeedMs);
     void setDotAcceleration(const int newAcceleration);
-    void increaseDotSpeed();
-    void calcGameStats();
     bool setTimeLimit(const int timeLimit);
-    void updateElapsedGameTime();
+    void runFrame();
     void startGame();
     void setGameOver(const gameOverReason &reason);
     void setBackgroundColor(const int newHSVcolor);
-    void newDotPosQpnt(const QPoint loc) const;
+    void updateDotRegion(const QPoint loc);
+    /// Show or hide the performance overlay
+    void setHudVisible(bool visible);
+    void toggleHud();
+    /// Draw the Dot in the next skin
+    void cycleDotSkin();
     void screenClicked();
 };
 
@@ -187,7 +329,7 @@ public slots:
 *******************************************************************************/
 inline uint DotWidget::getDotSpeed() const
 {
-    return m_dotSpeed;
+    return m_gameSim.getDotSpeed();
 }
 /** ****************************************************************************
  * Function: getGameState()
@@ -203,7 +345,7 @@ inline dotGameState DotWidget::getGameState() const
 *******************************************************************************/
 inline float DotWidget::getErrorRatio() const
 {
-    return m_runningAvgErrorRatio;
+    return m_gameSim.getErrorRatio();
 }
 /** ****************************************************************************
  * Function: getScore()
@@ -211,7 +353,7 @@ inline float DotWidget::getErrorRatio() const
 *******************************************************************************/
 inline uint DotWidget::getScore() const
 {
-    return static_cast<uint>(m_score);
+    return static_cast<uint>(m_gameSim.getScore());
 }
 /** ****************************************************************************
  * Function: getElapsedTime()
@@ -219,7 +361,74 @@ inline uint DotWidget::getScore() const
 *******************************************************************************/
 inline uint DotWidget::getElapsedTime() const
 {
-    return m_elapsedGameTime;
+    return m_gameSim.getElapsedTime();
+}
+/** ****************************************************************************
+ * Function: getGameSeed()
+ *      Seed of the current (or last) game's dot motion.
+*******************************************************************************/
+inline quint64 DotWidget::getGameSeed() const
+{
+    return m_gameSim.getGameSeed();
+}
+/** ****************************************************************************
+ * Function: getMissedDeadlines()
+ *      How many frames were late in the current (or last) game, pauses
+ *      included?  Shown in the performance overlay.
+*******************************************************************************/
+inline uint DotWidget::getMissedDeadlines() const
+{
+    return m_missedDeadlines;
+}
+/** ****************************************************************************
+ * Function: getDroppedSimTimeMs()
+ *      How much game time was skipped in the current (or last) game because
+ *      the loop fell behind?
+*******************************************************************************/
+inline uint DotWidget::getDroppedSimTimeMs() const
+{
+    return m_droppedSimTimeMs;
+}
+/** ****************************************************************************
+ * Function: isReplaying()
+ *      Is a recorded game being played, rather than the user's?
+*******************************************************************************/
+inline bool DotWidget::isReplaying() const
+{
+    return m_replayPlayerPtr != NULL;
+}
+/** ****************************************************************************
+ * Function: frameProfiler()
+ *
+*******************************************************************************/
+inline FrameProfiler *DotWidget::frameProfiler() const
+{
+    return m_frameProfilerPtr;
+}
+/** ****************************************************************************
+ * Function: isHudVisible()
+ *
+*******************************************************************************/
+inline bool DotWidget::isHudVisible() const
+{
+    return m_frameProfilerPtr->isEnabled();
+}
+/** ****************************************************************************
+ * Function: getPaintedPixelsPerSecond()
+ *      How many pixels did paintEvent() repaint per second, last second?
+*******************************************************************************/
+inline uint DotWidget::getPaintedPixelsPerSecond() const
+{
+    return m_paintedPixelsPerSecond;
+}
+/** ****************************************************************************
+ * Function: getSignalDeliveriesPerSecond()
+ *      How many slots did newGameState() reach per second, last second?
+ *      Follows the frame rate and the number of views, not the game speed.
+*******************************************************************************/
+inline uint DotWidget::getSignalDeliveriesPerSecond() const
+{
+    return m_signalDeliveriesPerSecond;
 }
 /** ****************************************************************************
  * Function: getDotSize()
@@ -229,6 +438,23 @@ inline uint DotWidget::getDotSize() const
 {
     return m_gameDotPtr->getDotSize();
 }
+/** ****************************************************************************
+ * Function: getDotSkin()
+ *      How is the Dot drawn?
+*******************************************************************************/
+inline dotSkin DotWidget::getDotSkin() const
+{
+    return m_gameDotPtr->getSkin();
+}
+/** ****************************************************************************
+ * Function: getDotSprite()
+ *      The Dot as it is drawn now, for a view that draws it elsewhere.  Its
+ *      center pixel is at (width/2, height/2).
+*******************************************************************************/
+inline const QPixmap &DotWidget::getDotSprite() const
+{
+    return m_gameDotPtr->sprite();
+}
 
 #endif // DOTWIDGET_H
 
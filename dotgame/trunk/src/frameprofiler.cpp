@@ -0,0 +1,231 @@
+/** ****************************************************************************
+ * @file frameprofiler.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The FrameProfiler splits every game frame into the time spent in dot motion,
+ * game stats, painting the DotWidget, the status bar and the QML view, and
+ * the rest (event loop idle).  It keeps the last frames for rolling
+ * percentiles and a longer history for export as CSV.
+ *
+ ******************************************************************************/
+
+#include "frameprofiler.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QEvent>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtGui/QWidget>
+#include <algorithm>          // for std::nth_element()
+#include <vector>
+#include <string.h>           // for memset()
+
+const char *const FrameProfiler::SECTION_NAMES[SECTION_COUNT] = {
+    "sim", "stats", "paint_dot", "paint_status", "paint_qml", "idle", "frame"
+};
+
+/** ****************************************************************************
+ * FrameProfiler Constructor
+ *  @param parent Owner of the profiler.
+*******************************************************************************/
+FrameProfiler::FrameProfiler(QObject *parent) :
+    QObject(parent), m_enabled(false), m_frameStartNs(-1), m_phaseStartNs(0),
+    m_dispatchingPtr(NULL)
+{
+    memset(m_frameNs, 0, sizeof(m_frameNs));
+    m_clock.start();
+}
+
+/** ****************************************************************************
+ * Function: watchPaint()
+ *   @param widgetPtr Widget to time; for a QGraphicsView, its viewport().
+ *   @param section One of the SECTION_PAINT_... sections.
+*******************************************************************************/
+void FrameProfiler::watchPaint(QWidget *widgetPtr, frameSection section)
+{
+    m_watchedPtrs.append(widgetPtr);
+    m_watchedSections.append(section);
+    widgetPtr->installEventFilter(this);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setEnabled()
+ *   Collection starts with a fresh frame; the history is kept.
+*******************************************************************************/
+void FrameProfiler::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    discardFrame();
+    return;
+}
+
+/** ****************************************************************************
+ * Function: beginFrame()
+ *   Idle is what is left of the frame after all timed sections.
+*******************************************************************************/
+void FrameProfiler::beginFrame()
+{
+    if (!m_enabled)
+    {
+        return;
+    }
+    const qint64 NSEC_IN_USEC = 1000;
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    if (m_frameStartNs >= 0)
+    {
+        FrameTiming frame;
+        qint64 busyNs = 0;
+        for (int section = 0; section < SECTION_IDLE; ++section)
+        {
+            frame.us[section] = m_frameNs[section] / NSEC_IN_USEC;
+            busyNs += m_frameNs[section];
+        }
+        const qint64 frameNs = nowNs - m_frameStartNs;
+        frame.us[SECTION_FRAME] = frameNs / NSEC_IN_USEC;
+        frame.us[SECTION_IDLE] = (frameNs > busyNs) ? (frameNs - busyNs) / NSEC_IN_USEC : 0;
+        if (m_history.size() >= HISTORY_FRAMES_MAX)
+        {
+            m_history.remove(0, HISTORY_FRAMES_MAX / 10);   // now and then, not every frame
+        }
+        m_history.append(frame);
+    }
+    m_frameStartNs = nowNs;
+    memset(m_frameNs, 0, sizeof(m_frameNs));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: discardFrame()
+ *
+*******************************************************************************/
+void FrameProfiler::discardFrame()
+{
+    m_frameStartNs = -1;
+    memset(m_frameNs, 0, sizeof(m_frameNs));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: beginPhase()
+ *   GameSim phases don't nest, so one start time is enough.
+*******************************************************************************/
+void FrameProfiler::beginPhase(stepPhase phase)
+{
+    Q_UNUSED(phase);
+    m_phaseStartNs = m_clock.nsecsElapsed();
+    return;
+}
+
+/** ****************************************************************************
+ * Function: endPhase()
+ *
+*******************************************************************************/
+void FrameProfiler::endPhase(stepPhase phase)
+{
+    const frameSection section = (phase == MOTION) ? SECTION_SIM : SECTION_STATS;
+    m_frameNs[section] += m_clock.nsecsElapsed() - m_phaseStartNs;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: eventFilter() reimplemented from QObject
+ *   A filter only sees an event before it is handled, so to time a paint the
+ *   filter delivers it itself: sendEvent() runs the remaining filters (e.g. the
+ *   QGraphicsView's own viewport filter) and the widget's handler, and the
+ *   event is then reported as handled.
+*******************************************************************************/
+bool FrameProfiler::eventFilter(QObject *watched, QEvent *event)
+{
+    if (!m_enabled || (event->type() != QEvent::Paint) || (watched == m_dispatchingPtr))
+    {
+        return QObject::eventFilter(watched, event);
+    }
+    const int watchedIndex = m_watchedPtrs.indexOf(static_cast<QWidget*>(watched));
+    if (watchedIndex < 0)
+    {
+        return QObject::eventFilter(watched, event);
+    }
+    QObject *outerDispatchingPtr = m_dispatchingPtr;
+    m_dispatchingPtr = watched;
+    const qint64 startNs = m_clock.nsecsElapsed();
+    QCoreApplication::sendEvent(watched, event);
+    m_frameNs[m_watchedSections[watchedIndex]] += m_clock.nsecsElapsed() - startNs;
+    m_dispatchingPtr = outerDispatchingPtr;
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: recentFrames()
+ *
+*******************************************************************************/
+QVector<FrameTiming> FrameProfiler::recentFrames() const
+{
+    const int first = qMax(0, m_history.size() - ROLLING_FRAMES);
+    return m_history.mid(first);
+}
+
+/** ****************************************************************************
+ * Function: percentile()
+ *   @param section Section to look at.
+ *   @param percent 0.0 to 100.0, e.g. 95.0 for the p95.
+ *   @return microseconds, or 0 if no frames have been recorded.
+*******************************************************************************/
+qint64 FrameProfiler::percentile(frameSection section, double percent) const
+{
+    const int first = qMax(0, m_history.size() - ROLLING_FRAMES);
+    std::vector<qint64> values;
+    values.reserve(m_history.size() - first);
+    for (int index = first; index < m_history.size(); ++index)
+    {
+        values.push_back(m_history[index].us[section]);
+    }
+    if (values.empty())
+    {
+        return 0;
+    }
+    size_t rank = static_cast<size_t>((percent / 100.0) * (values.size() - 1) + 0.5);
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+/** ****************************************************************************
+ * Function: writeCsv()
+ *   One header line with the section names, then one line per frame, in us.
+ *   @return false if the file could not be written.
+*******************************************************************************/
+bool FrameProfiler::writeCsv(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        qDebug("FrameProfiler::writeCsv: Can't open %s", qPrintable(fileName));
+        return false;
+    }
+    QTextStream csvStream(&file);
+    csvStream << "frame";
+    for (int section = 0; section < SECTION_COUNT; ++section)
+    {
+        csvStream << "," << SECTION_NAMES[section] << "_us";
+    }
+    csvStream << "\n";
+    for (int frameNum = 0; frameNum < m_history.size(); ++frameNum)
+    {
+        csvStream << frameNum;
+        for (int section = 0; section < SECTION_COUNT; ++section)
+        {
+            csvStream << "," << m_history[frameNum].us[section];
+        }
+        csvStream << "\n";
+    }
+    return true;
+}
@@ -0,0 +1,141 @@
+/** ****************************************************************************
+ * @file frameprofiler.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The FrameProfiler splits every game frame into the time spent in dot motion,
+ * game stats, painting the DotWidget, the status bar and the QML view, and
+ * the rest (event loop idle).  It keeps the last frames for rolling
+ * percentiles and a longer history for export as CSV.
+ *
+ ******************************************************************************/
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QVector>
+#include <QtCore/QString>
+#include "gamesim.h"          // for StepProfiler
+
+class QWidget;
+
+/// Parts of a frame that are timed.
+enum frameSection {
+    SECTION_SIM = 0,        ///< dot motion, in GameSim::step()
+    SECTION_STATS,          ///< cursor error and score, in GameSim::step()
+    SECTION_PAINT_DOT,      ///< DotWidget::paintEvent()
+    SECTION_PAINT_STATUS,   ///< status bar paintEvent()
+    SECTION_PAINT_QML,      ///< QML view paint
+    SECTION_IDLE,           ///< the rest of the frame
+    SECTION_FRAME,          ///< the whole frame, start to start
+    SECTION_COUNT
+};
+
+/** @struct FrameTiming
+ *    Microseconds spent in each section of one frame. */
+struct FrameTiming {
+    qint64 us[SECTION_COUNT];
+};
+
+/** ****************************************************************************
+ * @class FrameProfiler
+ *   Collects one FrameTiming per game frame.  GameSim reports its phases
+ *   through the StepProfiler interface; paints are timed by an event filter on
+ *   each watched widget.
+*******************************************************************************/
+class FrameProfiler : public QObject, public StepProfiler
+{
+    Q_OBJECT
+public:
+    explicit FrameProfiler(QObject *parent = 0);
+
+    /// Time the paint events of a widget as one of the paint sections
+    void watchPaint(QWidget *widgetPtr, frameSection section);
+    /// Start or stop collecting
+    void setEnabled(bool enabled);
+    inline bool isEnabled() const;
+
+    /// A new game frame starts: close the previous one
+    void beginFrame();
+    /// Forget the frame in progress, e.g. after a pause
+    void discardFrame();
+
+    // StepProfiler
+    virtual void beginPhase(stepPhase phase);
+    virtual void endPhase(stepPhase phase);
+
+    /// Recent frames, oldest first (at most ROLLING_FRAMES)
+    QVector<FrameTiming> recentFrames() const;
+    /// Microseconds that 'percent' of the recent frames spent at most in a section
+    qint64 percentile(frameSection section, double percent) const;
+    /// Write the history, one frame per line, as CSV
+    bool writeCsv(const QString &fileName) const;
+    inline int historySize() const;
+
+    /// Frames in the rolling window, ~4 seconds at 60 Hz
+    static const int ROLLING_FRAMES = 240;
+    /// Frames kept for CSV export, ~10 minutes at 60 Hz
+    static const int HISTORY_FRAMES_MAX = 36000;
+
+    /// Column names, as used in the CSV header
+    static const char *const SECTION_NAMES[SECTION_COUNT];
+
+protected:
+    virtual bool eventFilter(QObject *watched, QEvent *event);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    FrameProfiler(const FrameProfiler&);
+    /// prevent assignment operator
+    FrameProfiler& operator=(const FrameProfiler&);
+
+    /// false: nothing is timed
+    bool m_enabled;
+    /// time base of all measurements
+    QElapsedTimer m_clock;
+    /// start of the frame in progress, in ns on m_clock; -1 if none
+    qint64 m_frameStartNs;
+    /// time spent per section in the frame in progress, in ns
+    qint64 m_frameNs[SECTION_COUNT];
+    /// start of the GameSim phase in progress
+    qint64 m_phaseStartNs;
+    /// widgets whose paint is timed, and their sections
+    QVector<QWidget*> m_watchedPtrs;
+    QVector<frameSection> m_watchedSections;
+    /// widget whose paint event is being dispatched by eventFilter(), if any
+    QObject *m_dispatchingPtr;
+    /// completed frames, oldest first; trimmed to HISTORY_FRAMES_MAX
+    QVector<FrameTiming> m_history;
+};
+
+
+/** ****************************************************************************
+ * Function: isEnabled()
+ *
+*******************************************************************************/
+inline bool FrameProfiler::isEnabled() const
+{
+    return m_enabled;
+}
+/** ****************************************************************************
+ * Function: historySize()
+ *   How many frames would writeCsv() write?
+*******************************************************************************/
+inline int FrameProfiler::historySize() const
+{
+    return m_history.size();
+}
+
+#endif // FRAMEPROFILER_H
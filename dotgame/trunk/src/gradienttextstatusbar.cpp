@@ -16,32 +16,49 @@
  * two bits of text (left and right) along with a color gradient that appears
  * like a line.  The gradient is shifted left and right to indicate status.
  * This widget is intended to be placed in the Status Bar area of the MainWindow.
+ * The fade is a cached strip, and the distance history a Sparkline; see
+ * gradienttextstatusbar.h.
  *
  ******************************************************************************/
 
 #include "gradienttextstatusbar.h"
+#include "gamesim.h"
 #include <QtCore/QString>
 #include <stdio.h>             // for snprintf()
 
+/// Points defining the width and direction of the fade, around the bar position
+static const QPoint GRAD_TOP_LEFT(-15,-10);
+static const QPoint GRAD_BOTTOM_RIGHT(15,10);
+/// Beyond this far right of the bar position the fade is fully black
+static const int SHADE_STRIP_AFTER = 40;
+/// A minute of distances, at one per game stats update
+static const int DIST_HISTORY_SAMPLES = 60000 / GameSim::GAME_UPDATE_INTERVAL_MS;
+/// Top of the history graph, as in updateValues(); the game-over line is at 1.0
+static const float DIST_HISTORY_MAX = 1.1f;
+
 /** ****************************************************************************
  * GradientTextStatusBar Constructor
  *   @param parent Pointer to the parent window widget
  ******************************************************************************/
 GradientTextStatusBar::GradientTextStatusBar(QWidget *parent) :
     QWidget(parent),
-    statusBarGradient(40, 0, 70, 10),
-    distString("0.00"),
-    timeString("GameTime: 0"),
-    checkedErrorDistRatio(0.0)
+    m_barColor(Qt::green),
+    distText("0.00", font()),
+    timeText("GameTime: 0", font()),
+    m_distPercent(-1), m_distWarning(-1), m_elapsedTime(-1),
+    m_distHistory(DIST_HISTORY_SAMPLES)
 {
-    statusBarGradient.setColorAt(0.0, Qt::green);
-    statusBarGradient.setColorAt(1.0, Qt::black);
+    m_repaintTimer.setSingleShot(true);
+    QObject::connect(&m_repaintTimer, SIGNAL(timeout()), this, SLOT(update()));
     updateValues(0.0, 0);
+    m_distHistory.clear();      // not a game value
 }
 
 /** ****************************************************************************
  * Function: updateValues()
- *    Update the gradient positioning and printed text.
+ *    Update the gradient positioning and printed text, and add the distance
+ *    to the history.  Nothing is repainted unless the shown percentage,
+ *    warning, time or history changes.  Time going back starts a new history.
  *    @param errorDistRatio Ratio of current distance to the max,
  *          so ideally 0.0<ratio<1.0 although it may exceed 1.0 when the game ends.
  *    @param elapsedTime The number of seconds that the game has been running, minus any game pauses.
@@ -51,7 +68,7 @@ GradientTextStatusBar::GradientTextStatusBar(QWidget *parent) :
 void GradientTextStatusBar::updateValues(const float errorDistRatio, const int elapsedTime)
 {
     //qDebug("GradientTextStatusBar::updateValue: runAverage=%.2f", errorDistRatio);
-    checkedErrorDistRatio = errorDistRatio;
+    float checkedErrorDistRatio = errorDistRatio;
     if (checkedErrorDistRatio > 1.1)  // higher than 1.0 to make sure it overdraws the gradient.
     {
         checkedErrorDistRatio = 1.1;
@@ -60,46 +77,113 @@ void GradientTextStatusBar::updateValues(const float errorDistRatio, const int e
     {
         checkedErrorDistRatio = 0.0;
     }
-
-    /* Sliding Gradient bar must be recalculated in 'paintEvent' instead of
-     *   here so that it adjusts when the window is resized. */
-
-    // adjust the color of the bar to be more green for low distances and redder for larger ratios
-    const uint GOOD_COLOR_HSV = 130; // ~Green
-    const uint BAD_COLOR_HSV = 0;  // ~Red
-    int errorDistColorHsv = GOOD_COLOR_HSV -
-            ((GOOD_COLOR_HSV - BAD_COLOR_HSV)*checkedErrorDistRatio);
-    if (errorDistColorHsv < 0)
+    const int distPercent = qRound(100 * checkedErrorDistRatio);
+    const int distWarning = (checkedErrorDistRatio > 1.0) ? 2 : ((checkedErrorDistRatio > 0.6) ? 1 : 0);
+    if (elapsedTime < m_elapsedTime)
+    {
+        m_distHistory.clear();      // a new game
+    }
+    const bool historyChanged = m_distHistory.append(checkedErrorDistRatio);
+    if ((distPercent == m_distPercent) && (distWarning == m_distWarning) &&
+        (elapsedTime == m_elapsedTime) && !historyChanged)
     {
-        errorDistColorHsv = 0;
+        return;     // would look the same
     }
-    QColor tempHSV;
-    tempHSV.setHsv(errorDistColorHsv,255,150);
-    statusBarGradient.setColorAt(0.0,tempHSV);
 
-    // Update the display text.
     const size_t TEMP_TEXT_SIZE = 32;
     char tempText[TEMP_TEXT_SIZE];
-    if (checkedErrorDistRatio > 1.0)
+    if ((distPercent != m_distPercent) || (distWarning != m_distWarning))
+    {
+        m_distPercent = distPercent;
+        m_distWarning = distWarning;
+
+        // adjust the color of the bar to be more green for low distances and redder for larger ratios
+        const int GOOD_COLOR_HSV = 130; // ~Green
+        const int BAD_COLOR_HSV = 0;  // ~Red
+        int errorDistColorHsv = GOOD_COLOR_HSV -
+                ((GOOD_COLOR_HSV - BAD_COLOR_HSV)*distPercent)/100;
+        if (errorDistColorHsv < 0)
+        {
+            errorDistColorHsv = 0;
+        }
+        m_barColor.setHsv(errorDistColorHsv,255,150);
+
+        // Update the display text.
+        if (distWarning == 2)
+        {
+            snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %i%%  Too Far!!", distPercent);
+        }
+        else if (distWarning == 1)
+        {
+            snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %i%%  Careful!", distPercent);
+        }
+        else
+        {
+            snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %i%%", distPercent);
+        }
+        distText.setText(tempText);     // laid out again only if it changed
+    }
+    if (elapsedTime != m_elapsedTime)
     {
-        snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %0.0f%%  Too Far!!", (100*checkedErrorDistRatio));
+        m_elapsedTime = elapsedTime;
+        snprintf(tempText, TEMP_TEXT_SIZE, "GameTime: %i  ", elapsedTime);
+        timeText.setText(tempText);
     }
-    else if (checkedErrorDistRatio > 0.6)
+
+    scheduleRepaint();     // redraw the status bar, via paintEvent()
+
+    return;
+} // function updateValues
+
+/** ****************************************************************************
+ * Function: scheduleRepaint()
+ *   Values arriving faster than the display refreshes are shown together
+ *   in the next frame's paint.  The last values are always shown.
+*******************************************************************************/
+void GradientTextStatusBar::scheduleRepaint()
+{
+    if (!m_sinceRepaint.isValid() || (m_sinceRepaint.elapsed() >= MIN_REPAINT_INTERVAL_MS))
     {
-        snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %0.0f%%  Careful!", (100*checkedErrorDistRatio));
+        update();
     }
-    else
+    else if (!m_repaintTimer.isActive())
     {
-        snprintf(tempText, TEMP_TEXT_SIZE, "  Dist: %0.0f%%", (100*checkedErrorDistRatio));
+        m_repaintTimer.start(MIN_REPAINT_INTERVAL_MS - int(m_sinceRepaint.elapsed()));
     }
-    distString = tempText;
-    snprintf(tempText, TEMP_TEXT_SIZE, "GameTime: %i  ", elapsedTime);
-    timeString = tempText;
+    return;
+}
 
-    update();     // redraw the status bar, via paintEvent()
+/** ****************************************************************************
+ * Function: renderShadeStrip()
+ *   The fade of the original diagonal gradient, from transparent to black.
+ *   Drawn over the bar color, it gives the same pixels as the gradient from
+ *   the bar color to black.  Its left edge is far enough left of the bar
+ *   position that the fade hasn't started there in any row.
+*******************************************************************************/
+void GradientTextStatusBar::renderShadeStrip()
+{
+    const int stripBefore = GRAD_BOTTOM_RIGHT.x() + height() + GRAD_BOTTOM_RIGHT.y();
+    m_shadeStrip = QPixmap(stripBefore + SHADE_STRIP_AFTER, height());
+    m_shadeStrip.fill(Qt::transparent);
+    QLinearGradient shadeGradient(QPointF(stripBefore + GRAD_TOP_LEFT.x(), GRAD_TOP_LEFT.y()),
+                                  QPointF(stripBefore + GRAD_BOTTOM_RIGHT.x(), GRAD_BOTTOM_RIGHT.y()));
+    shadeGradient.setColorAt(0.0, QColor(0, 0, 0, 0));
+    shadeGradient.setColorAt(1.0, QColor(0, 0, 0, 255));
+    QPainter painter(&m_shadeStrip);
+    painter.fillRect(m_shadeStrip.rect(), QBrush(shadeGradient));
+    return;
+}
 
+/** ****************************************************************************
+ * Function: resizeEvent()
+ *   The history keeps one column per pixel of its width.
+*******************************************************************************/
+void GradientTextStatusBar::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    m_distHistory.setColumns(qMin(SPARKLINE_WIDTH, width()));
     return;
-} // function updateValues
+}
 
 /** ****************************************************************************
  * Function: paintEvent()
@@ -109,23 +193,42 @@ void GradientTextStatusBar::updateValues(const float errorDistRatio, const int e
 void GradientTextStatusBar::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
-    // slide the gradient back and forth along the bar
-    const QPoint GRAD_TOP_LEFT(-15,-10);     // points defining the width, initial position of the color gradient
-    const QPoint GRAD_BOTTOM_RIGHT(15,10);
-    QPointF stopPos((checkedErrorDistRatio * size().width()) + GRAD_BOTTOM_RIGHT.x(),
-                    GRAD_BOTTOM_RIGHT.y());
-    QPointF startPos = stopPos + QPoint(GRAD_TOP_LEFT.x() - GRAD_BOTTOM_RIGHT.x(),
-                                        GRAD_TOP_LEFT.y() - GRAD_BOTTOM_RIGHT.y());
-    statusBarGradient.setStart(startPos);
-    statusBarGradient.setFinalStop(stopPos);
+    m_sinceRepaint.start();
+    if (m_shadeStrip.height() != height())
+    {
+        renderShadeStrip();     // only when the height changes
+    }
+    // the bar, then the history at the right
+    const int barWidth = qMax(0, width() - SPARKLINE_WIDTH);
+    const QRect barRect(0, 0, barWidth, height());
+    const QRect historyRect(barWidth, 0, width() - barWidth, height());
+
+    // slide the fade back and forth along the bar: color, fade, then black
+    const int stripBefore = m_shadeStrip.width() - SHADE_STRIP_AFTER;
+    const int stripLeft = (m_distPercent * barWidth) / 100 - stripBefore;
+    const int stripRight = stripLeft + m_shadeStrip.width();
 
     // paint all of the status bar components
     QPainter painter(this);
-    painter.fillRect(rect(), QBrush(statusBarGradient)); // Paint over the whole area
+    painter.fillRect(QRect(0, 0, qMax(0, stripRight), height()), m_barColor);
+    painter.drawPixmap(stripLeft, 0, m_shadeStrip);
+    painter.fillRect(QRect(qMax(0, stripRight), 0, qMax(0, width() - stripRight), height()), Qt::black);
     painter.setRenderHint(QPainter::Antialiasing);
     painter.setPen(QPen(Qt::black));
-    painter.drawText(rect(), Qt::AlignVCenter, distString);
+    distText.setFont(font());       // follows the widget font, no layout if unchanged
+    timeText.setFont(font());
+    distText.draw(&painter, rect(), Qt::AlignVCenter);
     painter.setPen(QPen(Qt::white));
-    painter.drawText(rect(), (Qt::AlignVCenter | Qt::AlignRight), timeString);
+    timeText.draw(&painter, barRect, (Qt::AlignVCenter | Qt::AlignRight));
+
+    // the history over black, with the game-over distance as a dark line
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.fillRect(historyRect, Qt::black);   // covers the bar when it is past 100%
+    const int gameOverY = historyRect.bottom() -
+            int((historyRect.height() - 1) / DIST_HISTORY_MAX);
+    painter.setPen(QPen(Qt::darkRed));
+    painter.drawLine(historyRect.left(), gameOverY, historyRect.right(), gameOverY);
+    painter.setPen(QPen(Qt::lightGray));
+    m_distHistory.draw(&painter, historyRect, DIST_HISTORY_MAX);
     return;
 }
@@ -17,6 +17,13 @@
  * like a line.  The gradient is shifted left and right to indicate status.
  * This widget is intended to be placed in the Status Bar area of the MainWindow.
  *
+ * The gradient's fade to black is rendered once into a strip, and each paint
+ * only blits it at the new position between two solid fills.  Values that
+ * wouldn't change what is shown don't cause a repaint, and repaints are
+ * spaced at least a display frame apart.
+ *
+ * At the right, a Sparkline shows the distance over the last minute of the game.
+ *
  ******************************************************************************/
 
 #ifndef GRADIENTTEXTSTATUSBAR_H
@@ -25,6 +32,11 @@
 #include <QtGui/QWidget>
 #include <QtGui/QPainter>
 #include <QtGui/QLabel>
+#include <QtGui/QPixmap>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
+#include "cachedtext.h"
+#include "sparkline.h"
 
 /** ****************************************************************************
  * @class GradientTextStatusBar
@@ -38,8 +50,14 @@ class GradientTextStatusBar : public QWidget
     Q_OBJECT
 public:
     explicit GradientTextStatusBar(QWidget *parent = 0);
+
+    /// Shortest time between repaints: one frame of a 60 Hz display
+    static const int MIN_REPAINT_INTERVAL_MS = 16;
+    /// Width of the distance history at the right of the bar
+    static const int SPARKLINE_WIDTH = 120;
 protected:
     virtual void paintEvent(QPaintEvent *event);
+    virtual void resizeEvent(QResizeEvent *event);
 private:
     /* Private non-defined function prototypes disables compiler generation. */
     /// prevent copy operator
@@ -47,10 +65,28 @@ private:
     /// prevent assignment operator
     GradientTextStatusBar& operator=(const GradientTextStatusBar&);
 
-    QLinearGradient statusBarGradient;
-    QString distString;
-    QString timeString;
-    float checkedErrorDistRatio;
+    /// Render m_shadeStrip for the current height
+    void renderShadeStrip();
+    /// Repaint now, or once MIN_REPAINT_INTERVAL_MS has passed since the last paint
+    void scheduleRepaint();
+
+    /// The fade from the bar color to black: black with an alpha ramp
+    QPixmap m_shadeStrip;
+    /// Solid color left of the fade; follows the distance
+    QColor m_barColor;
+    CachedText distText;
+    CachedText timeText;
+    /// Shown distance, in percent of the game-over distance; also places the fade
+    int m_distPercent;
+    /// Shown warning: 0 none, 1 careful, 2 too far
+    int m_distWarning;
+    /// Shown game time, in seconds
+    int m_elapsedTime;
+    /// Distance history, one value per updateValues()
+    Sparkline m_distHistory;
+    /// Time since the last paint, and the repaint put off to respect it
+    QElapsedTimer m_sinceRepaint;
+    QTimer m_repaintTimer;
 signals:
     
 public slots:
@@ -0,0 +1,194 @@
+/** ****************************************************************************
+ * @file latencymonitor.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The LatencyMonitor measures how long it takes from a mouse move to the dot
+ * being on screen.  The DotWidget marks each stage: the input event, the
+ * simulation frame that consumes it, the end of paintEvent(), and the return
+ * to the event loop after the backing store has been flushed.  The time
+ * between stages is kept in one LatencyHistogram per stage.
+ *
+ ******************************************************************************/
+
+#include "latencymonitor.h"
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QDateTime>
+#include <stdio.h>            // for snprintf()
+
+/** ****************************************************************************
+ * LatencyMonitor Constructor
+ *  @param parent Owner of the monitor.
+*******************************************************************************/
+LatencyMonitor::LatencyMonitor(QObject *parent) :
+    QObject(parent), m_inputNs(-1), m_updateNs(-1), m_paintNs(-1),
+    m_updateInputNs(-1), m_paintInputNs(-1)
+{
+    m_clock.start();
+}
+
+/** ****************************************************************************
+ * Function: markInput()
+ *
+*******************************************************************************/
+void LatencyMonitor::markInput()
+{
+    if (m_inputNs < 0)
+    {
+        m_inputNs = m_clock.nsecsElapsed();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: markUpdate()
+ *   Every game frame consumes the input received before it.  Only a frame
+ *   that changes the picture (the dot moved) starts the paint stages.
+ *   @param dotMoved true if the frame moved the dot, so it will be repainted.
+*******************************************************************************/
+void LatencyMonitor::markUpdate(bool dotMoved)
+{
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    if (m_inputNs >= 0)
+    {
+        m_histograms[INPUT_TO_UPDATE].record(usSince(m_inputNs));
+        if (m_updateInputNs < 0)
+        {
+            m_updateInputNs = m_inputNs;
+        }
+        m_inputNs = -1;
+    }
+    if (dotMoved && (m_updateNs < 0))
+    {
+        m_updateNs = nowNs;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: markPaintDone()
+ *   The flush to the screen happens after paintEvent() returns, before the
+ *   event loop runs again, so a zero timer marks the end of the flush.
+*******************************************************************************/
+void LatencyMonitor::markPaintDone()
+{
+    if (m_updateNs < 0)
+    {
+        return;     // not a game frame, e.g. an expose
+    }
+    m_histograms[UPDATE_TO_PAINT].record(usSince(m_updateNs));
+    m_updateNs = -1;
+    if (m_paintNs < 0)
+    {
+        m_paintNs = m_clock.nsecsElapsed();
+        m_paintInputNs = m_updateInputNs;
+        QTimer::singleShot(0, this, SLOT(markFlushed()));
+    }
+    m_updateInputNs = -1;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: markFlushed()
+ *
+*******************************************************************************/
+void LatencyMonitor::markFlushed()
+{
+    if (m_paintNs >= 0)
+    {
+        m_histograms[PAINT_TO_FLUSH].record(usSince(m_paintNs));
+        m_paintNs = -1;
+    }
+    if (m_paintInputNs >= 0)
+    {
+        m_histograms[INPUT_TO_FLUSH].record(usSince(m_paintInputNs));
+        m_paintInputNs = -1;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: reset()
+ *
+*******************************************************************************/
+void LatencyMonitor::reset()
+{
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage)
+    {
+        m_histograms[stage].clear();
+    }
+    m_inputNs = -1;
+    m_updateNs = -1;
+    m_paintNs = -1;
+    m_updateInputNs = -1;
+    m_paintInputNs = -1;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: report()
+ *
+*******************************************************************************/
+QString LatencyMonitor::report() const
+{
+    static const char *const STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+        "input->update", "update->paint", "paint->flush", "input->flush"
+    };
+    const double USEC_IN_MSEC = 1000.0;
+    const size_t LINE_TEXT_SIZE = 96;
+    char lineText[LINE_TEXT_SIZE];
+    snprintf(lineText, LINE_TEXT_SIZE, "%-14s %8s %8s %8s %8s %8s\n",
+             "stage (ms)", "count", "p50", "p95", "p99", "max");
+    QString reportText(lineText);
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; ++stage)
+    {
+        const LatencyHistogram &stageHistogram = m_histograms[stage];
+        snprintf(lineText, LINE_TEXT_SIZE, "%-14s %8u %8.2f %8.2f %8.2f %8.2f\n",
+                 STAGE_NAMES[stage], stageHistogram.count(),
+                 stageHistogram.percentile(50.0) / USEC_IN_MSEC,
+                 stageHistogram.percentile(95.0) / USEC_IN_MSEC,
+                 stageHistogram.percentile(99.0) / USEC_IN_MSEC,
+                 stageHistogram.getMax() / USEC_IN_MSEC);
+        reportText += lineText;
+    }
+    return reportText;
+}
+
+/** ****************************************************************************
+ * Function: writeReport()
+ *   @return false if the file could not be opened.
+*******************************************************************************/
+bool LatencyMonitor::writeReport(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        qDebug("LatencyMonitor::writeReport: Can't open %s", qPrintable(fileName));
+        return false;
+    }
+    QTextStream reportStream(&file);
+    reportStream << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n"
+                 << report() << "\n";
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: usSince()
+ *
+*******************************************************************************/
+qint64 LatencyMonitor::usSince(qint64 markNs) const
+{
+    const qint64 NSEC_IN_USEC = 1000;
+    return (m_clock.nsecsElapsed() - markNs) / NSEC_IN_USEC;
+}
@@ -0,0 +1,105 @@
+/** ****************************************************************************
+ * @file latencymonitor.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The LatencyMonitor measures how long it takes from a mouse move to the dot
+ * being on screen.  The DotWidget marks each stage: the input event, the
+ * simulation frame that consumes it, the end of paintEvent(), and the return
+ * to the event loop after the backing store has been flushed.  The time
+ * between stages is kept in one LatencyHistogram per stage.
+ *
+ ******************************************************************************/
+
+#ifndef LATENCYMONITOR_H
+#define LATENCYMONITOR_H
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QString>
+#include "latencyhistogram.h"
+
+/// Measured stages, each from the previous mark to the next.
+enum latencyStage {
+    INPUT_TO_UPDATE = 0,    ///< mouse move until the game frame that scores it
+    UPDATE_TO_PAINT,        ///< game frame until its paintEvent() has finished
+    PAINT_TO_FLUSH,         ///< paintEvent() until the backing store is flushed
+    INPUT_TO_FLUSH,         ///< the whole way, mouse move to screen
+    LATENCY_STAGE_COUNT
+};
+
+/** ****************************************************************************
+ * @class LatencyMonitor
+ *   Per-stage input-to-display latency histograms.  Only the oldest pending
+ *   mark of each stage is timed, so a burst of mouse moves counts from its
+ *   first event: the latency the player actually sees.
+*******************************************************************************/
+class LatencyMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    explicit LatencyMonitor(QObject *parent = 0);
+
+    /// A mouse move was received
+    void markInput();
+    /// A game frame ran, consuming the input received so far
+    void markUpdate(bool dotMoved);
+    /// paintEvent() has finished drawing the frame
+    void markPaintDone();
+
+    /// Clear all histograms
+    void reset();
+    /// Table of count, p50, p95, p99 and max per stage, in milliseconds
+    QString report() const;
+    /// Append report() to a text file, with a time stamp
+    bool writeReport(const QString &fileName) const;
+
+    inline const LatencyHistogram &histogram(latencyStage stage) const;
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    LatencyMonitor(const LatencyMonitor&);
+    /// prevent assignment operator
+    LatencyMonitor& operator=(const LatencyMonitor&);
+
+    /// Microseconds between a mark and now
+    qint64 usSince(qint64 markNs) const;
+
+    /// Common time base of all marks
+    QElapsedTimer m_clock;
+    /// Marks waiting for their next stage, in ns on m_clock; -1 if none
+    qint64 m_inputNs;
+    qint64 m_updateNs;
+    qint64 m_paintNs;
+    /// Input that the pending update/paint is carrying to the screen; -1 if none
+    qint64 m_updateInputNs;
+    qint64 m_paintInputNs;
+    /// One histogram per stage
+    LatencyHistogram m_histograms[LATENCY_STAGE_COUNT];
+
+private slots:
+    /// Back in the event loop after a paint: the frame has been flushed
+    void markFlushed();
+};
+
+
+/** ****************************************************************************
+ * Function: histogram()
+ *
+*******************************************************************************/
+inline const LatencyHistogram &LatencyMonitor::histogram(latencyStage stage) const
+{
+    return m_histograms[stage];
+}
+
+#endif // LATENCYMONITOR_H
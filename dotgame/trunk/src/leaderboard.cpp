@@ -0,0 +1,789 @@
+/** ****************************************************************************
+ * @file leaderboard.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The Leaderboard: every game played, in memory-mapped binary files with a
+ * sorted index per configuration.  See leaderboard.h for the file layout.
+ *
+ ******************************************************************************/
+
+#include "leaderboard.h"
+#include "safefile.h"
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <algorithm>          // for std::lower_bound(), std::upper_bound()
+#include <string.h>           // for memcmp(), memcpy()
+
+/** @struct FileHeader
+ *    First bytes of the rows and index files. */
+struct FileHeader {
+    char magic[4];
+    quint32 version;
+    /// rows file: sizeof(LeaderboardRow).  index file: rows covered.
+    quint32 field1;
+    /// rows file: unused.  index file: number of partitions.
+    quint32 field2;
+};
+
+static const char ROWS_MAGIC[4] = { 'D', 'O', 'T', 'B' };
+static const char INDEX_MAGIC[4] = { 'D', 'O', 'T', 'I' };
+/// Entries written to the index file at a time
+static const int INDEX_WRITE_CHUNK = 4096;
+/// Longest name the names file can hold, in bytes
+static const int NAME_BYTES_MAX = 255;
+
+/** ****************************************************************************
+ * Function: all()
+ *   Key of the partition every game is in.  Sorts after every real one.
+*******************************************************************************/
+LeaderboardPartition LeaderboardPartition::all()
+{
+    LeaderboardPartition partition = { 0xffff, 0xffff, 0xffff, 0 };
+    return partition;
+}
+
+/** ****************************************************************************
+ * Function: of()
+ *
+*******************************************************************************/
+LeaderboardPartition LeaderboardPartition::of(const HighScoreData &score)
+{
+    LeaderboardPartition partition = { quint16(qMin(score.gameTimeLength, 0xfffeu)),
+                                       quint16(qMin(score.dotDiam, 0xfffeu)),
+                                       quint16(qMin(score.maxSpeed, 0xfffeu)), 0 };
+    return partition;
+}
+
+/** ****************************************************************************
+ * Function: operator<()
+ *
+*******************************************************************************/
+bool LeaderboardPartition::operator<(const LeaderboardPartition &other) const
+{
+    if (gameTimeLength != other.gameTimeLength)
+        return gameTimeLength < other.gameTimeLength;
+    if (dotDiam != other.dotDiam)
+        return dotDiam < other.dotDiam;
+    return maxSpeed < other.maxSpeed;
+}
+
+/** ****************************************************************************
+ * Function: operator==()
+ *
+*******************************************************************************/
+bool LeaderboardPartition::operator==(const LeaderboardPartition &other) const
+{
+    return (gameTimeLength == other.gameTimeLength) && (dotDiam == other.dotDiam) &&
+            (maxSpeed == other.maxSpeed);
+}
+
+/** ****************************************************************************
+ * Function: entryBetter()
+ *   Rank order: higher score first, and of equal scores the earlier game.
+*******************************************************************************/
+static bool entryBetter(const LeaderboardEntry &first, const LeaderboardEntry &second)
+{
+    return (first.score > second.score) ||
+            ((first.score == second.score) && (first.rowId < second.rowId));
+}
+
+/** ****************************************************************************
+ * Function: rankedAhead()
+ *   Would this entry rank ahead of a new game with the given score?
+*******************************************************************************/
+static bool rankedAhead(const LeaderboardEntry &entry, uint score)
+{
+    return entry.score >= score;
+}
+
+/** ****************************************************************************
+ * Function: partitionBefore()
+ *   For searching the index's partition directory.
+*******************************************************************************/
+static bool partitionBefore(const LeaderboardIndexPartition &indexPartition,
+                            const LeaderboardPartition &key)
+{
+    return indexPartition.key < key;
+}
+
+/** ****************************************************************************
+ * Leaderboard Constructor
+ *  @param baseName Path of the files, without the .rows/.names/.index suffix.
+*******************************************************************************/
+Leaderboard::Leaderboard(const QString &baseName) :
+    m_baseName(baseName), m_open(false),
+    m_mappedRowsPtr(NULL), m_mappedRows(0),
+    m_indexPartitionsPtr(NULL), m_indexPartitionCount(0), m_indexEntriesPtr(NULL), m_indexedRows(0),
+    m_deltaRows(0), m_namesSize(0)
+{
+}
+
+/** Leaderboard Destructor */
+Leaderboard::~Leaderboard()
+{
+    closeFiles();
+}
+
+/** ****************************************************************************
+ * Function: open()
+ *   Reads the names and maps the rows and the index.  Only the rows the index
+ *   does not cover yet are looked at, at most DELTA_MAX of them.
+*******************************************************************************/
+bool Leaderboard::open()
+{
+    if (m_open)
+    {
+        return true;
+    }
+    FileLock lock(m_baseName, true);
+    m_open = lock.isLocked() && openLocked();
+    if (!m_open)
+    {
+        qDebug("Leaderboard::open: Can't open %s", qPrintable(m_baseName));
+        closeFiles();
+    }
+    return m_open;
+}
+
+/** ****************************************************************************
+ * Function: close()
+ *
+*******************************************************************************/
+void Leaderboard::close()
+{
+    closeFiles();
+    m_open = false;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: refresh()
+ *   Cheap if nothing changed: a look at the file sizes and the index header.
+*******************************************************************************/
+bool Leaderboard::refresh()
+{
+    if (!m_open)
+    {
+        return open();
+    }
+    FileLock lock(m_baseName, true);
+    if (!lock.isLocked())
+    {
+        return false;
+    }
+    if (isStaleLocked())
+    {
+        m_open = openLocked();
+    }
+    return m_open;
+}
+
+/** ****************************************************************************
+ * Function: insert()
+ *
+*******************************************************************************/
+bool Leaderboard::insert(const HighScoreData &score)
+{
+    QList<HighScoreData> scores;
+    scores.append(score);
+    return insert(scores);
+}
+
+/** ****************************************************************************
+ * Function: insert()
+ *   New names and then the rows are appended and synced, so a row never
+ *   refers to a name that didn't make it to disk.  A partial row or name left
+ *   by a crash is cut off first.  All the rows go in one write and one sync,
+ *   under one lock.
+*******************************************************************************/
+bool Leaderboard::insert(const QList<HighScoreData> &scores)
+{
+    if (scores.isEmpty())
+    {
+        return true;
+    }
+    FileLock lock(m_baseName, true);
+    if (!lock.isLocked())
+    {
+        return false;
+    }
+    if (!m_open || isStaleLocked())
+    {
+        m_open = openLocked();
+        if (!m_open)
+        {
+            closeFiles();
+            return false;
+        }
+    }
+    const quint32 playedAt = QDateTime::currentDateTime().toTime_t();
+    QVector<LeaderboardRow> newRows;
+    newRows.reserve(scores.size());
+    foreach (const HighScoreData &score, scores)
+    {
+        quint32 nameId = 0;
+        if (!internNameLocked(score.name, nameId))
+        {
+            return false;
+        }
+        const LeaderboardPartition partition = LeaderboardPartition::of(score);
+        LeaderboardRow newRow;
+        newRow.score = score.score;
+        newRow.nameId = nameId;
+        newRow.playedAt = playedAt;
+        newRow.gameTimeLength = partition.gameTimeLength;
+        newRow.dotDiam = partition.dotDiam;
+        newRow.maxSpeed = partition.maxSpeed;
+        newRow.reserved = 0;
+        newRows.append(newRow);
+    }
+    const qint64 rowPos = qint64(sizeof(FileHeader)) + qint64(rowCount()) * sizeof(LeaderboardRow);
+    const qint64 rowBytes = qint64(newRows.size()) * sizeof(LeaderboardRow);
+    if (m_rowsFile.size() > rowPos)
+    {
+        m_rowsFile.resize(rowPos);
+    }
+    if (!m_rowsFile.seek(rowPos) ||
+        (m_rowsFile.write(reinterpret_cast<const char *>(newRows.constData()), rowBytes) != rowBytes) ||
+        !syncFile(m_rowsFile))
+    {
+        qDebug("Leaderboard::insert: Can't write %s", qPrintable(m_rowsFile.fileName()));
+        return false;
+    }
+    foreach (const LeaderboardRow &newRow, newRows)
+    {
+        m_newRows.append(newRow);
+        addToDelta(newRow, quint32(rowCount() - 1));
+    }
+    if (m_deltaRows > DELTA_MAX)
+    {
+        rebuildIndexLocked();     // if this fails the delta just keeps growing
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: rank()
+ *   Equal scores rank in the order they were played, so a new game goes
+ *   after them.  O(log n): a binary search in the index and one in the delta.
+*******************************************************************************/
+int Leaderboard::rank(const LeaderboardPartition &partition, uint score) const
+{
+    const Span span = indexSpan(partition);
+    int ahead = std::lower_bound(span.entries, span.entries + span.count, score, rankedAhead) -
+            span.entries;
+    QMap<LeaderboardPartition, QVector<LeaderboardEntry> >::const_iterator deltaIter =
+            m_delta.constFind(partition);
+    if (deltaIter != m_delta.constEnd())
+    {
+        ahead += std::lower_bound(deltaIter->constBegin(), deltaIter->constEnd(), score,
+                                  rankedAhead) - deltaIter->constBegin();
+    }
+    return ahead;
+}
+
+/** ****************************************************************************
+ * Function: count()
+ *
+*******************************************************************************/
+int Leaderboard::count(const LeaderboardPartition &partition) const
+{
+    return indexSpan(partition).count + m_delta.value(partition).size();
+}
+
+/** ****************************************************************************
+ * Function: top()
+ *   Merges the partition's index entries with its delta, from the given rank
+ *   on.  Finding where that rank is takes a binary search, so any page costs
+ *   O(log n + maxCount) however deep it is.
+ *   @param partition LeaderboardPartition::all() for the overall ranking.
+ *   @param maxCount Most games to return.
+ *   @param offset Rank of the first game to return; 0 is the best.
+*******************************************************************************/
+QList<HighScoreData> Leaderboard::top(const LeaderboardPartition &partition, int maxCount,
+                                      int offset) const
+{
+    QList<HighScoreData> games;
+    const Span span = indexSpan(partition);
+    const QVector<LeaderboardEntry> delta = m_delta.value(partition);    // shared, not copied
+    if ((offset < 0) || (offset >= span.count + delta.size()))
+    {
+        return games;
+    }
+    // the first 'offset' games are indexPos of the index's and the rest of the delta's
+    int indexPos = qMax(0, offset - delta.size());
+    int highPos = qMin(offset, span.count);
+    while (indexPos < highPos)
+    {
+        const int midPos = (indexPos + highPos) / 2;
+        if (entryBetter(span.entries[midPos], delta[offset - midPos - 1]))
+        {
+            indexPos = midPos + 1;
+        }
+        else
+        {
+            highPos = midPos;
+        }
+    }
+    int deltaPos = offset - indexPos;
+    while (games.size() < maxCount)
+    {
+        const LeaderboardEntry *entryPtr = NULL;
+        if ((indexPos < span.count) &&
+            ((deltaPos >= delta.size()) || entryBetter(span.entries[indexPos], delta[deltaPos])))
+        {
+            entryPtr = &span.entries[indexPos++];
+        }
+        else if (deltaPos < delta.size())
+        {
+            entryPtr = &delta[deltaPos++];
+        }
+        else
+        {
+            break;
+        }
+        if (entryPtr->rowId < quint32(rowCount()))
+        {
+            const LeaderboardRow &game = row(entryPtr->rowId);
+            HighScoreData gameData = { m_names.value(game.nameId), game.score,
+                                       game.gameTimeLength, game.dotDiam, game.maxSpeed };
+            games.append(gameData);
+        }
+    }
+    return games;
+}
+
+/** ****************************************************************************
+ * Function: snapshot()
+ *   @param lastGamePtr A game already inserted.  It ranks after equal scores,
+ *      so its rank counts it too.
+*******************************************************************************/
+ScoreSnapshot Leaderboard::snapshot(int tableRows, const HighScoreData *lastGamePtr) const
+{
+    ScoreSnapshot tableSnapshot;
+    tableSnapshot.topGames = top(LeaderboardPartition::all(), tableRows);
+    tableSnapshot.gameCount = rowCount();
+    if (lastGamePtr != NULL)
+    {
+        const LeaderboardPartition partition = LeaderboardPartition::of(*lastGamePtr);
+        tableSnapshot.lastGame = *lastGamePtr;
+        tableSnapshot.lastGameRank = rank(LeaderboardPartition::all(), lastGamePtr->score);
+        tableSnapshot.lastGamePartitionRank = rank(partition, lastGamePtr->score);
+        tableSnapshot.lastGamePartitionCount = count(partition);
+    }
+    return tableSnapshot;
+}
+
+/** ****************************************************************************
+ * Function: openLocked()
+ *   Rebuilds the index right away if it is unusable or too far behind.
+*******************************************************************************/
+bool Leaderboard::openLocked()
+{
+    bool indexOk = false;
+    if (!loadLocked(indexOk))
+    {
+        return false;
+    }
+    if ((m_deltaRows > DELTA_MAX) || (!indexOk && QFile::exists(m_baseName + ".index")))
+    {
+        rebuildIndexLocked();
+        return m_rowsFile.isOpen();     // reloaded, with or without the new index
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: loadLocked()
+ *   @param indexOk Set false if the index is missing or unusable.
+*******************************************************************************/
+bool Leaderboard::loadLocked(bool &indexOk)
+{
+    closeFiles();
+    if (!readNamesLocked() || !mapRowsLocked())
+    {
+        closeFiles();
+        return false;
+    }
+    indexOk = mapIndexLocked();
+    for (int rowId = m_indexedRows; rowId < rowCount(); ++rowId)
+    {
+        addToDelta(row(rowId), quint32(rowId));
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: closeFiles()
+ *
+*******************************************************************************/
+void Leaderboard::closeFiles()
+{
+    if (m_mappedRowsPtr != NULL)
+    {
+        m_rowsFile.unmap(reinterpret_cast<uchar *>(const_cast<LeaderboardRow *>(m_mappedRowsPtr)));
+    }
+    if (m_indexPartitionsPtr != NULL)
+    {
+        m_indexFile.unmap(reinterpret_cast<uchar *>(const_cast<LeaderboardIndexPartition *>(
+                                                         m_indexPartitionsPtr)) - sizeof(FileHeader));
+    }
+    m_rowsFile.close();
+    m_indexFile.close();
+    m_mappedRowsPtr = NULL;
+    m_mappedRows = 0;
+    m_newRows.clear();
+    m_indexPartitionsPtr = NULL;
+    m_indexPartitionCount = 0;
+    m_indexEntriesPtr = NULL;
+    m_indexedRows = 0;
+    m_delta.clear();
+    m_deltaRows = 0;
+    m_names.clear();
+    m_nameIds.clear();
+    m_namesSize = 0;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: isStaleLocked()
+ *   A torn row at the end of the rows file doesn't count as a change.
+*******************************************************************************/
+bool Leaderboard::isStaleLocked() const
+{
+    const qint64 rowsSize = QFileInfo(m_baseName + ".rows").size();
+    const qint64 knownRowsSize = qint64(sizeof(FileHeader)) + qint64(rowCount()) * sizeof(LeaderboardRow);
+    if ((rowsSize < knownRowsSize) || (rowsSize - knownRowsSize >= qint64(sizeof(LeaderboardRow))))
+    {
+        return true;
+    }
+    if (QFileInfo(m_baseName + ".names").size() < m_namesSize)
+    {
+        return true;
+    }
+    // names added by others are always followed by a row, checked above
+    QFile indexFile(m_baseName + ".index");
+    FileHeader header;
+    if (!indexFile.open(QIODevice::ReadOnly))
+    {
+        return m_indexEntriesPtr != NULL;
+    }
+    return (indexFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))) ||
+            (int(header.field1) != m_indexedRows);
+}
+
+/** ****************************************************************************
+ * Function: readNamesLocked()
+ *   A name cut short by a crash is ignored; the next new name overwrites it.
+*******************************************************************************/
+bool Leaderboard::readNamesLocked()
+{
+    QFile namesFile(m_baseName + ".names");
+    if (!namesFile.exists())
+    {
+        return true;
+    }
+    if (!namesFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const QByteArray names = namesFile.readAll();
+    int pos = 0;
+    while (pos < names.size())
+    {
+        const int length = uchar(names[pos]);
+        if (pos + 1 + length > names.size())
+        {
+            break;
+        }
+        const QString name = QString::fromUtf8(names.constData() + pos + 1, length);
+        m_nameIds.insert(name, quint32(m_names.size()));
+        m_names.append(name);
+        pos += 1 + length;
+    }
+    m_namesSize = pos;
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: mapRowsLocked()
+ *   Creates the rows file if there is none.
+*******************************************************************************/
+bool Leaderboard::mapRowsLocked()
+{
+    m_rowsFile.setFileName(m_baseName + ".rows");
+    if (!m_rowsFile.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+    FileHeader header;
+    if (m_rowsFile.size() < qint64(sizeof(header)))
+    {
+        memcpy(header.magic, ROWS_MAGIC, sizeof(header.magic));
+        header.version = FORMAT_VERSION;
+        header.field1 = sizeof(LeaderboardRow);
+        header.field2 = 0;
+        if (!m_rowsFile.resize(0) ||
+            (m_rowsFile.write(reinterpret_cast<const char *>(&header), sizeof(header)) != qint64(sizeof(header))) ||
+            !syncFile(m_rowsFile))
+        {
+            return false;
+        }
+    }
+    else if ((m_rowsFile.read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))) ||
+             (memcmp(header.magic, ROWS_MAGIC, sizeof(header.magic)) != 0) ||
+             (header.version != FORMAT_VERSION) || (header.field1 != sizeof(LeaderboardRow)))
+    {
+        qDebug("Leaderboard::mapRowsLocked: %s is not a leaderboard", qPrintable(m_rowsFile.fileName()));
+        return false;
+    }
+    m_mappedRows = int((m_rowsFile.size() - qint64(sizeof(header))) / qint64(sizeof(LeaderboardRow)));
+    if (m_mappedRows > 0)
+    {
+        const uchar *mapPtr = m_rowsFile.map(sizeof(header), qint64(m_mappedRows) * sizeof(LeaderboardRow));
+        if (mapPtr == NULL)
+        {
+            m_mappedRows = 0;
+            return false;
+        }
+        m_mappedRowsPtr = reinterpret_cast<const LeaderboardRow *>(mapPtr);
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: mapIndexLocked()
+ *   @return false if there is no index, or it is unusable and has to be
+ *      rebuilt.  Everything then goes in the delta.
+*******************************************************************************/
+bool Leaderboard::mapIndexLocked()
+{
+    m_indexFile.setFileName(m_baseName + ".index");
+    if (!m_indexFile.exists() || !m_indexFile.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    const qint64 size = m_indexFile.size();
+    const uchar *mapPtr = (size >= qint64(sizeof(FileHeader))) ? m_indexFile.map(0, size) : NULL;
+    if (mapPtr == NULL)
+    {
+        m_indexFile.close();
+        return false;
+    }
+    const FileHeader *headerPtr = reinterpret_cast<const FileHeader *>(mapPtr);
+    const qint64 directorySize = qint64(headerPtr->field2) * sizeof(LeaderboardIndexPartition);
+    const qint64 entryCount = (size - qint64(sizeof(FileHeader)) - directorySize) / qint64(sizeof(LeaderboardEntry));
+    const LeaderboardIndexPartition *partitionsPtr =
+            reinterpret_cast<const LeaderboardIndexPartition *>(mapPtr + sizeof(FileHeader));
+    bool valid = (memcmp(headerPtr->magic, INDEX_MAGIC, sizeof(headerPtr->magic)) == 0) &&
+            (headerPtr->version == FORMAT_VERSION) && (int(headerPtr->field1) <= rowCount()) &&
+            (entryCount >= 0);
+    for (quint32 partNum = 0; valid && (partNum < headerPtr->field2); ++partNum)
+    {
+        valid = (qint64(partitionsPtr[partNum].firstEntry) + partitionsPtr[partNum].entryCount <= entryCount);
+    }
+    if (!valid)
+    {
+        qDebug("Leaderboard::mapIndexLocked: %s is unusable", qPrintable(m_indexFile.fileName()));
+        m_indexFile.unmap(const_cast<uchar *>(mapPtr));
+        m_indexFile.close();
+        return false;
+    }
+    m_indexPartitionsPtr = partitionsPtr;
+    m_indexPartitionCount = int(headerPtr->field2);
+    m_indexEntriesPtr = reinterpret_cast<const LeaderboardEntry *>(mapPtr + sizeof(FileHeader) + directorySize);
+    m_indexedRows = int(headerPtr->field1);
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: rebuildIndexLocked()
+ *   Each partition of the old index is merged with its delta into
+ *   "<base>.index.tmp", which is synced and renamed over the index.  Windows
+ *   won't replace a file another instance has mapped; the delta then keeps
+ *   growing until the rebuild succeeds.
+*******************************************************************************/
+bool Leaderboard::rebuildIndexLocked()
+{
+    // every partition of the old index or the delta, in key order
+    QMap<LeaderboardPartition, quint32> partitionSizes;
+    for (int partNum = 0; partNum < m_indexPartitionCount; ++partNum)
+    {
+        partitionSizes[m_indexPartitionsPtr[partNum].key] += m_indexPartitionsPtr[partNum].entryCount;
+    }
+    QMap<LeaderboardPartition, QVector<LeaderboardEntry> >::const_iterator deltaIter;
+    for (deltaIter = m_delta.constBegin(); deltaIter != m_delta.constEnd(); ++deltaIter)
+    {
+        partitionSizes[deltaIter.key()] += quint32(deltaIter->size());
+    }
+
+    const QString indexName = m_baseName + ".index";
+    const QString tempName = indexName + ".tmp";
+    QFile tempFile(tempName);
+    if (!tempFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qDebug("Leaderboard::rebuildIndexLocked: Can't open %s", qPrintable(tempName));
+        return false;
+    }
+    FileHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.field1 = quint32(rowCount());
+    header.field2 = quint32(partitionSizes.size());
+    bool written = (tempFile.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header)));
+    quint32 firstEntry = 0;
+    QMap<LeaderboardPartition, quint32>::const_iterator sizeIter;
+    for (sizeIter = partitionSizes.constBegin(); sizeIter != partitionSizes.constEnd(); ++sizeIter)
+    {
+        LeaderboardIndexPartition directoryEntry = { sizeIter.key(), firstEntry, sizeIter.value() };
+        written = written && (tempFile.write(reinterpret_cast<const char *>(&directoryEntry),
+                                             sizeof(directoryEntry)) == qint64(sizeof(directoryEntry)));
+        firstEntry += sizeIter.value();
+    }
+    QVector<LeaderboardEntry> buffer;
+    buffer.reserve(INDEX_WRITE_CHUNK);
+    for (sizeIter = partitionSizes.constBegin(); written && (sizeIter != partitionSizes.constEnd()); ++sizeIter)
+    {
+        const Span span = indexSpan(sizeIter.key());
+        const QVector<LeaderboardEntry> delta = m_delta.value(sizeIter.key());
+        int indexPos = 0;
+        int deltaPos = 0;
+        while (written && ((indexPos < span.count) || (deltaPos < delta.size())))
+        {
+            if ((indexPos < span.count) &&
+                ((deltaPos >= delta.size()) || entryBetter(span.entries[indexPos], delta[deltaPos])))
+            {
+                buffer.append(span.entries[indexPos++]);
+            }
+            else
+            {
+                buffer.append(delta[deltaPos++]);
+            }
+            if (buffer.size() == INDEX_WRITE_CHUNK)
+            {
+                const qint64 bytes = qint64(buffer.size()) * sizeof(LeaderboardEntry);
+                written = (tempFile.write(reinterpret_cast<const char *>(buffer.constData()), bytes) == bytes);
+                buffer.clear();
+            }
+        }
+    }
+    const qint64 bytes = qint64(buffer.size()) * sizeof(LeaderboardEntry);
+    written = written && (tempFile.write(reinterpret_cast<const char *>(buffer.constData()), bytes) == bytes);
+    written = written && syncFile(tempFile);
+    tempFile.close();
+
+    closeFiles();     // Windows can't replace a mapped file
+    const bool replaced = written && replaceFile(tempName, indexName);
+    if (!replaced)
+    {
+        qDebug("Leaderboard::rebuildIndexLocked: Can't replace %s", qPrintable(indexName));
+        QFile::remove(tempName);
+    }
+    bool indexOk = false;
+    if (!loadLocked(indexOk))     // not openLocked(): that could rebuild again
+    {
+        m_open = false;
+    }
+    return replaced;
+}
+
+/** ****************************************************************************
+ * Function: internNameLocked()
+ *   Each name is stored once; rows refer to it by id.
+*******************************************************************************/
+bool Leaderboard::internNameLocked(const QString &name, quint32 &nameId)
+{
+    QHash<QString, quint32>::const_iterator nameIter = m_nameIds.constFind(name);
+    if (nameIter != m_nameIds.constEnd())
+    {
+        nameId = nameIter.value();
+        return true;
+    }
+    QByteArray nameBytes = name.toUtf8();
+    nameBytes.truncate(NAME_BYTES_MAX);     // names are limited to far less anyway
+    nameBytes.prepend(char(nameBytes.size()));
+    QFile namesFile(m_baseName + ".names");
+    if (!namesFile.open(QIODevice::ReadWrite))
+    {
+        return false;
+    }
+    if (namesFile.size() > m_namesSize)
+    {
+        namesFile.resize(m_namesSize);    // cut off a partial name
+    }
+    if (!namesFile.seek(m_namesSize) || (namesFile.write(nameBytes) != nameBytes.size()) ||
+        !syncFile(namesFile))
+    {
+        qDebug("Leaderboard::internNameLocked: Can't write %s", qPrintable(namesFile.fileName()));
+        return false;
+    }
+    m_namesSize += nameBytes.size();
+    nameId = quint32(m_names.size());
+    const QString storedName = QString::fromUtf8(nameBytes.constData() + 1, nameBytes.size() - 1);
+    m_names.append(storedName);
+    m_nameIds.insert(storedName, nameId);
+    if (storedName != name)
+    {
+        m_nameIds.insert(name, nameId);
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: indexSpan()
+ *   Binary search of the partition directory.
+*******************************************************************************/
+Leaderboard::Span Leaderboard::indexSpan(const LeaderboardPartition &partition) const
+{
+    Span span = { NULL, 0 };
+    const LeaderboardIndexPartition *endPtr = m_indexPartitionsPtr + m_indexPartitionCount;
+    const LeaderboardIndexPartition *foundPtr =
+            std::lower_bound(m_indexPartitionsPtr, endPtr, partition, partitionBefore);
+    if ((foundPtr != endPtr) && (foundPtr->key == partition))
+    {
+        span.entries = m_indexEntriesPtr + foundPtr->firstEntry;
+        span.count = int(foundPtr->entryCount);
+    }
+    return span;
+}
+
+/** ****************************************************************************
+ * Function: row()
+ *
+*******************************************************************************/
+const LeaderboardRow &Leaderboard::row(quint32 rowId) const
+{
+    if (int(rowId) < m_mappedRows)
+    {
+        return m_mappedRowsPtr[rowId];
+    }
+    return m_newRows[int(rowId) - m_mappedRows];
+}
+
+/** ****************************************************************************
+ * Function: addToDelta()
+ *   Into the overall delta and the row's partition's, keeping rank order.
+*******************************************************************************/
+void Leaderboard::addToDelta(const LeaderboardRow &newRow, quint32 rowId)
+{
+    const LeaderboardEntry entry = { newRow.score, rowId };
+    LeaderboardPartition partition = { newRow.gameTimeLength, newRow.dotDiam, newRow.maxSpeed, 0 };
+    const LeaderboardPartition partitions[2] = { LeaderboardPartition::all(), partition };
+    for (int partNum = 0; partNum < 2; ++partNum)
+    {
+        QVector<LeaderboardEntry> &delta = m_delta[partitions[partNum]];
+        delta.insert(std::upper_bound(delta.begin(), delta.end(), entry, entryBetter), entry);
+    }
+    ++m_deltaRows;
+    return;
+}
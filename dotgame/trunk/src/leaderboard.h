@@ -0,0 +1,210 @@
+/** ****************************************************************************
+ * @file leaderboard.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The Leaderboard keeps every game ever played, ranked overall and within its
+ * partition: the game's (time, dot size, speed) configuration.  It is three
+ * binary files, all in host byte order and memory-mapped when opened:
+ *
+ *   <base>.rows   header, then one fixed-size LeaderboardRow per game, in the
+ *                 order played.  Append-only.
+ *   <base>.names  the interned player names: length byte plus UTF-8 text.
+ *                 A row refers to a name by its position.  Append-only.
+ *   <base>.index  header, the partition directory sorted by key, then each
+ *                 partition's (score, row) entries, best first.  Covers the
+ *                 first rowsCovered rows; rewritten and renamed into place.
+ *
+ * Rows past the index are kept in a small sorted in-memory delta per
+ * partition, so a rank or insert is a binary search in the index plus one in
+ * the delta.  When the delta reaches DELTA_MAX rows it is merged into a new
+ * index, a linear pass amortized over DELTA_MAX inserts.
+ *
+ ******************************************************************************/
+
+#ifndef LEADERBOARD_H
+#define LEADERBOARD_H
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QVector>
+#include <QtCore/QMap>
+#include <QtCore/QHash>
+#include "scorescreen.h"      // for HighScoreData, ScoreSnapshot
+
+/** @struct LeaderboardPartition
+ *    Configuration a game was played with; games are also ranked within it. */
+struct LeaderboardPartition {
+    quint16 gameTimeLength;
+    quint16 dotDiam;
+    quint16 maxSpeed;
+    quint16 reserved;
+
+    /// The partition of every game
+    static LeaderboardPartition all();
+    /// The partition a game belongs to
+    static LeaderboardPartition of(const HighScoreData &score);
+    bool operator<(const LeaderboardPartition &other) const;
+    bool operator==(const LeaderboardPartition &other) const;
+};
+
+/** @struct LeaderboardRow
+ *    One game, as stored in the rows file. */
+struct LeaderboardRow {
+    quint32 score;
+    /// Position of the player's name in the names file
+    quint32 nameId;
+    /// When the game ended, seconds since 1970 UTC; 0 if unknown
+    quint32 playedAt;
+    quint16 gameTimeLength;
+    quint16 dotDiam;
+    quint16 maxSpeed;
+    quint16 reserved;
+};
+
+/** @struct LeaderboardEntry
+ *    One game in an index partition or delta. */
+struct LeaderboardEntry {
+    quint32 score;
+    quint32 rowId;
+};
+
+/** @struct LeaderboardIndexPartition
+ *    Where a partition's entries are in the index file. */
+struct LeaderboardIndexPartition {
+    LeaderboardPartition key;
+    /// Position of the first entry, counted from the first entry of the file
+    quint32 firstEntry;
+    quint32 entryCount;
+};
+
+/** ****************************************************************************
+ * @class Leaderboard
+ *   Every game played, ranked.  Rank and top-K queries read the mapped index
+ *   directly; nothing is loaded but the names and the delta.
+*******************************************************************************/
+class Leaderboard
+{
+public:
+    /// @param baseName Path of the files, without the .rows/.names/.index suffix
+    explicit Leaderboard(const QString &baseName);
+    ~Leaderboard();
+
+    /// Map the files, creating them if needed
+    bool open();
+    void close();
+    inline bool isOpen() const;
+    /// Pick up games added by other instances since the files were opened
+    bool refresh();
+
+    /// Add a game; its playedAt is now
+    bool insert(const HighScoreData &score);
+    /// Add several games at once, e.g. ones queued while the disk was busy
+    bool insert(const QList<HighScoreData> &scores);
+
+    /// Number of games that rank ahead of a new game with this score
+    int rank(const LeaderboardPartition &partition, uint score) const;
+    /// Number of games in a partition
+    int count(const LeaderboardPartition &partition) const;
+    /// Games ranked offset to offset+maxCount-1, best first
+    QList<HighScoreData> top(const LeaderboardPartition &partition, int maxCount,
+                             int offset = 0) const;
+    /// Total number of games
+    inline int rowCount() const;
+    /// The best tableRows games overall, and where lastGamePtr ranks if given
+    ScoreSnapshot snapshot(int tableRows, const HighScoreData *lastGamePtr = NULL) const;
+
+    /// Most rows kept outside the index before it is rebuilt
+    static const int DELTA_MAX = 4096;
+    /// Rows file format version; bump when LeaderboardRow changes
+    static const quint32 FORMAT_VERSION = 1;
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    Leaderboard(const Leaderboard&);
+    /// prevent assignment operator
+    Leaderboard& operator=(const Leaderboard&);
+
+    /** @struct Span
+     *    Entries of one partition in the mapped index. */
+    struct Span {
+        const LeaderboardEntry *entries;
+        int count;
+    };
+
+    /// The open() and refresh() work; call with the lock held
+    bool openLocked();
+    /// Read the names, map the rows and index and fill the delta
+    bool loadLocked(bool &indexOk);
+    void closeFiles();
+    /// Have other instances changed the files since they were read?
+    bool isStaleLocked() const;
+    bool readNamesLocked();
+    bool mapRowsLocked();
+    bool mapIndexLocked();
+    /// Merge the delta into a new index file
+    bool rebuildIndexLocked();
+    /// Name id of a player, appending the name if it is new
+    bool internNameLocked(const QString &name, quint32 &nameId);
+
+    Span indexSpan(const LeaderboardPartition &partition) const;
+    const LeaderboardRow &row(quint32 rowId) const;
+    void addToDelta(const LeaderboardRow &newRow, quint32 rowId);
+
+    QString m_baseName;
+    bool m_open;
+
+    /// The rows file, mapped up to m_mappedRows; later rows are in m_newRows
+    QFile m_rowsFile;
+    const LeaderboardRow *m_mappedRowsPtr;
+    int m_mappedRows;
+    QVector<LeaderboardRow> m_newRows;
+
+    /// The index file, mapped; NULL pointers if there is none yet
+    QFile m_indexFile;
+    const LeaderboardIndexPartition *m_indexPartitionsPtr;
+    int m_indexPartitionCount;
+    const LeaderboardEntry *m_indexEntriesPtr;
+    int m_indexedRows;
+
+    /// Rows past the index, per partition, best first
+    QMap<LeaderboardPartition, QVector<LeaderboardEntry> > m_delta;
+    int m_deltaRows;
+
+    /// Interned names, by id and by name
+    QVector<QString> m_names;
+    QHash<QString, quint32> m_nameIds;
+    /// Valid length of the names file
+    qint64 m_namesSize;
+};
+
+
+/** ****************************************************************************
+ * Function: isOpen()
+ *
+*******************************************************************************/
+inline bool Leaderboard::isOpen() const
+{
+    return m_open;
+}
+/** ****************************************************************************
+ * Function: rowCount()
+ *
+*******************************************************************************/
+inline int Leaderboard::rowCount() const
+{
+    return m_mappedRows + m_newRows.size();
+}
+
+#endif // LEADERBOARD_H
@@ -21,25 +21,48 @@
 #include "qmlapplicationviewer.h"
 #include "mainwindow.h"
 #include <QDeclarativeView>
-#include <QtGui/QSlider>
-#include <string>
+#include <QtDeclarative/qdeclarative.h>     // for qmlRegisterType
+#include "dotdeclarative.h"
+#include "qsliderdeclarative.h"
+#include "startuptimeline.h"
+#include <QtCore/QStringList>
 
 /// Main Function for Dot Game application.
 Q_DECL_EXPORT int main(int argc, char *argv[])
 {
+    StartupTimeline startup;    // first: times everything up to the first frame
     QScopedPointer<QApplication> app(createApplication(argc, argv));
+    startup.mark(STARTUP_APPLICATION);
 
-    //qmlRegisterType<QSlider>("QtItems", 1, 0, "QSlider");
+    qmlRegisterType<QSliderDeclarative>("QtItems", 1, 0, "QSlider");
+    qmlRegisterType<DotDeclarative>("QtItems", 1, 0, "GameDot");    // before any QML is loaded
+    startup.mark(STARTUP_QML_TYPES);
 
-    MainWindow w;
+    // --startup: append the startup timeline to dotGameStartup.txt
+    if (app->arguments().contains("--startup"))
+    {
+        startup.setReportFile("dotGameStartup.txt");
+    }
+
+    // --layered: draw the game as a widget under the QML, the old way
+    MainWindow w(NULL, app->arguments().contains("--layered") ?
+                     LAYERED_RENDERING : SINGLE_SURFACE_RENDERING, &startup);
     w.show();
+    startup.mark(STARTUP_SHOW);
+
+    // --latency: measure input-to-display latency (F9 shows it)
+    if (app->arguments().contains("--latency"))
+    {
+        w.enableLatencyMonitor();
+    }
 
-    // test code to demonstrate command-line arguments successfully passes in from Qt Creator.
-    std::string debugStr = "DEBUG_ON=";
-    //qDebug("arguments: %s %s", argv[0], argv[1]);
-    if ((debugStr.compare(0,9,argv[1])))
+    // --replay <file>: play a recorded game, and write whether it matched to
+    //    <file>.check.txt; --replay-fast: as fast as possible
+    const QStringList args = app->arguments();
+    const int replayArg = args.indexOf("--replay");
+    if ((replayArg > 0) && (replayArg + 1 < args.size()))
     {
-        //qDebug("correctly compared.");
+        w.playReplay(args.at(replayArg + 1), args.contains("--replay-fast"));
     }
 
     return app->exec();
@@ -25,17 +25,18 @@
 #include <QObject>
 #include <QGraphicsObject>   // for rootObject()
 #include <QtCore/QSize>
-#include <QtCore/QFile>
 #include <QtGui/QVBoxLayout>
 #include <QtGui/QDockWidget>
 #include <QtGui/QLabel>
 #include <QtGui/QSlider>
 #include <QtGui/QRadioButton>
 #include <QtGui/QInputDialog>
+#include <QtGui/QMessageBox>
+#include <QtGui/QShortcut>
+#include <QtCore/QUrl>
 #include <stdio.h>       // for snprintf()
 
-//#include <QtDeclarative/QDeclarativeView>  // for qmlRegisterType
-//#include "qsliderdeclarative.h"
+#include "qsliderdeclarative.h"
 
 /// For addressing the Central 'Game' StackedWidget pages
 enum gameStackPageNumber {
@@ -48,42 +49,44 @@ enum gameStackPageNumber {
 /// For addressing the Central 'Top' StackedWidget pages
 enum topStackPageNumber {
     GAME_QML_PAGE = 0,              // corresponds to 'centralGameLayoutPtr' containing DotGame&QML
-    HIGH_SCORE_PAGE                 // corresponds to 'm_scoreScreenPtr'
+    HIGH_SCORE_PAGE                 // corresponds to 'm_scoreScreenPtr', added at the first game over
 };
 
 /** ****************************************************************************
  * MainWindow Constructor
  *   @param parent Pointer to the parent window widget
+ *   @param mode One QML view drawing everything, or the DotWidget and the QML
+ *      view composited.  Falls back to layered if the QML can't hold the field.
+ *   @param startupPtr Marked as each part is set up, and ended by the first
+ *      paint; NULL if startup isn't timed.
  ******************************************************************************/
-MainWindow::MainWindow(QWidget *parent) :
+MainWindow::MainWindow(QWidget *parent, renderMode mode, StartupTimeline *startupPtr) :
     QMainWindow(parent),
     m_centralTopLayoutPtr(NULL), m_centralGameLayoutPtr(NULL),
     m_dotGameWidgetPtr(NULL), m_configDotDockPtr(NULL), m_scoreScreenPtr(NULL),
-    m_qmlViewerPtr(NULL),
-    m_timeSpinBoxPtr(NULL), m_followingDistStatusBarPtr(NULL)
+    m_qmlViewerPtr(NULL), m_qmlDotPtr(NULL), m_dotFieldPtr(NULL),
+    m_timeSpinBoxPtr(NULL), m_followingDistStatusBarPtr(NULL),
+    m_scoreStore("dotGameLeaderboard", "dotGameScores.txt", "replays", NUM_HIGH_SCORES_MAX),
+    m_latencyMonitorPtr(NULL), m_startupPtr(startupPtr),
+    m_dotGameInitialized(false)
 {
     setWindowTitle(tr("Dot Game"));
     m_dotGameWidgetPtr = new DotWidget(this, size());
+    m_dotGameWidgetPtr->setBackgroundColor(BACKGROUND_COLOR_DEFAULT);
+    markStartup(STARTUP_GAME_WIDGET);
 
-    // m_scoreScreen permanently holds a pointer to the highm_scoreList data.
-    m_scoreScreenPtr = new ScoreScreen(this, &m_highScoreList);
     m_followingDistStatusBarPtr = new GradientTextStatusBar(this);
     statusBar()->addWidget(m_followingDistStatusBarPtr,1);
-    m_dotGameWidgetPtr->setBackgroundColor(BACKGROUND_COLOR_DEFAULT);
-    m_scoreScreenPtr->setBackgroundColor(BACKGROUND_COLOR_DEFAULT);
-
-    //qmlRegisterType<QSliderDeclarative>("QtItems", 1, 0, "QSlider");
+    markStartup(STARTUP_STATUS_BAR);
 
     m_qmlViewerPtr = new QmlApplicationViewer;
     m_qmlViewerPtr->setOrientation(QmlApplicationViewer::ScreenOrientationAuto);
-    m_qmlViewerPtr->setMainQmlFile(QLatin1String("qml/dotgame/main.qml"));
-    //QObject* rootObject = dynamic_cast<QObject*>(qmlViewerPtr->rootObject());
-    QGraphicsObject* rootObject = m_qmlViewerPtr->rootObject();
-    QObject::connect(m_dotGameWidgetPtr, SIGNAL(newDotLoc(QVariant)), rootObject, SLOT(updateDotLoc(QVariant)));
-    QObject::connect(rootObject, SIGNAL(screenClicked()), m_dotGameWidgetPtr, SLOT(screenClicked()));
-    QObject::connect(rootObject, SIGNAL(setTimeLimit(int)), m_dotGameWidgetPtr, SLOT(setTimeLimit(int)));
-
-    m_qmlViewerPtr->showExpanded();
+    // built into the executable: no looking for the file, nor reading it, at startup
+    m_qmlViewerPtr->setSource(QUrl(QLatin1String("qrc:/qml/dotgame/main.qml")));
+    setUpQmlScene(mode);
+    // no showExpanded(): it would map the view as a window of its own before
+    //    the layout takes it; it is shown with the MainWindow instead.
+    markStartup(STARTUP_QML_SCENE);
 
     /* Compose the Center of the MainWindow as the following:
      *      MainWindow
@@ -91,26 +94,47 @@ MainWindow::MainWindow(QWidget *parent) :
      *          |-> High m_score Screen
      *          |-> Game&QML
      *              | (show ALL)
-     *              |-> Dot Game Screen
+     *              |-> Dot Game Screen (LAYERED_RENDERING only; else in the QML)
      *              |-> QML Control Panel
      *  Note: make sure the addWidget order matches the enumerations */
     QWidget* centralWidgetPtr = new QWidget;
     m_centralGameLayoutPtr = new QStackedLayout;
     m_centralGameLayoutPtr->addWidget(m_qmlViewerPtr);
-    m_centralGameLayoutPtr->addWidget(m_dotGameWidgetPtr);
+    if (m_dotFieldPtr == NULL)
+    {
+        m_centralGameLayoutPtr->addWidget(m_dotGameWidgetPtr);
+    }
+    else
+    {
+        m_dotGameWidgetPtr->hide();     // drawn by m_dotFieldPtr; only runs the game
+    }
     m_centralGameLayoutPtr->setStackingMode(QStackedLayout::StackAll);
+    // the QML layer is on top and gets the mouse moves; sample the cursor from it too.
+    m_dotGameWidgetPtr->trackCursorOver(m_qmlViewerPtr->viewport());
+    // F10: performance overlay, Shift+F10: save its frame timings.
+    m_dotGameWidgetPtr->frameProfiler()->watchPaint(m_qmlViewerPtr->viewport(), SECTION_PAINT_QML);
+    m_dotGameWidgetPtr->frameProfiler()->watchPaint(m_followingDistStatusBarPtr, SECTION_PAINT_STATUS);
+    QShortcut *hudShortcutPtr = new QShortcut(QKeySequence(Qt::Key_F10), this);
+    QObject::connect(hudShortcutPtr, SIGNAL(activated()), m_dotGameWidgetPtr, SLOT(toggleHud()));
+    new QShortcut(QKeySequence(Qt::SHIFT + Qt::Key_F10), this, SLOT(exportFrameTimings()));
+    // F8: next dot skin.
+    QShortcut *skinShortcutPtr = new QShortcut(QKeySequence(Qt::Key_F8), this);
+    QObject::connect(skinShortcutPtr, SIGNAL(activated()), m_dotGameWidgetPtr, SLOT(cycleDotSkin()));
     QWidget* centralGameWidgetPtr = new QWidget;
     centralGameWidgetPtr->setLayout(m_centralGameLayoutPtr);
     m_centralTopLayoutPtr = new QStackedLayout;
     m_centralTopLayoutPtr->addWidget(centralGameWidgetPtr);  // index:0 is the default active
-    m_centralTopLayoutPtr->addWidget(m_scoreScreenPtr);
+    // the High Score Screen is only made, and added, at the first game over: showScoreScreen()
     m_centralTopLayoutPtr->setStackingMode(QStackedLayout::StackOne);
     centralWidgetPtr->setLayout(m_centralTopLayoutPtr);
     setCentralWidget(centralWidgetPtr);
     // DEBUG: For some reason, have to select another page, come back, to make all layers show correctly.
     //centralGameLayoutPtr->setCurrentIndex(QML_CONTROL_PAGE);
     m_centralGameLayoutPtr->setCurrentIndex(DOT_GAME_PAGE);
-    m_centralGameLayoutPtr->setCurrentIndex(QML_CONTROL_PAGE);
+    if (m_qmlViewerPtr->rootObject() != NULL)
+    {
+        m_centralGameLayoutPtr->setCurrentIndex(QML_CONTROL_PAGE);
+    }   // else the empty view stays under the game, which then gets the clicks itself
     //    centralTopLayoutPtr->setCurrentIndex(HIGH_m_score_PAGE);
     m_centralTopLayoutPtr->setCurrentIndex(GAME_QML_PAGE);
 
@@ -193,16 +217,27 @@ MainWindow::MainWindow(QWidget *parent) :
 
 
 
-    QObject::connect(m_dotGameWidgetPtr, SIGNAL(newFollowDistanceRatio(float, uint)),
-                     this, SLOT(updateDistStatusBar(float, uint)));
+    QObject::connect(m_dotGameWidgetPtr, SIGNAL(newGameState(GameStateSnapshot)),
+                     this, SLOT(updateGameState(GameStateSnapshot)));
     QObject::connect(m_dotGameWidgetPtr, SIGNAL(gameOver(gameOverReason)),
                      this, SLOT(gameOver(gameOverReason)));
-    QObject::connect(m_scoreScreenPtr, SIGNAL(scoreScreenClicked()),
-                     this, SLOT(returnToGame()));
-
-    show();             // update all window settings to adjust sizes
-    m_dotGameWidgetPtr->initialize();  // re-center dot position
-
+    // replays, and the checks of replayed games, are written on the score thread
+    QObject::connect(m_dotGameWidgetPtr, SIGNAL(replayRecorded(QByteArray)),
+                     &m_scoreStore, SLOT(saveReplay(QByteArray)));
+    QObject::connect(m_dotGameWidgetPtr, SIGNAL(replayChecked(QString, uint, float, float)),
+                     &m_scoreStore, SLOT(saveReplayCheck(QString, uint, float, float)));
+    QObject::connect(&m_scoreStore, SIGNAL(loadFinished(bool)),
+                     this, SLOT(scoresLoaded(bool)));
+    markStartup(STARTUP_LAYOUT);
+    // read the table while the player plays, so the first game over is as quick as the rest
+    m_scoreStore.load();
+    markStartup(STARTUP_SCORE_STORE);
+
+    // shown once, by the caller; the dot is centered by showEvent()
+    if (m_startupPtr != NULL)
+    {
+        m_startupPtr->finishOnFirstPaint(m_qmlViewerPtr->viewport());
+    }
     return;
 } // MainWindow ctor
 
@@ -215,18 +250,195 @@ MainWindow::~MainWindow()
 
 
 /** ****************************************************************************
- * Function: updateDistStatusBar()
- *  Using the Distance Ratio and m_elapsedGameTime, tell the status bar to redraw.
- *    @param errorDistRatio Generally, the ratio of the current mouse cursor
- *      distance from the dot, divided by the pixel diameter of the dot to be the
- *      number of circle diameters away. Normalize before sending to StatusBar.
- *    @param m_elapsedGameTime The number of seconds that the game has been running,
- *      minus any game pauses.
+ * Function: setUpQmlScene()
+ *   Find the QML items driven from C++, put the DotWidget's field in the scene
+ *   (SINGLE_SURFACE_RENDERING), and connect the controls.  If main.qml didn't
+ *   load there is no root object: the game is then layered, without controls.
+*******************************************************************************/
+void MainWindow::setUpQmlScene(renderMode mode)
+{
+    QGraphicsObject* rootObject = m_qmlViewerPtr->rootObject();
+    if (rootObject == NULL)
+    {
+        qDebug("MainWindow::setUpQmlScene: main.qml did not load; no QML controls.");
+        return;
+    }
+    // dot moves are passed on by updateGameState(), straight to the item
+    m_qmlDotPtr = rootObject->findChild<DotDeclarative *>("dot");
+    if (m_qmlDotPtr != NULL)
+    {
+        // drawn as the game draws it; updateGameState() follows size and skin changes
+        m_qmlDotPtr->setSprite(m_dotGameWidgetPtr->getDotSprite());
+        m_qmlDotPtr->setCenter(m_dotGameWidgetPtr->gameState().dotPos);
+    }
+    QDeclarativeItem *rootItemPtr = qobject_cast<QDeclarativeItem *>(rootObject);
+    if ((mode == SINGLE_SURFACE_RENDERING) && (rootItemPtr != NULL) && (m_qmlDotPtr != NULL))
+    {
+        // The field goes in the scene, above the QML background and below
+        //    the dot and the controls.  Only what changed is repainted.
+        m_dotFieldPtr = new DotFieldDeclarative(m_dotGameWidgetPtr, rootItemPtr);
+        m_dotFieldPtr->setZ(-1);
+        m_dotFieldPtr->fill(rootItemPtr);
+        m_qmlViewerPtr->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+    }
+    QObject::connect(rootObject, SIGNAL(screenClicked()), m_dotGameWidgetPtr, SLOT(screenClicked()));
+    QObject::connect(rootObject, SIGNAL(setTimeLimit(int)), m_dotGameWidgetPtr, SLOT(setTimeLimit(int)));
+    // Speed slider values inverted so that bigger/slower number on left side.
+    QSliderDeclarative *speedSliderPtr = rootObject->findChild<QSliderDeclarative *>("speedSlider");
+    if (speedSliderPtr != NULL)
+    {
+        speedSliderPtr->setRange(-int(Dot::DOT_SPEED_MAX), -int(Dot::DOT_SPEED_MIN));
+        speedSliderPtr->setValue(-int(m_dotGameWidgetPtr->getDotSpeed()));
+        QObject::connect(speedSliderPtr, SIGNAL(valueChanged(int)),
+                         m_dotGameWidgetPtr, SLOT(setDotSpeedNeg(int)));
+        QObject::connect(m_dotGameWidgetPtr, SIGNAL(newDotSpeedNeg(int)),
+                         speedSliderPtr, SLOT(setValue(int)));
+    }
+    QSliderDeclarative *sizeSliderPtr = rootObject->findChild<QSliderDeclarative *>("sizeSlider");
+    if (sizeSliderPtr != NULL)
+    {
+        sizeSliderPtr->setRange(Dot::DOT_DIAM_MIN, Dot::DOT_DIAM_MAX);
+        sizeSliderPtr->setValue(m_dotGameWidgetPtr->getDotSize());
+        QObject::connect(sizeSliderPtr, SIGNAL(valueChanged(int)),
+                         m_dotGameWidgetPtr, SLOT(setDotSize(int)));
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: showEvent() reimplemented from QWidget
+ *   The first show has laid out the window, so the game area has its size:
+ *   the dot can be put in the middle of it.
+*******************************************************************************/
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    if (!m_dotGameInitialized)
+    {
+        m_dotGameWidgetPtr->initialize();  // re-center dot position
+        m_dotGameInitialized = true;
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: markStartup()
+ *   Nothing if the startup isn't being timed.
+*******************************************************************************/
+void MainWindow::markStartup(startupStage stage)
+{
+    if (m_startupPtr != NULL)
+    {
+        m_startupPtr->mark(stage);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: showScoreScreen()
+ *   Makes the score screen the first time, and gives it the table as read
+ *   so far; from then on it follows the score store.
+*******************************************************************************/
+void MainWindow::showScoreScreen()
+{
+    if (m_scoreScreenPtr == NULL)
+    {
+        m_scoreScreenPtr = new ScoreScreen(this);
+        m_scoreScreenPtr->setBackgroundColor(BACKGROUND_COLOR_DEFAULT);
+        QObject::connect(m_scoreScreenPtr, SIGNAL(scoreScreenClicked()),
+                         this, SLOT(returnToGame()));
+        QObject::connect(&m_scoreStore, SIGNAL(snapshotReady(ScoreSnapshot)),
+                         m_scoreScreenPtr, SLOT(setSnapshot(ScoreSnapshot)));
+        QObject::connect(m_scoreScreenPtr, SIGNAL(pageWanted(int, int)),
+                         &m_scoreStore, SLOT(fetchPage(int, int)));
+        QObject::connect(&m_scoreStore, SIGNAL(pageReady(int, QList<HighScoreData>, int)),
+                         m_scoreScreenPtr, SLOT(setPage(int, QList<HighScoreData>, int)));
+        m_scoreScreenPtr->setSnapshot(m_scoreStore.snapshot());
+        m_centralTopLayoutPtr->addWidget(m_scoreScreenPtr);     // HIGH_SCORE_PAGE
+    }
+    m_centralTopLayoutPtr->setCurrentIndex(HIGH_SCORE_PAGE);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: enableLatencyMonitor()
+ *   Start measuring input-to-display latency.  F9 shows the histograms so far;
+ *   each game's are appended to dotGameLatency.txt when it ends.
 *******************************************************************************/
-void MainWindow::updateDistStatusBar(const float errorDistRatio, const uint elapsedGameTime)
+void MainWindow::enableLatencyMonitor()
 {
-    float gameRatio = errorDistRatio / DotWidget::CURSOR_DISTANCE_GAMEOVER;
-    m_followingDistStatusBarPtr->updateValues(gameRatio, elapsedGameTime);
+    if (m_latencyMonitorPtr == NULL)
+    {
+        m_latencyMonitorPtr = new LatencyMonitor(this);
+        m_dotGameWidgetPtr->setLatencyMonitor(m_latencyMonitorPtr);
+        new QShortcut(QKeySequence(Qt::Key_F9), this, SLOT(showLatencyReport()));
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: playReplay()
+ *   @param fileName Replay saved at the end of an earlier game.
+ *   @param fullSpeed Play as fast as possible rather than in real time.
+*******************************************************************************/
+bool MainWindow::playReplay(const QString &fileName, bool fullSpeed)
+{
+    m_centralTopLayoutPtr->setCurrentIndex(GAME_QML_PAGE);
+    return m_dotGameWidgetPtr->playReplay(fileName, fullSpeed);
+}
+
+/** ****************************************************************************
+ * Function: showLatencyReport()
+ *
+*******************************************************************************/
+void MainWindow::showLatencyReport()
+{
+    if (m_latencyMonitorPtr != NULL)
+    {
+        QMessageBox::information(this, tr("Latency"),
+                                 "<pre>" + m_latencyMonitorPtr->report() + "</pre>");
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: exportFrameTimings()
+ *   Save the frame timings collected while the performance overlay was shown,
+ *   to compare machines.
+*******************************************************************************/
+void MainWindow::exportFrameTimings()
+{
+    m_dotGameWidgetPtr->frameProfiler()->writeCsv("dotGameFrames.csv");
+    return;
+}
+
+/** ****************************************************************************
+ * Function: updateGameState()
+ *  Called once per frame the game changed.  Each view only hears about the
+ *  parts it shows, and only when they changed: the status bar gets each stat
+ *  update (its history has one value per update), the QML dot gets dot moves,
+ *  and the game's sprite when the dot size or skin changes.
+ *    @param state The error ratio in it is the number of dot movement distances
+ *      the cursor is away; it is normalized before sending to the StatusBar.
+*******************************************************************************/
+void MainWindow::updateGameState(const GameStateSnapshot &state)
+{
+    if ((state.statUpdates != m_shownGameState.statUpdates) ||
+        (state.elapsedTime != m_shownGameState.elapsedTime))
+    {
+        float gameRatio = state.errorRatio / GameSim::CURSOR_DISTANCE_GAMEOVER;
+        m_followingDistStatusBarPtr->updateValues(gameRatio, state.elapsedTime);
+    }
+    if (((state.dotSize != m_shownGameState.dotSize) || (state.skin != m_shownGameState.skin)) &&
+        (m_qmlDotPtr != NULL))
+    {
+        m_qmlDotPtr->setSprite(m_dotGameWidgetPtr->getDotSprite());
+    }
+    if ((state.dotPos != m_shownGameState.dotPos) && (m_qmlDotPtr != NULL))
+    {
+        m_qmlDotPtr->setCenter(state.dotPos);
+    }
+    m_shownGameState = state;
     return;
 }
 
@@ -246,7 +458,7 @@ void MainWindow::setTimedGame()
 *******************************************************************************/
 void MainWindow::setInfiniteGame()
 {
-    m_dotGameWidgetPtr->setTimeLimit(INFINITE);
+    m_dotGameWidgetPtr->setTimeLimit(GameSim::INFINITE_TIME);
     return;
 }
 
@@ -271,138 +483,106 @@ void MainWindow::returnToGame()
 void MainWindow::gameOver(const gameOverReason reason)
 {
     Q_UNUSED(reason);
-    // End Game activities (timers, dot motion, status bar updates, etc)
-    updateDistStatusBar(m_dotGameWidgetPtr->getErrorRatio(),
-                        m_dotGameWidgetPtr->getElapsedTime());
-    uint newScore = m_dotGameWidgetPtr->getScore();
-    //qDebug("MainWindow::gameOver: newScore:%i", newScore);
-
-    // read the m_score file of previous High m_scores
-    QString fileName = "dotGameScores.txt";
-    QFile file(fileName);
-    QTextStream stream(&file);
-    if (m_highScoreList.size() == 0)  // if the file has not been read already.
-    {
-        if(!file.open(QIODevice::ReadWrite | QIODevice::Text))
-        {
-            qDebug("MainWindow::gameOver: Failed to open score File.");
-            return;
-        }
-        updateHighScoreListFromFile(stream);
-        file.close();
-    }
-
-    // Does the new m_score qualify for the High Score List?
-    if (m_highScoreList.size() == 0)
+    if (m_latencyMonitorPtr != NULL)
     {
-        addHighScore(0, newScore);
+        m_latencyMonitorPtr->writeReport("dotGameLatency.txt");
     }
-    else
-    {
-        for (int i = 0; i < m_highScoreList.size(); ++i)
-        {
-            if (newScore > m_highScoreList[i].score)
-            {
-                // Made the High Score List!
-                addHighScore(i, newScore);
-                break;   // exit the for loop, don't touch the other m_scores.
-            }
-            else if ((i >= (m_highScoreList.size()-1)) &&
-                     (m_highScoreList.size() < NUM_HIGH_SCORES_MAX))
-            {
-                /* newm_score does not beat any m_score in the list, but there is room
-                 *   to add another m_score to the list. */
-                addHighScore(i+1, newScore);
-                break;   // exit the for loop
-            }
-        } // for each m_score in the list
-    } // if listSize==0
-
-    // save the new QList of scores back to the file. (every time)
-    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    // End Game activities (timers, dot motion, etc); the final game state
+    //    was published just before, so the status bar already shows it.
+    if (m_dotGameWidgetPtr->isReplaying())
     {
-        qDebug("MainWindow::gameOver: Failed to open score File.");
-        return;
+        return;     // a replayed game already had its score entered
     }
-    writeScoreFile(stream);
-    stream.flush();    // make sure that the stream's write buffer is written to the file.
-    file.close();
+    uint newScore = m_dotGameWidgetPtr->getScore();
+    //qDebug("MainWindow::gameOver: newScore:%i", newScore);
+
+    /* No file I/O here: the game is handed to the score thread, and the
+     * table shows it straight away from memory. */
+    HighScoreData scoreData = {QLatin1String(ANONYMOUS_PLAYER_NAME), newScore, m_dotGameWidgetPtr->getElapsedTime(),
+                               m_dotGameWidgetPtr->getDotSize(),
+                               m_dotGameWidgetPtr->getDotSpeed()};
+    m_finishedGames.append(scoreData);
+    m_scoreStore.load();        // only if the preload failed: try again
 
     // draw the high m_score table, maybe just by changing what is shown/hidden.
-    m_centralTopLayoutPtr->setCurrentIndex(HIGH_SCORE_PAGE);
+    showScoreScreen();
     //configDotDockPtr->hide();
+    saveFinishedGames();
 
     return;
 }
 
 /** ****************************************************************************
- * Function: updateHighScoreListFromFile()
- *
+ * Function: scoresLoaded()
+ *   Finishes any game over that was waiting for the table.  If it couldn't be
+ *   read, the games are still shown, and saving them is tried anyway.
 *******************************************************************************/
-bool MainWindow::updateHighScoreListFromFile(QTextStream &scoreStream)
+void MainWindow::scoresLoaded(bool ok)
 {
-    HighScoreData dataRow;
-    scoreStream.skipWhiteSpace();
-    while (!scoreStream.atEnd())
+    if (!ok)
     {
-        scoreStream >> dataRow.name >> dataRow.score >> dataRow.gameTimeLength
-                    >> dataRow.dotDiam >> dataRow.maxSpeed;
-        m_highScoreList.append(dataRow);
-        scoreStream.skipWhiteSpace();
+        statusBar()->showMessage(tr("High scores could not be read."), SCORE_MESSAGE_TIMEOUT_MS);
     }
-    return true;
+    saveFinishedGames();
+    return;
 }
 
 /** ****************************************************************************
- * Function: writeScoreFile()
- *
+ * Function: saveFinishedGames()
+ *     Every game is kept; a name is only asked for if it makes the table.
+ *     The others stay ANONYMOUS_PLAYER_NAME: on a shared machine the last
+ *     name typed is probably someone else's.
+ *     Waits for the table without blocking: if it hasn't been read yet, this
+ *     is called again when it has.
 *******************************************************************************/
-bool MainWindow::writeScoreFile(QTextStream &scoreStream) const
+void MainWindow::saveFinishedGames()
 {
-    HighScoreData dataRow = {"", 0, 0, 0, 0};
-    foreach (dataRow, m_highScoreList)
+    if (!m_scoreStore.isReady() || m_finishedGames.isEmpty())
     {
-        if ((dataRow.name != "") && (dataRow.name != "\n"))    // verify that the next list entry is not empty
+        return;
+    }
+    // the name dialog runs an event loop, which may call back in here
+    QList<HighScoreData> games;
+    games.swap(m_finishedGames);
+    foreach (HighScoreData scoreData, games)
+    {
+        if (m_scoreStore.snapshot().tableRank(scoreData.score) < NUM_HIGH_SCORES_MAX)
         {
-            scoreStream << dataRow.name << " " << dataRow.score << " "
-                        << dataRow.gameTimeLength << " " << dataRow.dotDiam
-                        << " " << dataRow.maxSpeed << "\n";
+            // Made the High Score List!
+            scoreData.name = askPlayerName();
         }
+        m_scoreStore.addGame(scoreData);
     }
-    return true;
+    return;
 }
 
 /** ****************************************************************************
- * Function: addHighm_score()
- *     Prompt the user for their name, then add an item to the list with their
- *     name and relevant data.  Chop off the last item in the list if necessary.
+ * Function: askPlayerName()
+ *     Prompt the user for their name.  The dialog starts empty: a name is
+ *     never carried over from the previous game.
+ *   @return The name, or ANONYMOUS_PLAYER_NAME if the user cancelled or
+ *     entered none.
 *******************************************************************************/
-void MainWindow::addHighScore(int index, uint newScore)
+QString MainWindow::askPlayerName()
 {
     bool ok;
     QString nameText = QInputDialog::getText(this, tr("New High m_score!"),
                                              tr("Please Enter Your Name:"),
                                              QLineEdit::Normal,
-                                             "name", &ok);
-    if (ok && !nameText.isEmpty())
+                                             QString(), &ok);
+    /* Entered name could contain spaces, tabs, newlines.
+     *    Bad for reading/writing space-seperated file.  '<' is kept for
+     *    the anonymous name. */
+    nameText.replace(QRegExp("[ \t\n\r<]"), "_");
+    if (!ok || nameText.isEmpty())
     {
-        /* Entered name could contain spaces, tabs, newlines.
-         *    Bad for reading/writing space-seperated file.  */
-        nameText.replace(QRegExp("[ \t\n\r]"), "_");
-        if (nameText.size() > MAX_NAME_STRING_LEN)
-        {
-            nameText.resize(MAX_NAME_STRING_LEN);
-        }
-        HighScoreData scoreData = {nameText,newScore,m_dotGameWidgetPtr->getElapsedTime(),
-                                   m_dotGameWidgetPtr->getDotSize(),
-                                   m_dotGameWidgetPtr->getDotSpeed()};
-        m_highScoreList.insert(index,scoreData);
-        while (m_highScoreList.size() > NUM_HIGH_SCORES_MAX)
-        {
-            m_highScoreList.removeLast();
-        }
+        return QLatin1String(ANONYMOUS_PLAYER_NAME);
     }
-    return;
+    if (nameText.size() > MAX_NAME_STRING_LEN)
+    {
+        nameText.resize(MAX_NAME_STRING_LEN);
+    }
+    return nameText;
 }
 
 /** ****************************************************************************
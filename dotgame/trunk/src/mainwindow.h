@@ -33,8 +33,19 @@
 #include "dot.h"
 #include "dotwidget.h"
 #include "scorescreen.h"
+#include "scorestore.h"
 #include "gradienttextstatusbar.h"
+#include "latencymonitor.h"
 #include "qmlapplicationviewer.h"
+#include "dotdeclarative.h"
+#include "dotfielddeclarative.h"
+#include "startuptimeline.h"
+
+/// How the game area is put on the screen
+enum renderMode {
+    SINGLE_SURFACE_RENDERING = 0,   ///< field, dot and controls are items of the one QML view
+    LAYERED_RENDERING               ///< the DotWidget under the QML view, composited
+};
 
 /** ****************************************************************************
  * @class MainWindow
@@ -47,20 +58,35 @@ class MainWindow : public QMainWindow
 {
     Q_OBJECT
 public:
-    explicit MainWindow(QWidget *parent = 0);
+    explicit MainWindow(QWidget *parent = 0, renderMode mode = SINGLE_SURFACE_RENDERING,
+                        StartupTimeline *startupPtr = NULL);
     ~MainWindow();
 
-    /// Max number of high m_score entries to store and display
-    static const int NUM_HIGH_SCORES_MAX = 10;
+    /// Number of high m_score entries displayed; games ranked in it ask for a name
+    static const int NUM_HIGH_SCORES_MAX = ScoreScreen::TABLE_ROWS;
     /// HSV hue.  203=soft blue
     static const uint BACKGROUND_COLOR_DEFAULT = 203;
+    /// How long a score file problem is shown in the status bar
+    static const int SCORE_MESSAGE_TIMEOUT_MS = 5000;
+
+    /// Measure input-to-display latency; F9 shows it, game over saves it
+    void enableLatencyMonitor();
+
+    /// Play a recorded game; its score does not go on the high score list
+    bool playReplay(const QString &fileName, bool fullSpeed);
 
 protected:
+    virtual void showEvent(QShowEvent *event);
 
 private:
-    bool updateHighScoreListFromFile(QTextStream& scoreStream);
-    bool writeScoreFile(QTextStream& scoreStream) const;
-    void addHighScore(int index, uint newScore);
+    QString askPlayerName();
+    /// Connect the QML items and controls; nothing if main.qml didn't load
+    void setUpQmlScene(renderMode mode);
+    /// Show the high score page, making it the first time
+    void showScoreScreen();
+    void markStartup(startupStage stage);
+    /// Name and save the games that ended, once the table has been read
+    void saveFinishedGames();
     /* Private non-defined function prototypes disables compiler generation. */
     MainWindow(const MainWindow&);                // prevent copy operator
     MainWindow& operator=(const MainWindow&);     // prevent assignment operator
@@ -73,16 +99,32 @@ private:
     DotWidget *m_dotGameWidgetPtr;
     /// right-side Config control panel.
     QDockWidget *m_configDotDockPtr;
-    /// main area High Score Screen, swappable with dot game
+    /// main area High Score Screen, swappable with dot game; NULL until the first game over
     ScoreScreen *m_scoreScreenPtr;
     /// QML inclusion as a C++ widget
     QmlApplicationViewer* m_qmlViewerPtr;
+    /// the QML layer's own dot; NULL if the QML has none
+    DotDeclarative *m_qmlDotPtr;
+    /// the DotWidget's field in the QML scene; NULL when LAYERED_RENDERING
+    DotFieldDeclarative *m_dotFieldPtr;
     QSpinBox *m_timeSpinBoxPtr;
     /// dynamic graph bar showing distance between mouse and dot location
     GradientTextStatusBar *m_followingDistStatusBarPtr;
-    QList<HighScoreData> m_highScoreList;
+    /// game state last passed on to the status bar and the QML
+    GameStateSnapshot m_shownGameState;
+    /// every game played, ranked; read and written on its own thread
+    ScoreStore m_scoreStore;
+    /// games that ended before the table was read; saved once it is
+    QList<HighScoreData> m_finishedGames;
+    /// input-to-display latency measurement, NULL unless enabled
+    LatencyMonitor *m_latencyMonitorPtr;
+    /// startup stages are marked in it, NULL unless timed
+    StartupTimeline *m_startupPtr;
+    /// has the dot been put in the middle of the shown game area?
+    bool m_dotGameInitialized;
 public slots:
-    void updateDistStatusBar(const float errorDistRatio, const uint elapsedGameTime);
+    /// Pass the frame's game state on to the views that show it
+    void updateGameState(const GameStateSnapshot &state);
     void setTimedGame();
     void setInfiniteGame();
     /// Switches MainWindow to show Highm_score screen.
@@ -91,6 +133,12 @@ public slots:
     void returnToGame();
     /// QML screen has been clicked, transfer action to C++
     void qmlClicked();
+    /// Reading the score table has finished, well or not
+    void scoresLoaded(bool ok);
+    /// Show the latency histograms measured so far
+    void showLatencyReport();
+    /// Save the performance overlay's frame timings as CSV
+    void exportFrameTimings();
 };
 
 #endif // MAINWINDOW_H
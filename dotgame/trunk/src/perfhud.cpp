@@ -0,0 +1,142 @@
+/** ****************************************************************************
+ * @file perfhud.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The PerfHud is the performance overlay of the DotWidget: a table of rolling
+ * p50/p95/p99 times per frame section and a graph of recent frame times, as
+ * measured by the FrameProfiler.  It is rendered into a cached layer a few
+ * times a second, so drawing it every frame is a single blit.
+ *
+ ******************************************************************************/
+
+#include "perfhud.h"
+#include <QtGui/QFontMetrics>
+#include <QtGui/QColor>
+#include <stdio.h>            // for snprintf()
+
+/// Size of the overlay parts, in pixels
+static const int HUD_MARGIN = 4;
+static const int HUD_GRAPH_HEIGHT = 60;
+/// Frame time at the top of the graph, in us
+static const int HUD_GRAPH_MAX_US = 50000;
+
+/** ****************************************************************************
+ * PerfHud Constructor
+*******************************************************************************/
+PerfHud::PerfHud() :
+    m_topLeft(10, 10)
+{
+    m_font.setPointSize(8);
+    m_font.setFamily("Courier");        // use a fixed-width font
+}
+
+/** ****************************************************************************
+ * Function: refresh()
+ *   Called every frame; only renders every REFRESH_INTERVAL_MS.
+ *   @param signalDeliveriesPerSecond Game state deliveries, shown under the table
+ *   @param missedDeadlines Late frames so far this game, shown under the table
+ *   @param droppedSimTimeMs Game time skipped so far this game, in ms
+*******************************************************************************/
+bool PerfHud::refresh(const FrameProfiler &profiler, uint signalDeliveriesPerSecond,
+                      uint missedDeadlines, uint droppedSimTimeMs)
+{
+    if (!m_layer.isNull() && m_layerAge.isValid() && (m_layerAge.elapsed() < REFRESH_INTERVAL_MS))
+    {
+        return false;
+    }
+    render(profiler, signalDeliveriesPerSecond, missedDeadlines, droppedSimTimeMs);
+    m_layerAge.start();
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: paint()
+ *
+*******************************************************************************/
+void PerfHud::paint(QPainter *painter) const
+{
+    if (!m_layer.isNull())
+    {
+        painter->drawPixmap(m_topLeft, m_layer);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: render()
+ *   Table: one line per section, p50/p95/p99 in ms over the rolling window,
+ *   then the game state deliveries per second and the game's missed deadlines
+ *   and dropped time.
+ *   Graph: one column per recent frame, red when over the frame budget.
+*******************************************************************************/
+void PerfHud::render(const FrameProfiler &profiler, uint signalDeliveriesPerSecond,
+                     uint missedDeadlines, uint droppedSimTimeMs)
+{
+    const QFontMetrics metrics(m_font);
+    const int lineHeight = metrics.height();
+    const int graphWidth = FrameProfiler::ROLLING_FRAMES;
+    const int tableLines = SECTION_COUNT + 4;
+    const QSize layerSize(graphWidth + 2*HUD_MARGIN,
+                          tableLines*lineHeight + HUD_GRAPH_HEIGHT + 3*HUD_MARGIN);
+    if (m_layer.size() != layerSize)
+    {
+        m_layer = QPixmap(layerSize);
+    }
+    m_layer.fill(QColor(0, 0, 0, 160));
+
+    QPainter painter(&m_layer);
+    painter.setFont(m_font);
+    painter.setPen(Qt::white);
+    const size_t LINE_TEXT_SIZE = 64;
+    char lineText[LINE_TEXT_SIZE];
+    int textY = HUD_MARGIN + metrics.ascent();
+    snprintf(lineText, LINE_TEXT_SIZE, "%-13s %6s %6s %6s", "ms", "p50", "p95", "p99");
+    painter.drawText(HUD_MARGIN, textY, lineText);
+    const double USEC_IN_MSEC = 1000.0;
+    for (int section = 0; section < SECTION_COUNT; ++section)
+    {
+        textY += lineHeight;
+        const frameSection thisSection = static_cast<frameSection>(section);
+        snprintf(lineText, LINE_TEXT_SIZE, "%-13s %6.2f %6.2f %6.2f",
+                 FrameProfiler::SECTION_NAMES[section],
+                 profiler.percentile(thisSection, 50.0) / USEC_IN_MSEC,
+                 profiler.percentile(thisSection, 95.0) / USEC_IN_MSEC,
+                 profiler.percentile(thisSection, 99.0) / USEC_IN_MSEC);
+        painter.drawText(HUD_MARGIN, textY, lineText);
+    }
+    textY += lineHeight;
+    snprintf(lineText, LINE_TEXT_SIZE, "%-13s %6u", "signals/s", signalDeliveriesPerSecond);
+    painter.drawText(HUD_MARGIN, textY, lineText);
+    textY += lineHeight;
+    snprintf(lineText, LINE_TEXT_SIZE, "%-13s %6u", "missed frames", missedDeadlines);
+    painter.drawText(HUD_MARGIN, textY, lineText);
+    textY += lineHeight;
+    snprintf(lineText, LINE_TEXT_SIZE, "%-13s %6u", "dropped ms", droppedSimTimeMs);
+    painter.drawText(HUD_MARGIN, textY, lineText);
+
+    // frame-time graph, newest frame on the right
+    const int graphBottom = layerSize.height() - HUD_MARGIN;
+    const QVector<FrameTiming> frames = profiler.recentFrames();
+    const int firstX = HUD_MARGIN + graphWidth - frames.size();
+    for (int frameNum = 0; frameNum < frames.size(); ++frameNum)
+    {
+        const qint64 frameUs = frames[frameNum].us[SECTION_FRAME];
+        int barHeight = (qMin(frameUs, qint64(HUD_GRAPH_MAX_US)) * HUD_GRAPH_HEIGHT) / HUD_GRAPH_MAX_US;
+        painter.setPen((frameUs > FRAME_BUDGET_US) ? Qt::red : Qt::green);
+        painter.drawLine(firstX + frameNum, graphBottom, firstX + frameNum, graphBottom - barHeight);
+    }
+    const int budgetY = graphBottom - (FRAME_BUDGET_US * HUD_GRAPH_HEIGHT) / HUD_GRAPH_MAX_US;
+    painter.setPen(Qt::yellow);
+    painter.drawLine(HUD_MARGIN, budgetY, HUD_MARGIN + graphWidth, budgetY);
+    return;
+}
@@ -0,0 +1,81 @@
+/** ****************************************************************************
+ * @file perfhud.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The PerfHud is the performance overlay of the DotWidget: a table of rolling
+ * p50/p95/p99 times per frame section and a graph of recent frame times, as
+ * measured by the FrameProfiler, plus the game loop's missed deadlines.  It is
+ * rendered into a cached layer a few times a second, so drawing it every frame
+ * is a single blit.
+ *
+ ******************************************************************************/
+
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPoint>
+#include <QtCore/QRect>
+#include <QtGui/QFont>
+#include <QtGui/QPixmap>
+#include <QtGui/QPainter>
+#include "frameprofiler.h"
+
+/** ****************************************************************************
+ * @class PerfHud
+ *   Cached overlay of FrameProfiler data.
+*******************************************************************************/
+class PerfHud
+{
+public:
+    PerfHud();
+
+    /// Re-render the layer if it is due.  @return true if it changed
+    bool refresh(const FrameProfiler &profiler, uint signalDeliveriesPerSecond,
+                 uint missedDeadlines, uint droppedSimTimeMs);
+    /// Draw the cached layer
+    void paint(QPainter *painter) const;
+    /// Area covered by the overlay
+    inline QRect rect() const;
+
+    /// How often the layer is re-rendered
+    static const int REFRESH_INTERVAL_MS = 250;
+    /// Frame time budget drawn as a line in the graph, in us (60 Hz)
+    static const int FRAME_BUDGET_US = 16667;
+
+private:
+    /// Draw the table and graph into m_layer
+    void render(const FrameProfiler &profiler, uint signalDeliveriesPerSecond,
+                uint missedDeadlines, uint droppedSimTimeMs);
+
+    /// The rendered overlay
+    QPixmap m_layer;
+    /// Time since m_layer was rendered
+    QElapsedTimer m_layerAge;
+    /// Position of the overlay within the widget
+    QPoint m_topLeft;
+    /// Fixed-width font for the table
+    QFont m_font;
+};
+
+
+/** ****************************************************************************
+ * Function: rect()
+ *
+*******************************************************************************/
+inline QRect PerfHud::rect() const
+{
+    return QRect(m_topLeft, m_layer.size());
+}
+
+#endif // PERFHUD_H
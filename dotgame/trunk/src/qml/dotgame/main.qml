@@ -1,7 +1,6 @@
 // import QtQuick 1.0 // to target S60 5th Edition or Maemo 5
 import QtQuick 1.1
-//import QtItems 1.0
-import Qt 4.7    // 4.8
+import QtItems 1.0    // GameDot, QSlider
 //import com.nokia.symbian 1.8
 
 Rectangle {
@@ -19,11 +18,6 @@ Rectangle {
             color: "#96000000"
         }
     }
-    function updateDotLoc(location)    // slot
-    {
-        dot.x = location.x - (dot.width/2);
-        dot.y = location.y - (dot.height/2);
-    }
     signal screenClicked();
     signal setTimeLimit(int time);
 
@@ -40,15 +34,16 @@ Rectangle {
         }
     }
 
-    // Use a Rectangle with curved corners to create a circle, for the dot.
-    Rectangle {
+    // The dot, moved from C++ (MainWindow::updateGameState) without any script.
+    // C++ also gives it the game's own sprite, so its size and skin follow the
+    // game; the size and colors here only show until then.
+    GameDot {
         id: dot
+        objectName: "dot"
         width: 40
         height: 40
         color: "#0ef572"
-        radius: width / 2
-        border.color: "#000000"
-        //onNewDotPos: console.log("NewDotPos")
+        borderColor: "#000000"
     }
 
     Rectangle {
@@ -71,6 +66,42 @@ Rectangle {
             }
         }
 
+        // Speed and size sliders; ranges and values are set, and connected to
+        //    the game, by MainWindow.  Drawn from a cache; dragged with the mouse.
+        Text {
+            id: speed_slider_text
+            x: 10
+            y: 10
+            text: "Speed"
+            font.pointSize: 6
+        }
+
+        QSlider {
+            id: speed_slider
+            objectName: "speedSlider"
+            x: 10
+            y: speed_slider_text.y + speed_slider_text.height
+            width: 80
+            height: 20
+        }
+
+        Text {
+            id: size_slider_text
+            x: 10
+            y: speed_slider.y + speed_slider.height + 10
+            text: "Size"
+            font.pointSize: 6
+        }
+
+        QSlider {
+            id: size_slider
+            objectName: "sizeSlider"
+            x: 10
+            y: size_slider_text.y + size_slider_text.height
+            width: 80
+            height: 20
+        }
+
         Rectangle {
             id: timed_button
             x: 10
@@ -144,7 +175,7 @@ Rectangle {
                 id: infinite_button_mousearea
                 anchors.fill: parent
                 onClicked: {
-                    setTimeLimit(0);  // 0 sec = INFINITE game
+                    setTimeLimit(0);  // 0 sec = infinite game
                 }
             }
         } // infinite_button rectangle
@@ -2,7 +2,7 @@
  * @file qsliderdeclarative.cpp
  * @author Jeremy Hannon <hje@zuhlke.com>
  * @version 0.5
- * @date July 16th, 2012
+ * @date October 16th, 2026
  * Created: July 16th, 2012
  *
  * @section LICENSE
@@ -12,33 +12,76 @@
  * The DotGame is a Qt application involving a randomly walking dot that the
  * user tries to closely follow with their cursor to achieve a high score.
  *
- * (local explanation goes here.)
+ * The QSliderDeclarative: a QSlider drawn from a cached pixmap in the QML
+ * scene, and driven by the mouse events the item gets.
  *
  ******************************************************************************/
 
 #include "qsliderdeclarative.h"
+#include <QtGui/QApplication>
+#include <QtGui/QPainter>
+#include <QtGui/QMouseEvent>
+#include <QtGui/QWheelEvent>
+#include <QtGui/QGraphicsSceneMouseEvent>
+#include <QtGui/QGraphicsSceneWheelEvent>
 
+/** ****************************************************************************
+ * QSliderDeclarative Constructor
+ *   The slider is never shown; it is only rendered and sent events.
+ ******************************************************************************/
 QSliderDeclarative::QSliderDeclarative(QDeclarativeItem *parent) :
     QDeclarativeItem(parent),
     slider(Qt::Horizontal)
 {
     setFlag(QGraphicsItem::ItemHasNoContents, false);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    slider.installEventFilter(this);    // style and palette changes
     QObject::connect(&slider, SIGNAL(valueChanged(int)),
-                     this, SIGNAL(valueChanged(int)));
+                     this, SLOT(sliderValueChanged(int)));
 }
 
 /** ****************************************************************************
- * Function: gameOver()
- *   MainWindow gets informed by dotGameWidget that game is over.
+ * Function: paint()
+ *   Renders the slider only if it changed since the last paint, then blits.
 *******************************************************************************/
 void QSliderDeclarative::paint(QPainter *painter,
            const QStyleOptionGraphicsItem *option,
            QWidget *widget)
 {
-    //qDebug("QSliderDeclarative::paint: function called.");
-    //painter->save();  // save existing painter settings
-    slider.render(painter);
-    //painter->restore();  // restore painter settings to how they were.
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    if (slider.width() <= 0 || slider.height() <= 0)
+    {
+        return;
+    }
+    if (m_sliderPixmap.isNull())
+    {
+        m_sliderPixmap = QPixmap(slider.size());
+        m_sliderPixmap.fill(Qt::transparent);
+        // no window background: the QML under the slider shows through
+        slider.render(&m_sliderPixmap, QPoint(), QRegion(), QWidget::DrawChildren);
+    }
+    painter->drawPixmap(0, 0, m_sliderPixmap);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setMinimum()
+ *
+*******************************************************************************/
+void QSliderDeclarative::setMinimum(int min)
+{
+    setRange(min, qMax(min, slider.maximum()));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setMaximum()
+ *
+*******************************************************************************/
+void QSliderDeclarative::setMaximum(int max)
+{
+    setRange(qMin(slider.minimum(), max), max);
     return;
 }
 
@@ -48,18 +91,147 @@ void QSliderDeclarative::paint(QPainter *painter,
 *******************************************************************************/
 void QSliderDeclarative::setRange(int min, int max)
 {
-
+    if ((min == slider.minimum()) && (max == slider.maximum()))
+    {
+        return;
+    }
     slider.setRange(min,max);
+    invalidatePixmap();
+    emit rangeChanged();
     return;
 }
 
 /** ****************************************************************************
  * Function: setValue()
- *   Wrapper function for QSlider object.
+ *   Wrapper function for QSlider object.  The slider only signals (and is
+ *   only rendered again) if the value changes.
 *******************************************************************************/
 void QSliderDeclarative::setValue(int newValue)
 {
     slider.setValue(newValue);
-    //emit valueChanged(newValue);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: sliderValueChanged()
+ *   Set from C++, QML, or dragged with the mouse.
+*******************************************************************************/
+void QSliderDeclarative::sliderValueChanged(int newValue)
+{
+    invalidatePixmap();
+    emit valueChanged(newValue);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: invalidatePixmap()
+ *
+*******************************************************************************/
+void QSliderDeclarative::invalidatePixmap()
+{
+    if (!m_sliderPixmap.isNull())
+    {
+        m_sliderPixmap = QPixmap();
+        update();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: geometryChanged()
+ *   The slider is laid out at the item's size.
+*******************************************************************************/
+void QSliderDeclarative::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QDeclarativeItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+    {
+        slider.resize(newGeometry.size().toSize());
+        m_sliderPixmap = QPixmap();
+        update();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: eventFilter()
+ *   The slider's look changes with the application style, palette, font or
+ *   enabled state; those reach the hidden slider as events.
+*******************************************************************************/
+bool QSliderDeclarative::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == &slider)
+    {
+        switch (event->type())
+        {
+        case QEvent::StyleChange:
+        case QEvent::PaletteChange:
+        case QEvent::FontChange:
+        case QEvent::EnabledChange:
+        case QEvent::LayoutDirectionChange:
+            invalidatePixmap();
+            break;
+        default:
+            break;
+        }
+    }
+    return QDeclarativeItem::eventFilter(watched, event);
+}
+
+/** ****************************************************************************
+ * Function: sendMouseEvent()
+ *   The item's coordinates are the slider's, as it is drawn at (0,0).
+*******************************************************************************/
+void QSliderDeclarative::sendMouseEvent(QEvent::Type type, QGraphicsSceneMouseEvent *event)
+{
+    QMouseEvent mouseEvent(type, event->pos().toPoint(), event->screenPos(),
+                           event->button(), event->buttons(), event->modifiers());
+    QApplication::sendEvent(&slider, &mouseEvent);
+    event->setAccepted(mouseEvent.isAccepted());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: mousePressEvent()
+ *   Accepted, so the scene sends this item the moves and release that follow.
+*******************************************************************************/
+void QSliderDeclarative::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    sendMouseEvent(QEvent::MouseButtonPress, event);
+    invalidatePixmap();     // handle drawn pressed
+    return;
+}
+
+/** ****************************************************************************
+ * Function: mouseMoveEvent()
+ *   Repainted through sliderValueChanged() only if the value moves a step.
+*******************************************************************************/
+void QSliderDeclarative::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
+{
+    sendMouseEvent(QEvent::MouseMove, event);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: mouseReleaseEvent()
+ *
+*******************************************************************************/
+void QSliderDeclarative::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    sendMouseEvent(QEvent::MouseButtonRelease, event);
+    invalidatePixmap();     // handle drawn released
+    return;
+}
+
+/** ****************************************************************************
+ * Function: wheelEvent()
+ *
+*******************************************************************************/
+void QSliderDeclarative::wheelEvent(QGraphicsSceneWheelEvent *event)
+{
+    QWheelEvent wheelEvent(event->pos().toPoint(), event->screenPos(), event->delta(),
+                           event->buttons(), event->modifiers(), event->orientation());
+    QApplication::sendEvent(&slider, &wheelEvent);
+    event->setAccepted(wheelEvent.isAccepted());
     return;
 }
@@ -2,7 +2,7 @@
  * @file qsliderdeclarative.h
  * @author Jeremy Hannon <hje@zuhlke.com>
  * @version 0.5
- * @date July 16th, 2012
+ * @date October 16th, 2026
  * Created: July 16th, 2012
  *
  * @section LICENSE
@@ -12,7 +12,11 @@
  * The DotGame is a Qt application involving a randomly walking dot that the
  * user tries to closely follow with their cursor to achieve a high score.
  *
- * (local explanation goes here.)
+ * The QSliderDeclarative wraps a QSlider for QML ("QSlider" in "QtItems
+ * 1.0").  The slider is rendered into a pixmap only when its value, range,
+ * size or style changes; other repaints of the scene (e.g. every dot move)
+ * only blit it.  Mouse presses, moves and the wheel are passed on to the
+ * slider, so it can be dragged.
  *
  ******************************************************************************/
 
@@ -21,23 +25,83 @@
 
 #include <QDeclarativeItem>
 #include <QSlider>
+#include <QtGui/QPixmap>
 
 class QSliderDeclarative : public QDeclarativeItem
 {
     Q_OBJECT
+    Q_PROPERTY(int value READ value WRITE setValue NOTIFY valueChanged)
+    Q_PROPERTY(int minimum READ minimum WRITE setMinimum NOTIFY rangeChanged)
+    Q_PROPERTY(int maximum READ maximum WRITE setMaximum NOTIFY rangeChanged)
 public:
     explicit QSliderDeclarative(QDeclarativeItem *parent = 0);
     //virtual void paintEvent(QPaintEvent *event);
     void paint(QPainter *painter,
                const QStyleOptionGraphicsItem *option,
                QWidget *widget = 0);
+
+    inline int value() const;
+    inline int minimum() const;
+    inline int maximum() const;
+    void setMinimum(int min);
+    void setMaximum(int max);
+
+protected:
+    virtual void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry);
+    virtual bool eventFilter(QObject *watched, QEvent *event);
+    virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
+    virtual void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
+    virtual void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
+    virtual void wheelEvent(QGraphicsSceneWheelEvent *event);
 private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    QSliderDeclarative(const QSliderDeclarative&);
+    /// prevent assignment operator
+    QSliderDeclarative& operator=(const QSliderDeclarative&);
+
+    /// Pass a mouse event on to the slider, in its coordinates
+    void sendMouseEvent(QEvent::Type type, QGraphicsSceneMouseEvent *event);
+    /// The slider looks different: render it again at the next paint
+    void invalidatePixmap();
+
     QSlider slider;
+    /// The rendered slider; null until the first paint after a change
+    QPixmap m_sliderPixmap;
 signals:
     void valueChanged(int value);
+    void rangeChanged();
 public slots:
     void setRange(int min, int max);
     void setValue(int newValue);
+private slots:
+    void sliderValueChanged(int newValue);
 };
 
+
+/** ****************************************************************************
+ * Function: value()
+ *
+*******************************************************************************/
+inline int QSliderDeclarative::value() const
+{
+    return slider.value();
+}
+/** ****************************************************************************
+ * Function: minimum()
+ *
+*******************************************************************************/
+inline int QSliderDeclarative::minimum() const
+{
+    return slider.minimum();
+}
+/** ****************************************************************************
+ * Function: maximum()
+ *
+*******************************************************************************/
+inline int QSliderDeclarative::maximum() const
+{
+    return slider.maximum();
+}
+
 #endif // QSLIDERDECLARATIVE_H
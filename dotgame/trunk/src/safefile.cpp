@@ -0,0 +1,124 @@
+/** ****************************************************************************
+ * @file safefile.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Process-shared file locking, syncing and atomic replace, for the score
+ * files.
+ *
+ ******************************************************************************/
+
+#include "safefile.h"
+#include <QtCore/QFileInfo>
+#include <QtCore/QDir>
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <string.h>           // for memset()
+#include <io.h>               // for _get_osfhandle(), _commit()
+#else
+#include <sys/file.h>         // for flock()
+#include <fcntl.h>            // for open()
+#include <unistd.h>           // for fsync(), close()
+#include <stdio.h>            // for rename()
+#endif
+
+/** ****************************************************************************
+ * FileLock Constructor
+ *   Blocks until the lock is granted.
+ *   @param fileName File to lock; the lock itself is on "<fileName>.lock".
+ *   @param exclusive Exclusive for writing, shared for reading.
+*******************************************************************************/
+FileLock::FileLock(const QString &fileName, bool exclusive) :
+    m_lockFile(fileName + ".lock"), m_locked(false)
+{
+    if (!m_lockFile.open(QIODevice::ReadWrite))
+    {
+        qDebug("FileLock::FileLock: Can't open %s", qPrintable(m_lockFile.fileName()));
+        return;
+    }
+#ifdef Q_OS_WIN
+    OVERLAPPED overlapped;
+    memset(&overlapped, 0, sizeof(overlapped));
+    HANDLE lockHandle = reinterpret_cast<HANDLE>(_get_osfhandle(m_lockFile.handle()));
+    m_locked = (LockFileEx(lockHandle, exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0,
+                           0, 1, 0, &overlapped) != FALSE);
+#else
+    m_locked = (flock(m_lockFile.handle(), exclusive ? LOCK_EX : LOCK_SH) == 0);
+#endif
+    if (!m_locked)
+    {
+        qDebug("FileLock::FileLock: Can't lock %s", qPrintable(m_lockFile.fileName()));
+    }
+}
+
+/** FileLock Destructor */
+FileLock::~FileLock()
+{
+    if (m_locked)
+    {
+#ifdef Q_OS_WIN
+        OVERLAPPED overlapped;
+        memset(&overlapped, 0, sizeof(overlapped));
+        UnlockFileEx(reinterpret_cast<HANDLE>(_get_osfhandle(m_lockFile.handle())),
+                     0, 1, 0, &overlapped);
+#else
+        flock(m_lockFile.handle(), LOCK_UN);
+#endif
+    }
+}
+
+/** ****************************************************************************
+ * Function: syncFile()
+ *   Flush Qt's buffer and the OS cache, so the data is on disk.
+*******************************************************************************/
+bool syncFile(QFile &file)
+{
+    if (!file.flush())
+    {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return (_commit(file.handle()) == 0);
+#else
+    return (fsync(file.handle()) == 0);
+#endif
+}
+
+/** ****************************************************************************
+ * Function: replaceFile()
+ *   Atomically rename fromName over toName, which may exist.
+*******************************************************************************/
+bool replaceFile(const QString &fromName, const QString &toName)
+{
+#ifdef Q_OS_WIN
+    const QString fromNative = QDir::toNativeSeparators(fromName);
+    const QString toNative = QDir::toNativeSeparators(toName);
+    return (MoveFileExW(reinterpret_cast<const wchar_t *>(fromNative.utf16()),
+                        reinterpret_cast<const wchar_t *>(toNative.utf16()),
+                        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE);
+#else
+    if (::rename(QFile::encodeName(fromName).constData(),
+                 QFile::encodeName(toName).constData()) != 0)
+    {
+        return false;
+    }
+    // make the rename itself durable
+    const int dirFd = ::open(QFile::encodeName(QFileInfo(toName).absolutePath()).constData(),
+                             O_RDONLY);
+    if (dirFd >= 0)
+    {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+#endif
+}
@@ -0,0 +1,69 @@
+/** ****************************************************************************
+ * @file safefile.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * File primitives the score files need and Qt 4 lacks: an advisory lock
+ * shared between processes, syncing a file to disk, and atomically replacing
+ * one file with another.  flock()/fsync()/rename() on Unix, and
+ * LockFileEx()/_commit()/MoveFileEx() on Windows.
+ *
+ ******************************************************************************/
+
+#ifndef SAFEFILE_H
+#define SAFEFILE_H
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+/** ****************************************************************************
+ * @class FileLock
+ *   Holds an advisory lock on "<fileName>.lock" for as long as it exists.  A
+ *   separate lock file is used so the locked file itself can be replaced.
+*******************************************************************************/
+class FileLock
+{
+public:
+    /// Blocks until granted; exclusive for writing, shared for reading
+    FileLock(const QString &fileName, bool exclusive);
+    ~FileLock();
+
+    inline bool isLocked() const;
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    FileLock(const FileLock&);
+    /// prevent assignment operator
+    FileLock& operator=(const FileLock&);
+
+    QFile m_lockFile;
+    bool m_locked;
+};
+
+/// Flush Qt's buffer and the OS cache, so the data is on disk
+bool syncFile(QFile &file);
+
+/// Atomically rename fromName over toName, which may exist
+bool replaceFile(const QString &fromName, const QString &toName);
+
+
+/** ****************************************************************************
+ * Function: isLocked()
+ *   false if the lock file could not be opened or locked.
+*******************************************************************************/
+inline bool FileLock::isLocked() const
+{
+    return m_locked;
+}
+
+#endif // SAFEFILE_H
@@ -0,0 +1,88 @@
+/** ****************************************************************************
+ * @file scorejournal.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The ScoreJournal reads the high score file of older versions.
+ *
+ ******************************************************************************/
+
+#include "scorejournal.h"
+#include "safefile.h"
+#include <QtCore/QStringList>
+#include <QtCore/QRegExp>
+#include <QtCore/QtAlgorithms>
+
+/** ****************************************************************************
+ * Function: scoreGreaterThan()
+ *   Table order.  Used with a stable sort, so of equal scores the one that
+ *   got there first stays ahead.
+*******************************************************************************/
+static bool scoreGreaterThan(const HighScoreData &first, const HighScoreData &second)
+{
+    return first.score > second.score;
+}
+
+/** ****************************************************************************
+ * ScoreJournal Constructor
+ *  @param fileName Journal file; an old style score file is a valid journal.
+*******************************************************************************/
+ScoreJournal::ScoreJournal(const QString &fileName) :
+    m_fileName(fileName)
+{
+}
+
+/** ****************************************************************************
+ * Function: load()
+ *   A line without its newline is the remains of an append that was cut
+ *   short, and is ignored, as are lines that don't parse.  Read under a shared
+ *   lock, in case an older version is still writing it.
+ *   @param scores Every game in the file, best first.
+ *   @return true if the file was read or does not exist.
+*******************************************************************************/
+bool ScoreJournal::load(QList<HighScoreData> &scores)
+{
+    scores.clear();
+    QFile file(m_fileName);
+    if (!file.exists())
+    {
+        return true;
+    }
+    FileLock lock(m_fileName, false);
+    if (!lock.isLocked() || !file.open(QIODevice::ReadOnly))
+    {
+        qDebug("ScoreJournal::load: Can't open %s", qPrintable(m_fileName));
+        return false;
+    }
+    QByteArray journal = file.readAll();
+    journal.truncate(journal.lastIndexOf('\n') + 1);
+    const QList<QByteArray> lines = journal.split('\n');
+    foreach (const QByteArray &line, lines)
+    {
+        const QStringList fields = QString::fromUtf8(line.constData(), line.size())
+                .split(QRegExp("[ \t\r]"), QString::SkipEmptyParts);
+        if (fields.isEmpty())
+        {
+            continue;
+        }
+        bool scoreOk, timeOk, diamOk, speedOk;
+        HighScoreData entry = {fields.value(0), fields.value(1).toUInt(&scoreOk),
+                               fields.value(2).toUInt(&timeOk), fields.value(3).toUInt(&diamOk),
+                               fields.value(4).toUInt(&speedOk)};
+        if ((fields.size() == 5) && scoreOk && timeOk && diamOk && speedOk)
+        {
+            scores.append(entry);
+        }
+    }
+    qStableSort(scores.begin(), scores.end(), scoreGreaterThan);
+    return true;
+}
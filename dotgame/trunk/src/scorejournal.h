@@ -0,0 +1,65 @@
+/** ****************************************************************************
+ * @file scorejournal.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The ScoreJournal reads the high score file of older versions: one "name
+ * score time diameter speed" line per game, either a plain table or an
+ * append-only journal that hadn't been compacted yet.  The Leaderboard now
+ * keeps every game; the journal is only read, once, to import all of its
+ * games.
+ *
+ ******************************************************************************/
+
+#ifndef SCOREJOURNAL_H
+#define SCOREJOURNAL_H
+
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include "scorescreen.h"      // for HighScoreData
+
+/** ****************************************************************************
+ * @class ScoreJournal
+ *   Reader for the legacy high score file.
+*******************************************************************************/
+class ScoreJournal
+{
+public:
+    explicit ScoreJournal(const QString &fileName);
+
+    /// Read every game in the file, best first
+    bool load(QList<HighScoreData> &scores);
+
+    inline const QString &fileName() const;
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    ScoreJournal(const ScoreJournal&);
+    /// prevent assignment operator
+    ScoreJournal& operator=(const ScoreJournal&);
+
+    /// The legacy score file
+    QString m_fileName;
+};
+
+
+/** ****************************************************************************
+ * Function: fileName()
+ *
+*******************************************************************************/
+inline const QString &ScoreJournal::fileName() const
+{
+    return m_fileName;
+}
+
+#endif // SCOREJOURNAL_H
@@ -20,18 +20,87 @@
 #include "scorescreen.h"
 #include <QtGui/QPainter>
 #include <QtGui/QPaintEvent>
+#include <QtGui/QWheelEvent>
+#include <QtGui/QScrollBar>
 #include <QtGui/QFont>
 #include <stdio.h>            // for snprintf()
 
+/// Wheel rotation per row scrolled; one notch (120) is three rows
+static const int WHEEL_DELTA_PER_ROW = 40;
+
+/** ****************************************************************************
+ * Function: operator==()
+ *
+ ******************************************************************************/
+bool operator==(const HighScoreData &left, const HighScoreData &right)
+{
+    return (left.score == right.score) && (left.gameTimeLength == right.gameTimeLength) &&
+            (left.dotDiam == right.dotDiam) && (left.maxSpeed == right.maxSpeed) &&
+            (left.name == right.name);
+}
+
+/** ****************************************************************************
+ * ScoreSnapshot Constructor
+ *   An empty table.
+ ******************************************************************************/
+ScoreSnapshot::ScoreSnapshot() :
+    gameCount(0), lastGameRank(0), lastGamePartitionRank(0), lastGamePartitionCount(0)
+{
+    lastGame.score = 0;
+    lastGame.gameTimeLength = 0;
+    lastGame.dotDiam = 0;
+    lastGame.maxSpeed = 0;
+}
+
+/** ****************************************************************************
+ * Function: tableRank()
+ *   Equal scores rank in the order they were played, so a new game goes
+ *   after them.  A result of topGames.size() or more means off the table.
+ ******************************************************************************/
+int ScoreSnapshot::tableRank(uint score) const
+{
+    int ahead = 0;
+    while ((ahead < topGames.size()) && (topGames[ahead].score >= score))
+    {
+        ahead++;
+    }
+    return ahead;
+}
+
+/** ****************************************************************************
+ * Function: withGame()
+ *   Only the table can be updated; the ranks under it stay unknown until the
+ *   leaderboard has the game.  A game in the table has the same rank overall.
+ ******************************************************************************/
+ScoreSnapshot ScoreSnapshot::withGame(const HighScoreData &game, int tableRows) const
+{
+    ScoreSnapshot newSnapshot(*this);
+    const int ahead = tableRank(game.score);
+    if (ahead < tableRows)
+    {
+        newSnapshot.topGames.insert(ahead, game);
+    }
+    while (newSnapshot.topGames.size() > tableRows)
+    {
+        newSnapshot.topGames.removeLast();
+    }
+    newSnapshot.gameCount++;
+    newSnapshot.lastGame = game;
+    newSnapshot.lastGameRank = (ahead < tableRows) ? (ahead + 1) : 0;
+    newSnapshot.lastGamePartitionRank = 0;
+    newSnapshot.lastGamePartitionCount = 0;
+    return newSnapshot;
+}
+
 /** ****************************************************************************
  * m_scoreScreen Constructor
  *   @param parent Pointer to the parent window widget
- *   @param highm_scoreListPtr Pointer to the List holding all of the current high
- *      m_score values. As the list is updated, m_scoreScreen can redraw the info.
  ******************************************************************************/
-ScoreScreen::ScoreScreen(QWidget *parent, const QList<HighScoreData>* const highScoreListPtr) :
+ScoreScreen::ScoreScreen(QWidget *parent) :
     QWidget(parent),
-    m_highScoreListPtr(highScoreListPtr), m_backgroundBrush(QBrush(QColor(Qt::blue)))
+    m_backgroundBrush(QBrush(QColor(Qt::blue))), m_highlightBrush(QColor(255, 255, 255, 64)),
+    m_tableVersion(1), m_tableLayerVersion(0),
+    m_scrollBarPtr(NULL), m_firstRank(0), m_pages(PAGE_CACHE_PAGES)
 {
     m_parentWinPtr = parent;
     m_textFontScores.setPointSize(8);
@@ -39,47 +108,299 @@ ScoreScreen::ScoreScreen(QWidget *parent, const QList<HighScoreData>* const high
     m_textFontColumnTitles.setPointSize(9);
     m_textFontColumnTitles.setFamily("Courier");  // use a fixed-width font
     m_textFontLarge.setPointSize(16);
+
+    const size_t HIGH_SCORE_LINE_TEXT_SIZE = 96;
+    char highScoreLineText[HIGH_SCORE_LINE_TEXT_SIZE] = "";
+    m_titleText = CachedText("High Scores", m_textFontLarge);
+    snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "         %13s %10s %5s %5s %6s ",
+            "", "", "", "", "Max  ");
+    m_columnTitleText1 = CachedText(highScoreLineText, m_textFontColumnTitles);
+    snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "         %13s %10s %5s %5s %6s ",
+            "Name:", "Score:", "Time:", "Size:", "Speed:");
+    m_columnTitleText2 = CachedText(highScoreLineText, m_textFontColumnTitles);
+    m_lastGameText.setFont(m_textFontColumnTitles);
+
+    m_scrollBarPtr = new QScrollBar(Qt::Vertical, this);
+    m_scrollBarPtr->setPageStep(TABLE_ROWS);
+    m_scrollBarPtr->hide();
+    QObject::connect(m_scrollBarPtr, SIGNAL(valueChanged(int)), this, SLOT(scrolled(int)));
 }
 
 /** ****************************************************************************
  * Function: paintEvent()
- *   Called by update() or repaint(), tells the Dot to redraw itself
+ *   Called by update() or repaint().  The table is copied from m_tableLayer;
+ *   only the highlight and the last game line are drawn on top.
  ******************************************************************************/
 void ScoreScreen::paintEvent(QPaintEvent *event)
 {
-    if ((*m_highScoreListPtr).size() > 0)
+    if (m_snapshot.gameCount > 0)
     {
+        if ((m_tableLayerVersion != m_tableVersion) || (m_tableLayer.size() != size()))
+        {
+            rebuildTableLayer();
+        }
         QPainter painter(this);
-        painter.fillRect(event->rect(), m_backgroundBrush);
-        painter.setRenderHint(QPainter::Antialiasing);
-        painter.setFont(m_textFontLarge);
-        painter.drawText(0, size().height()/30, size().width(), size().height(),
-                         Qt::AlignHCenter, "High Scores");
-        const size_t HIGH_SCORE_LINE_TEXT_SIZE = 96;
-        char highScoreLineText[HIGH_SCORE_LINE_TEXT_SIZE] = "";
-        painter.setFont(m_textFontColumnTitles);
-        snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "    %13s %10s %5s %5s %6s ",
-                "", "", "", "", "Max  ");
-        painter.drawText(0, (size().height()/15)*2, size().width(), size().height(),
-                         Qt::AlignHCenter, highScoreLineText);
-        snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "    %13s %10s %5s %5s %6s ",
-                "Name:", "Score:", "Time:", "Size:", "Speed:");
-        painter.drawText(0, (size().height()/15)*3, size().width(), size().height(),
-                         Qt::AlignHCenter, highScoreLineText);
-        painter.setFont(m_textFontScores);
-        for (int index = 0; index < m_highScoreListPtr->size(); index++)
+        painter.drawPixmap(event->rect(), m_tableLayer, event->rect());
+        const int highlightRow = highlightedRow();
+        if ((highlightRow >= 0) && event->rect().intersects(rowRect(highlightRow)))
         {
-            snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "%2i. %16s %8i %5i %6i %7i ",
-                    (index+1), qPrintable((*m_highScoreListPtr)[index].name), (*m_highScoreListPtr)[index].score,
-                    (*m_highScoreListPtr)[index].gameTimeLength, (*m_highScoreListPtr)[index].dotDiam,
-                    (*m_highScoreListPtr)[index].maxSpeed);
-            painter.drawText(0, (size().height()/15)*(4+index), size().width(), size().height(),
-                             Qt::AlignHCenter, highScoreLineText);
+            painter.fillRect(rowRect(highlightRow), m_highlightBrush);
+        }
+        if (event->rect().intersects(rowRect(TABLE_ROWS)))
+        {
+            m_lastGameText.draw(&painter, rowRect(TABLE_ROWS), Qt::AlignHCenter);
         }
     }
     return;
 } // function paintEvent
 
+/** ****************************************************************************
+ * Function: rebuildTableLayer()
+ *   Formats and draws every row; once per game, or per resize.
+ ******************************************************************************/
+void ScoreScreen::rebuildTableLayer()
+{
+    if (m_tableLayer.size() != size())
+    {
+        m_tableLayer = QPixmap(size());
+    }
+    QPainter painter(&m_tableLayer);
+    painter.fillRect(m_tableLayer.rect(), m_backgroundBrush);
+    painter.setRenderHint(QPainter::Antialiasing);
+    m_titleText.draw(&painter, QRect(0, size().height()/30, size().width(), size().height()),
+                     Qt::AlignHCenter);
+    m_columnTitleText1.draw(&painter, QRect(0, (size().height()/15)*2, size().width(), size().height()),
+                            Qt::AlignHCenter);
+    m_columnTitleText2.draw(&painter, QRect(0, (size().height()/15)*3, size().width(), size().height()),
+                            Qt::AlignHCenter);
+    const size_t HIGH_SCORE_LINE_TEXT_SIZE = 96;
+    char highScoreLineText[HIGH_SCORE_LINE_TEXT_SIZE] = "";
+    while (m_rowTexts.size() < TABLE_ROWS)
+    {
+        m_rowTexts.append(CachedText(QString(), m_textFontScores));
+    }
+    const int rowsInView = qMin(TABLE_ROWS, m_snapshot.gameCount - m_firstRank);
+    for (int index = 0; index < rowsInView; index++)
+    {
+        const HighScoreData *gamePtr = game(m_firstRank + index);
+        if (gamePtr != NULL)
+        {
+            snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "%7i. %16s %8i %5i %6i %7i ",
+                    (m_firstRank+index+1), qPrintable(gamePtr->name), gamePtr->score,
+                    gamePtr->gameTimeLength, gamePtr->dotDiam, gamePtr->maxSpeed);
+        }
+        else
+        {
+            snprintf(highScoreLineText, HIGH_SCORE_LINE_TEXT_SIZE, "%7i. %16s %8s %5s %6s %7s ",
+                    (m_firstRank+index+1), "...", "", "", "", "");
+        }
+        m_rowTexts[index].setText(highScoreLineText);    // no new layout if unchanged
+        m_rowTexts[index].draw(&painter, rowRect(index), Qt::AlignHCenter);
+    }
+    // ask for the next and previous screens too, so scrolling finds them here
+    if (m_firstRank + 2*TABLE_ROWS - 1 < m_snapshot.gameCount)
+    {
+        game(m_firstRank + 2*TABLE_ROWS - 1);
+    }
+    if (m_firstRank >= TABLE_ROWS)
+    {
+        game(m_firstRank - TABLE_ROWS);
+    }
+    m_tableLayerVersion = m_tableVersion;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: rowRect()
+ *
+ ******************************************************************************/
+QRect ScoreScreen::rowRect(int row) const
+{
+    return QRect(0, (size().height()/15)*(4+row), size().width(), size().height()/15);
+}
+
+/** ****************************************************************************
+ * Function: highlightedRow()
+ *
+ ******************************************************************************/
+int ScoreScreen::highlightedRow() const
+{
+    const int row = m_snapshot.lastGameRank - 1 - m_firstRank;
+    if ((m_snapshot.lastGameRank > 0) && (row >= 0) && (row < TABLE_ROWS))
+    {
+        return row;
+    }
+    return -1;
+}
+
+/** ****************************************************************************
+ * Function: listRect()
+ *
+ ******************************************************************************/
+QRect ScoreScreen::listRect() const
+{
+    return rowRect(0).united(rowRect(TABLE_ROWS - 1));
+}
+
+/** ****************************************************************************
+ * Function: game()
+ *   The snapshot's table first, then the cached pages.  A missing page is
+ *   only asked for once; setPage() repaints when it comes.
+ ******************************************************************************/
+const HighScoreData *ScoreScreen::game(int rank)
+{
+    if (rank < m_snapshot.topGames.size())
+    {
+        return &m_snapshot.topGames.at(rank);
+    }
+    const int pageNum = rank / PAGE_ROWS;
+    const QList<HighScoreData> *pagePtr = m_pages.object(pageNum);
+    if (pagePtr != NULL)
+    {
+        const int pagePos = rank - pageNum*PAGE_ROWS;
+        return (pagePos < pagePtr->size()) ? &pagePtr->at(pagePos) : NULL;
+    }
+    if (!m_pagesWanted.contains(pageNum))
+    {
+        m_pagesWanted.insert(pageNum);
+        emit pageWanted(pageNum*PAGE_ROWS, PAGE_ROWS);
+    }
+    return NULL;
+}
+
+/** ****************************************************************************
+ * Function: updateScrollRange()
+ *
+ ******************************************************************************/
+void ScoreScreen::updateScrollRange()
+{
+    const int lastFirstRank = qMax(0, m_snapshot.gameCount - TABLE_ROWS);
+    m_scrollBarPtr->setRange(0, lastFirstRank);     // clamps the value, and scrolls if it must
+    m_scrollBarPtr->setVisible(lastFirstRank > 0);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scrollToRank()
+ *
+ ******************************************************************************/
+void ScoreScreen::scrollToRank(int rank)
+{
+    m_scrollBarPtr->setValue(rank);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: scrolled()
+ *   Only the rows are repainted; the rows in view are formatted then, and
+ *   no others, so a scroll costs the same however many games there are.
+ ******************************************************************************/
+void ScoreScreen::scrolled(int firstRank)
+{
+    if (firstRank != m_firstRank)
+    {
+        m_firstRank = firstRank;
+        m_tableVersion++;
+        update(listRect());
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setSnapshot()
+ *   Only what changed is repainted: the whole table if its rows did, else
+ *   just the old and new highlighted rows and the last game line.  A new
+ *   game scrolls into view.
+ ******************************************************************************/
+void ScoreScreen::setSnapshot(const ScoreSnapshot &snapshot)
+{
+    const bool rowsChanged = (snapshot.topGames != m_snapshot.topGames) ||
+            (snapshot.gameCount != m_snapshot.gameCount);
+    const bool newLastGame = (snapshot.lastGameRank > 0) &&
+            ((snapshot.lastGameRank != m_snapshot.lastGameRank) ||
+             !(snapshot.lastGame == m_snapshot.lastGame));
+    const int oldHighlightRow = highlightedRow();
+    m_snapshot = snapshot;
+    QString lastGameLine;
+    if (m_snapshot.lastGamePartitionRank > 0)
+    {
+        lastGameLine = tr("Your game: #%1 of %2 overall, #%3 of %4 at this time/size/speed")
+                       .arg(m_snapshot.lastGameRank)
+                       .arg(m_snapshot.gameCount)
+                       .arg(m_snapshot.lastGamePartitionRank)
+                       .arg(m_snapshot.lastGamePartitionCount);
+    }
+    if (rowsChanged)
+    {
+        // every rank past the table may have moved
+        m_pages.clear();
+        m_pagesWanted.clear();
+        updateScrollRange();
+    }
+    if (newLastGame)
+    {
+        // the top of the table if it made it, else the game in the middle
+        const int lastGameIndex = m_snapshot.lastGameRank - 1;
+        scrollToRank((lastGameIndex < TABLE_ROWS) ? 0 : (lastGameIndex - TABLE_ROWS/2));
+    }
+    if (rowsChanged)
+    {
+        m_tableVersion++;
+        m_lastGameText.setText(lastGameLine);
+        update();
+        return;
+    }
+    if (m_lastGameText.setText(lastGameLine))
+    {
+        update(rowRect(TABLE_ROWS));
+    }
+    if (highlightedRow() != oldHighlightRow)
+    {
+        if (oldHighlightRow >= 0)
+        {
+            update(rowRect(oldHighlightRow));
+        }
+        if (highlightedRow() >= 0)
+        {
+            update(rowRect(highlightedRow()));
+        }
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setPage()
+ *   A page read before or after the snapshot's table may not line up with
+ *   it, so it is dropped; the next paint asks again.
+ ******************************************************************************/
+void ScoreScreen::setPage(int offset, const QList<HighScoreData> &games, int gameCount)
+{
+    const int pageNum = offset / PAGE_ROWS;
+    m_pagesWanted.remove(pageNum);
+    if ((gameCount != m_snapshot.gameCount) || (offset != pageNum*PAGE_ROWS))
+    {
+        return;
+    }
+    m_pages.insert(pageNum, new QList<HighScoreData>(games));
+    if ((offset < m_firstRank + TABLE_ROWS) && (offset + games.size() > m_firstRank))
+    {
+        m_tableVersion++;
+        update(listRect());
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: wheelEvent()
+ *
+ ******************************************************************************/
+void ScoreScreen::wheelEvent(QWheelEvent *event)
+{
+    m_scrollBarPtr->setValue(m_scrollBarPtr->value() - event->delta() / WHEEL_DELTA_PER_ROW);
+    event->accept();
+    return;
+}
+
 /** ****************************************************************************
  * Function: mousePressEvent()
  *   Called when user clicks in the window.
@@ -99,6 +420,10 @@ void ScoreScreen::mousePressEvent(QMouseEvent *event)
 void ScoreScreen::resizeEvent(QResizeEvent *event)
 {
     Q_UNUSED(event);
+    const QRect rowsRect = listRect();
+    const int scrollBarWidth = m_scrollBarPtr->sizeHint().width();
+    m_scrollBarPtr->setGeometry(rowsRect.right() + 1 - scrollBarWidth, rowsRect.top(),
+                                scrollBarWidth, rowsRect.height());
 //    qDebug("ScoreScreen::resizeEvent: newSize=(%i,%i) MainWinSize=(%i,%i)", rect().width(),
 //           rect().height(), parentWinPtr->rect().width(), parentWinPtr->rect().height());
     return;
@@ -113,6 +438,7 @@ void ScoreScreen::setBackgroundColor(const int newHSVcolor)
     QColor tempHSV;
     tempHSV.setHsv(newHSVcolor,255,150);
     m_backgroundBrush.setColor(tempHSV);
+    m_tableVersion++;
     update();
     return;
 }
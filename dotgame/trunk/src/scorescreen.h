@@ -22,9 +22,17 @@
 
 #include <QWidget>
 #include <QList>
+#include <QtCore/QMetaType>
+#include <QtCore/QCache>
+#include <QtCore/QSet>
+#include <QtGui/QPixmap>
+#include "cachedtext.h"
 
 /// High m_score Names are limited to 16 characters long
 const int MAX_NAME_STRING_LEN = 16;
+/// Name of a game nobody entered a name for: it missed the table, or the
+///   name dialog was cancelled.  Never a typed name, which can't have '<'.
+const char ANONYMOUS_PLAYER_NAME[] = "<anonymous>";
 
 /** ****************************************************************************
  * @struct Highm_scoreData
@@ -43,18 +51,61 @@ struct HighScoreData {
      *      milliseconds between game refreshes.  Lower number is faster. */
     uint maxSpeed;
 };
+bool operator==(const HighScoreData &left, const HighScoreData &right);
+
+/** ****************************************************************************
+ * @struct ScoreSnapshot
+ *   What the ScoreScreen shows, copied out of the leaderboard at one moment.
+ *   Never changed once made and cheap to copy, so the score I/O thread can
+ *   hand it to the GUI.
+*******************************************************************************/
+struct ScoreSnapshot {
+    ScoreSnapshot();
+
+    /// Number of table games that rank ahead of a new game with this score
+    int tableRank(uint score) const;
+    /// This snapshot with a game added, for showing it before it is saved
+    ScoreSnapshot withGame(const HighScoreData &game, int tableRows) const;
+
+    /// Best games first
+    QList<HighScoreData> topGames;
+    /// Number of games ever played
+    int gameCount;
+    /// The game that just ended, if lastGameRank is not 0
+    HighScoreData lastGame;
+    /// Its rank overall and among games played the same way; 1 is the best.
+    /// Only the overall rank is known before the game is saved, if it made the table.
+    int lastGameRank;
+    int lastGamePartitionRank;
+    int lastGamePartitionCount;
+};
+Q_DECLARE_METATYPE(ScoreSnapshot)
+
+class QScrollBar;
 
 /** ****************************************************************************
  * @class m_scoreScreen
  *   This m_scoreScreen is used to display the top scoring players in the game.
  *   It is intended to occupy the central/main portion of the main window.
+ *   It scrolls through every game ever played, TABLE_ROWS at a time.  The
+ *   top TABLE_ROWS come with the snapshot; the rest are asked for in pages
+ *   through pageWanted() as they come into view, and kept in a small cache.
 *******************************************************************************/
 class ScoreScreen : public QWidget
 {
     Q_OBJECT
 public:
-    explicit ScoreScreen(QWidget *parent = 0,
-                         const QList<HighScoreData> *const highScoreListPtr = NULL);
+    explicit ScoreScreen(QWidget *parent = 0);
+
+    /// Show the game of this rank (0 is the best) at the top
+    void scrollToRank(int rank);
+
+    /// Number of games shown at a time, and in a snapshot's table
+    static const int TABLE_ROWS = 10;
+    /// Number of games asked for at a time
+    static const int PAGE_ROWS = 64;
+    /// Most pages kept
+    static const int PAGE_CACHE_PAGES = 64;
 
     /// High m_score Names are limited to 16 characters long
     static const int MAX_NAME_STRING_LEN = 16;
@@ -63,6 +114,7 @@ protected:
     virtual void paintEvent(QPaintEvent *event);
     virtual void mousePressEvent(QMouseEvent *event);
     virtual void resizeEvent(QResizeEvent *event);
+    virtual void wheelEvent(QWheelEvent *event);
 private:
     /* Private non-defined function prototypes disables compiler generation. */
     /// prevent copy operator
@@ -70,14 +122,36 @@ private:
     /// prevent assignment operator
     ScoreScreen& operator=(const ScoreScreen&);
 
+    /// Draw the background, titles and rows into m_tableLayer
+    void rebuildTableLayer();
+    /// Where a table row is drawn; row TABLE_ROWS is the last game line
+    QRect rowRect(int row) const;
+    /// Table row of the last game, or -1 if it isn't in view
+    int highlightedRow() const;
+    /// The rows in view
+    QRect listRect() const;
+    /// The game of a rank, or NULL if its page hasn't come yet; the page is asked for
+    const HighScoreData *game(int rank);
+    /// Fit the scroll bar to the number of games
+    void updateScrollRange();
+
     /// Parent widget, for requesting window size
     QWidget *m_parentWinPtr;
 
-    /// read-only pointer to the high m_score data
-    const QList<HighScoreData>* const m_highScoreListPtr;
+    /// The table and last game shown
+    ScoreSnapshot m_snapshot;
 
     /// Background color
     QBrush m_backgroundBrush;
+    /// Laid over the row of the last game
+    QBrush m_highlightBrush;
+
+    /// The table as last drawn; only redrawn when m_tableVersion or the size changes
+    QPixmap m_tableLayer;
+    /// Bumped whenever the rows or background change
+    uint m_tableVersion;
+    /// m_tableVersion that m_tableLayer was drawn at
+    uint m_tableLayerVersion;
 
     /// font for main "High m_scores" text
     QFont m_textFontLarge;
@@ -88,13 +162,42 @@ private:
     /// font for small m_score text
     QFont m_textFontScores;
 
+    /// "High Scores" title and the two column title lines, laid out once
+    CachedText m_titleText;
+    CachedText m_columnTitleText1;
+    CachedText m_columnTitleText2;
+
+    /// One laid-out line per row in view; re-laid out only when a row changes
+    QList<CachedText> m_rowTexts;
+
+    /// Scrolls by rank; hidden while all games fit
+    QScrollBar *m_scrollBarPtr;
+    /// Rank of the top row in view
+    int m_firstRank;
+    /// Games past the snapshot's table, by page number
+    QCache<int, QList<HighScoreData> > m_pages;
+    /// Pages asked for and not come yet
+    QSet<int> m_pagesWanted;
+
+    /// Rank of the last game, overall and among games played the same way
+    CachedText m_lastGameText;
+
 signals:
     /// The m_scoreScreen object has been mouse clicked.
     void scoreScreenClicked();
+    /// Games ranked offset to offset+count-1 are needed; answer with setPage()
+    void pageWanted(int offset, int count);
 
 public slots:
+    /// Show a new table, and where the game that just ended ranks under it
+    void setSnapshot(const ScoreSnapshot &snapshot);
+    /// Games asked for by pageWanted(), read when the leaderboard had gameCount games
+    void setPage(int offset, const QList<HighScoreData> &games, int gameCount);
     /// Set the Background Color for the m_scoreScreen.
     void setBackgroundColor(const int newHSVcolor);
+
+private slots:
+    void scrolled(int firstRank);
 };
 
 #endif // m_scoreSCREEN_H
@@ -0,0 +1,377 @@
+/** ****************************************************************************
+ * @file scorestore.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The ScoreStore: score file I/O on a worker thread.  See scorestore.h.
+ *
+ ******************************************************************************/
+
+#include "scorestore.h"
+#include "scorejournal.h"
+#include <QtCore/QMutexLocker>
+#include <QtCore/QMetaObject>
+#include <QtCore/QTimer>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QStringList>
+
+/// Names of the replays in the replay directory
+static const char REPLAY_FILE_PATTERN[] = "dotgame-*.dotreplay";
+/// Added to a replay's name for the result of checking it
+static const char REPLAY_CHECK_SUFFIX[] = ".check.txt";
+
+/** ****************************************************************************
+ * ScoreStoreWorker Constructor
+ *   @param baseName Leaderboard files, without their suffix
+ *   @param legacyFileName Old text high score file, imported the first time
+ *   @param replayDir Where replays are saved, and pruned
+ *   @param tableRows Number of games in a snapshot's table
+ ******************************************************************************/
+ScoreStoreWorker::ScoreStoreWorker(const QString &baseName, const QString &legacyFileName,
+                                   const QString &replayDir, int tableRows) :
+    QObject(NULL),
+    m_leaderboard(baseName), m_legacyFileName(legacyFileName), m_tableRows(tableRows),
+    m_replayDir(replayDir), m_flushPosted(false), m_gamesSaved(0)
+{
+}
+
+/** ****************************************************************************
+ * Function: queueGame()
+ *   Only the first game queued since the last flush() posts another one;
+ *   the rest ride along with it.
+*******************************************************************************/
+void ScoreStoreWorker::queueGame(const HighScoreData &game)
+{
+    QMutexLocker locker(&m_queueMutex);
+    m_queuedGames.append(game);
+    if (!m_flushPosted)
+    {
+        m_flushPosted = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: queueFile()
+ *   Like queueGame(): written by the next flush().
+*******************************************************************************/
+void ScoreStoreWorker::queueFile(const QString &fileName, const QByteArray &data)
+{
+    QMutexLocker locker(&m_queueMutex);
+    QueuedFile file;
+    file.fileName = fileName;
+    file.data = data;
+    m_queuedFiles.append(file);
+    if (!m_flushPosted)
+    {
+        m_flushPosted = true;
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: load()
+ *   A table is published even if the files can't be opened, so the GUI is
+ *   never left waiting.
+*******************************************************************************/
+void ScoreStoreWorker::load()
+{
+    const bool opened = openLeaderboard();
+    int gamesSaved;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        gamesSaved = m_gamesSaved;
+    }
+    emit snapshotReady(m_leaderboard.snapshot(m_tableRows), gamesSaved, opened);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: flush()
+ *   If the files can't be opened or written, e.g. the network home directory
+ *   is away, the games go back to the front of the queue and are tried again
+ *   after RETRY_INTERVAL_MS, with any queued since.  insert() cuts off a
+ *   partly written row, so the retry doesn't duplicate it.  Until then the
+ *   GUI keeps them in its own table.
+*******************************************************************************/
+void ScoreStoreWorker::flush()
+{
+    QList<HighScoreData> games;
+    QList<QueuedFile> files;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        games.swap(m_queuedGames);
+        files.swap(m_queuedFiles);
+        m_flushPosted = false;
+    }
+    writeFiles(files);
+    if (games.isEmpty())
+    {
+        return;
+    }
+    const bool saved = openLeaderboard() && m_leaderboard.insert(games);
+    int gamesSaved;
+    int gamesQueued;
+    {
+        QMutexLocker locker(&m_queueMutex);
+        if (saved)
+        {
+            m_gamesSaved += games.size();
+        }
+        else
+        {
+            m_queuedGames = games + m_queuedGames;     // oldest first, as queued
+        }
+        gamesSaved = m_gamesSaved;
+        gamesQueued = m_queuedGames.size();
+        // only a running thread can retry; from ~ScoreStore() the games are lost
+        if (!saved && !m_flushPosted && (QThread::currentThread() == thread()))
+        {
+            m_flushPosted = true;
+            QTimer::singleShot(RETRY_INTERVAL_MS, this, SLOT(flush()));
+        }
+    }
+    if (!saved)
+    {
+        qDebug("ScoreStoreWorker::flush: Failed to save %i games; retrying.", gamesQueued);
+        emit snapshotReady(m_leaderboard.snapshot(m_tableRows), gamesSaved, m_leaderboard.isOpen());
+        return;
+    }
+    emit snapshotReady(m_leaderboard.snapshot(m_tableRows, &games.last()), gamesSaved, true);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: writeFiles()
+ *   Replays can be replayed again later, so unlike the games they aren't
+ *   retried.  Writing one prunes the replay directory.
+*******************************************************************************/
+void ScoreStoreWorker::writeFiles(const QList<QueuedFile> &files)
+{
+    bool replayWritten = false;
+    foreach (const QueuedFile &queuedFile, files)
+    {
+        const QFileInfo fileInfo(queuedFile.fileName);
+        QFile file(queuedFile.fileName);
+        if (!QDir().mkpath(fileInfo.path()) ||
+            !file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            (file.write(queuedFile.data) != queuedFile.data.size()))
+        {
+            qDebug("ScoreStoreWorker::writeFiles: Can't write %s", qPrintable(queuedFile.fileName));
+            continue;
+        }
+        replayWritten |= (fileInfo.dir() == QDir(m_replayDir));
+    }
+    if (replayWritten)
+    {
+        pruneReplays();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: pruneReplays()
+ *   The names start with the time they were saved, so by name is oldest first.
+*******************************************************************************/
+void ScoreStoreWorker::pruneReplays()
+{
+    QDir replayDir(m_replayDir);
+    const QStringList replays = replayDir.entryList(QStringList(REPLAY_FILE_PATTERN),
+                                                    QDir::Files, QDir::Name);
+    for (int replayNum = 0; replayNum < replays.size() - REPLAYS_KEPT; ++replayNum)
+    {
+        replayDir.remove(replays.at(replayNum));
+        replayDir.remove(replays.at(replayNum) + REPLAY_CHECK_SUFFIX);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: fetchPage()
+ *   The files aren't refreshed, so the page matches the last table published
+ *   unless a flush is on its way.
+*******************************************************************************/
+void ScoreStoreWorker::fetchPage(int offset, int count)
+{
+    emit pageReady(offset, m_leaderboard.top(LeaderboardPartition::all(), count, offset),
+                   m_leaderboard.rowCount());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: openLeaderboard()
+ *   The first time, the old text high score file is imported.
+*******************************************************************************/
+bool ScoreStoreWorker::openLeaderboard()
+{
+    if (m_leaderboard.isOpen())
+    {
+        return m_leaderboard.refresh();
+    }
+    if (!m_leaderboard.open())
+    {
+        qDebug("ScoreStoreWorker::openLeaderboard: Failed to open score File.");
+        return false;
+    }
+    QList<HighScoreData> legacyScores;
+    ScoreJournal legacyFile(m_legacyFileName);      // every game in it, not just the table
+    if ((m_leaderboard.rowCount() == 0) && legacyFile.load(legacyScores))
+    {
+        m_leaderboard.insert(legacyScores);
+    }
+    return true;
+}
+
+
+/** ****************************************************************************
+ * ScoreStore Constructor
+ *   Starts the thread; nothing is read until load() or addGame().  Call
+ *   load() early, so the table is ready by the first game over.
+ *   @param baseName Leaderboard files, without their suffix
+ *   @param legacyFileName Old text high score file, imported the first time
+ *   @param replayDir Where game replays are saved
+ *   @param tableRows Number of games in a snapshot's table
+ *   @param parent Owner
+ ******************************************************************************/
+ScoreStore::ScoreStore(const QString &baseName, const QString &legacyFileName,
+                       const QString &replayDir, int tableRows, QObject *parent) :
+    QObject(parent),
+    m_workerPtr(new ScoreStoreWorker(baseName, legacyFileName, replayDir, tableRows)),
+    m_tableRows(tableRows), m_loadState(NOT_LOADED), m_gamesQueued(0),
+    m_replayDir(replayDir), m_replaysSaved(0)
+{
+    qRegisterMetaType<ScoreSnapshot>("ScoreSnapshot");
+    qRegisterMetaType<QList<HighScoreData> >("QList<HighScoreData>");
+    m_workerPtr->moveToThread(&m_thread);
+    QObject::connect(m_workerPtr, SIGNAL(snapshotReady(ScoreSnapshot, int, bool)),
+                     this, SLOT(workerSnapshotReady(ScoreSnapshot, int, bool)));
+    QObject::connect(m_workerPtr, SIGNAL(pageReady(int, QList<HighScoreData>, int)),
+                     this, SIGNAL(pageReady(int, QList<HighScoreData>, int)));
+    m_thread.start(QThread::LowPriority);
+}
+
+/** ScoreStore Destructor */
+ScoreStore::~ScoreStore()
+{
+    m_thread.quit();
+    m_thread.wait();
+    // the thread has stopped; write what it didn't get to from here
+    m_workerPtr->disconnect(this);
+    m_workerPtr->flush();
+    delete m_workerPtr;
+}
+
+/** ****************************************************************************
+ * Function: load()
+ *   Does nothing while loading or once loaded.  Runs on the score thread
+ *   rather than a QtConcurrent pool thread, so it is always done before the
+ *   first write.
+*******************************************************************************/
+void ScoreStore::load()
+{
+    if ((m_loadState == NOT_LOADED) || (m_loadState == LOAD_FAILED))
+    {
+        m_loadState = LOADING;
+        QMetaObject::invokeMethod(m_workerPtr, "load", Qt::QueuedConnection);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: addGame()
+ *
+*******************************************************************************/
+void ScoreStore::addGame(const HighScoreData &game)
+{
+    if (m_loadState == NOT_LOADED)
+    {
+        m_loadState = LOADING;  // the flush reads the table anyway
+    }
+    m_gamesQueued++;
+    m_workerPtr->queueGame(game);
+    m_snapshot = m_snapshot.withGame(game, m_tableRows);
+    emit snapshotReady(m_snapshot);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: fetchPage()
+ *
+*******************************************************************************/
+void ScoreStore::fetchPage(int offset, int count)
+{
+    QMetaObject::invokeMethod(m_workerPtr, "fetchPage", Qt::QueuedConnection,
+                              Q_ARG(int, offset), Q_ARG(int, count));
+    return;
+}
+
+/** ****************************************************************************
+ * Function: saveReplay()
+ *   Named by when the game ended, to the millisecond, and numbered, so games
+ *   ending together don't overwrite each other.
+*******************************************************************************/
+void ScoreStore::saveReplay(const QByteArray &replay)
+{
+    const QString fileName = QString("%1/dotgame-%2-%3.dotreplay")
+            .arg(m_replayDir)
+            .arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss-zzz"))
+            .arg(m_replaysSaved++);
+    m_workerPtr->queueFile(fileName, replay);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: saveReplayCheck()
+ *   A few "key value" lines, for whoever settles a disputed score.
+ *   @param fileName The replay that was played
+ *   @param mismatches 0 if the replay matched the recorded game
+*******************************************************************************/
+void ScoreStore::saveReplayCheck(const QString &fileName, uint mismatches,
+                                 float replayedScore, float recordedScore)
+{
+    QString report;
+    report += QString("replay %1\n").arg(QFileInfo(fileName).fileName());
+    report += QString("checked %1\n").arg(QDateTime::currentDateTime().toString(Qt::ISODate));
+    report += QString("result %1\n").arg(QLatin1String((mismatches == 0) ? "MATCH" : "MISMATCH"));
+    report += QString("mismatches %1\n").arg(mismatches);
+    report += QString("replayed_score %1\n").arg(replayedScore, 0, 'f', 3);
+    report += QString("recorded_score %1\n").arg(recordedScore, 0, 'f', 3);
+    m_workerPtr->queueFile(fileName + REPLAY_CHECK_SUFFIX, report.toUtf8());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: workerSnapshotReady()
+ *   A table made before the latest game was saved would hide that game again,
+ *   so it is dropped; the one after the next successful flush follows.
+ *   A failed read keeps the games already in memory.
+*******************************************************************************/
+void ScoreStore::workerSnapshotReady(const ScoreSnapshot &snapshot, int gamesSaved, bool fromFiles)
+{
+    const bool wasLoading = (m_loadState == LOADING);
+    m_loadState = fromFiles ? LOADED : LOAD_FAILED;
+    if (fromFiles && (gamesSaved >= m_gamesQueued))
+    {
+        m_snapshot = snapshot;
+        emit snapshotReady(m_snapshot);
+    }
+    if (wasLoading)
+    {
+        emit loadFinished(fromFiles);
+    }
+    return;
+}
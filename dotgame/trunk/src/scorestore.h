@@ -0,0 +1,211 @@
+/** ****************************************************************************
+ * @file scorestore.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The ScoreStore keeps the score files off the GUI thread, so a slow disk or
+ * network home directory can't freeze the window at game over.  A worker
+ * thread owns the Leaderboard.  The GUI queues finished games and gets back
+ * ScoreSnapshots of the table; it never touches the files.  Games queued while
+ * a write is still running are written together, under one lock and one sync.
+ * Games that couldn't be written stay queued, and are retried.  Game replays
+ * and replay checks are written on the same thread; only the newest
+ * REPLAYS_KEPT replays are kept.
+ *
+ ******************************************************************************/
+
+#ifndef SCORESTORE_H
+#define SCORESTORE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QThread>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QByteArray>
+#include "leaderboard.h"
+
+/** ****************************************************************************
+ * @class ScoreStoreWorker
+ *   Lives on the ScoreStore thread and does all the file I/O.
+*******************************************************************************/
+class ScoreStoreWorker : public QObject
+{
+    Q_OBJECT
+public:
+    ScoreStoreWorker(const QString &baseName, const QString &legacyFileName,
+                     const QString &replayDir, int tableRows);
+
+    /// Add a game to the next flush(); safe from any thread
+    void queueGame(const HighScoreData &game);
+    /// Add a file to write to the next flush(); safe from any thread
+    void queueFile(const QString &fileName, const QByteArray &data);
+
+    /// Replays kept in the replay directory; the oldest are deleted
+    static const int REPLAYS_KEPT = 500;
+
+public slots:
+    /// Open the leaderboard and publish the table
+    void load();
+    /// Write all queued games, then publish the table with the last one's ranks
+    void flush();
+    /// Read the games ranked offset to offset+count-1
+    void fetchPage(int offset, int count);
+
+signals:
+    /// @param gamesSaved Games written to the files so far
+    /// @param fromFiles The table was read from the files, which are open
+    void snapshotReady(const ScoreSnapshot &snapshot, int gamesSaved, bool fromFiles);
+    /// @param gameCount Games in the leaderboard the page was read from
+    void pageReady(int offset, const QList<HighScoreData> &games, int gameCount);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    ScoreStoreWorker(const ScoreStoreWorker&);
+    /// prevent assignment operator
+    ScoreStoreWorker& operator=(const ScoreStoreWorker&);
+
+    /// Open the leaderboard the first time, else pick up other instances' games
+    bool openLeaderboard();
+    /** @struct QueuedFile
+     *    A file to write, whole. */
+    struct QueuedFile {
+        QString fileName;
+        QByteArray data;
+    };
+    /// Write the files, creating their directories; failures are only logged
+    void writeFiles(const QList<QueuedFile> &files);
+    /// Delete the oldest replays, and their checks, beyond REPLAYS_KEPT
+    void pruneReplays();
+
+    Leaderboard m_leaderboard;
+    /// Old text high score file, imported into an empty leaderboard
+    QString m_legacyFileName;
+    /// Number of games in a snapshot's table
+    int m_tableRows;
+    /// Where replays are saved
+    QString m_replayDir;
+
+    /// Time before a failed write is tried again, in ms
+    static const int RETRY_INTERVAL_MS = 10000;
+
+    /// Guards the queue, which the GUI thread fills
+    QMutex m_queueMutex;
+    QList<HighScoreData> m_queuedGames;
+    QList<QueuedFile> m_queuedFiles;
+    /// A flush() has been posted, or a retry set, and not started yet
+    bool m_flushPosted;
+    int m_gamesSaved;
+};
+
+/** ****************************************************************************
+ * @class ScoreStore
+ *   The GUI side: owns the thread, and keeps the latest table.
+*******************************************************************************/
+class ScoreStore : public QObject
+{
+    Q_OBJECT
+public:
+    /// Progress of reading the table
+    enum loadState {
+        NOT_LOADED = 0,
+        LOADING,
+        LOADED,
+        LOAD_FAILED     ///< the files couldn't be read; the table is in memory only
+    };
+
+    ScoreStore(const QString &baseName, const QString &legacyFileName, const QString &replayDir,
+               int tableRows, QObject *parent = 0);
+
+    /// Writes any games still queued before returning
+    ~ScoreStore();
+
+    /// Start reading the table, or retry if it failed; loadFinished() follows
+    void load();
+    /// Save a game in the background.  It is in snapshot() right away, and
+    /// snapshotReady() follows twice: now, and with its ranks once saved.
+    void addGame(const HighScoreData &game);
+
+    inline loadState getLoadState() const;
+    /// Has reading the table finished, well or not?  snapshot() is then usable.
+    inline bool isReady() const;
+    /// The latest table, including games still being saved
+    inline const ScoreSnapshot &snapshot() const;
+
+signals:
+    void snapshotReady(const ScoreSnapshot &snapshot);
+    /// Reading the table has finished; if not ok, snapshot() has only this session's games
+    void loadFinished(bool ok);
+    /// Games asked for by fetchPage().  Drop the page if gameCount isn't the
+    /// snapshot's: it was read before or after that table.
+    void pageReady(int offset, const QList<HighScoreData> &games, int gameCount);
+
+public slots:
+    /// Read the games ranked offset to offset+count-1 in the background; pageReady() follows
+    void fetchPage(int offset, int count);
+    /// Save a finished game's replay in the background, under a new name
+    void saveReplay(const QByteArray &replay);
+    /// Save the result of a replay in the background, next to it as <fileName>.check.txt
+    void saveReplayCheck(const QString &fileName, uint mismatches,
+                         float replayedScore, float recordedScore);
+
+private slots:
+    void workerSnapshotReady(const ScoreSnapshot &snapshot, int gamesSaved, bool fromFiles);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    /// prevent copy operator
+    ScoreStore(const ScoreStore&);
+    /// prevent assignment operator
+    ScoreStore& operator=(const ScoreStore&);
+
+    QThread m_thread;
+    ScoreStoreWorker *m_workerPtr;
+    int m_tableRows;
+    loadState m_loadState;
+    ScoreSnapshot m_snapshot;
+    /// Games handed to the worker so far
+    int m_gamesQueued;
+    /// Where replays are saved
+    QString m_replayDir;
+    /// Replays saved this session; tells apart the ones in the same millisecond
+    uint m_replaysSaved;
+};
+
+
+/** ****************************************************************************
+ * Function: getLoadState()
+ *
+*******************************************************************************/
+inline ScoreStore::loadState ScoreStore::getLoadState() const
+{
+    return m_loadState;
+}
+/** ****************************************************************************
+ * Function: isReady()
+ *
+*******************************************************************************/
+inline bool ScoreStore::isReady() const
+{
+    return (m_loadState == LOADED) || (m_loadState == LOAD_FAILED);
+}
+/** ****************************************************************************
+ * Function: snapshot()
+ *
+*******************************************************************************/
+inline const ScoreSnapshot &ScoreStore::snapshot() const
+{
+    return m_snapshot;
+}
+
+#endif // SCORESTORE_H
@@ -0,0 +1,154 @@
+/** ****************************************************************************
+ * @file sparkline.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The Sparkline: recent values in a fixed ring, drawn one line per column.
+ *
+ ******************************************************************************/
+
+#include "sparkline.h"
+
+/** ****************************************************************************
+ * Sparkline Constructor
+ *   Nothing is drawn until setColumns() is given a width.
+ ******************************************************************************/
+Sparkline::Sparkline(int capacity) :
+    m_values(qMax(1, capacity)), m_first(0), m_count(0),
+    m_columns(0), m_columnFirst(0), m_columnCount(0), m_valuesPerColumn(1),
+    m_newestColumnValues(0)
+{
+}
+
+/** ****************************************************************************
+ * Function: append()
+ *   O(1), and never allocates.
+*******************************************************************************/
+bool Sparkline::append(float value)
+{
+    if (m_count < m_values.size())
+    {
+        m_values[(m_first + m_count) % m_values.size()] = value;
+        m_count++;
+    }
+    else
+    {
+        m_values[m_first] = value;      // overwrite the oldest
+        m_first = (m_first + 1) % m_values.size();
+    }
+    return addToColumns(value);
+}
+
+/** ****************************************************************************
+ * Function: clear()
+ *
+*******************************************************************************/
+void Sparkline::clear()
+{
+    m_first = 0;
+    m_count = 0;
+    m_columnFirst = 0;
+    m_columnCount = 0;
+    m_newestColumnValues = 0;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setColumns()
+ *   The only place all the values are gone through again.
+*******************************************************************************/
+void Sparkline::setColumns(int columns)
+{
+    columns = qMax(0, columns);
+    if (columns == m_columns)
+    {
+        return;
+    }
+    m_columns = columns;
+    m_columnMin.resize(columns);
+    m_columnMax.resize(columns);
+    m_lines.reserve(columns);
+    m_valuesPerColumn = (columns > 0) ? qMax(1, (m_values.size() + columns - 1) / columns) : 1;
+    m_columnFirst = 0;
+    m_columnCount = 0;
+    m_newestColumnValues = 0;
+    for (int index = 0; index < m_count; ++index)
+    {
+        addToColumns(m_values[(m_first + index) % m_values.size()]);
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: addToColumns()
+ *   @return true if a column was started or its range grew.
+*******************************************************************************/
+bool Sparkline::addToColumns(float value)
+{
+    if (m_columns == 0)
+    {
+        return false;
+    }
+    if ((m_columnCount == 0) || (m_newestColumnValues >= m_valuesPerColumn))
+    {
+        if (m_columnCount < m_columns)
+        {
+            m_columnCount++;
+        }
+        else
+        {
+            m_columnFirst = (m_columnFirst + 1) % m_columns;    // drop the oldest
+        }
+        const int newest = (m_columnFirst + m_columnCount - 1) % m_columns;
+        m_columnMin[newest] = value;
+        m_columnMax[newest] = value;
+        m_newestColumnValues = 1;
+        return true;
+    }
+    const int newest = (m_columnFirst + m_columnCount - 1) % m_columns;
+    m_newestColumnValues++;
+    if (value < m_columnMin[newest])
+    {
+        m_columnMin[newest] = value;
+        return true;
+    }
+    if (value > m_columnMax[newest])
+    {
+        m_columnMax[newest] = value;
+        return true;
+    }
+    return false;
+}
+
+/** ****************************************************************************
+ * Function: draw()
+ *   Values above maxValue are drawn at the top.
+*******************************************************************************/
+void Sparkline::draw(QPainter *painter, const QRect &area, float maxValue) const
+{
+    if ((m_columnCount == 0) || (maxValue <= 0.0))
+    {
+        return;
+    }
+    const float scale = (area.height() - 1) / maxValue;
+    m_lines.resize(0);      // clear() would free the reserved buffer
+    for (int index = 0; index < m_columnCount; ++index)
+    {
+        const int column = (m_columnFirst + index) % m_columns;
+        const int x = area.right() - (m_columnCount - 1 - index);
+        const int yMin = area.bottom() - int(qMin(m_columnMin[column], maxValue) * scale);
+        const int yMax = area.bottom() - int(qMin(m_columnMax[column], maxValue) * scale);
+        m_lines.append(QLine(x, yMin, x, yMax));
+    }
+    painter->drawLines(m_lines);
+    return;
+}
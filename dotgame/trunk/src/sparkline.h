@@ -0,0 +1,93 @@
+/** ****************************************************************************
+ * @file sparkline.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * A Sparkline is a tiny graph of the recent values of one number.  The values
+ * are kept in a ring of fixed capacity, allocated once.  As they come in, they
+ * are also reduced to a min and a max per pixel column, so drawing is one line
+ * per column however many values are kept.  Only a change of width goes back
+ * to the values.
+ *
+ ******************************************************************************/
+
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <QtCore/QVector>
+#include <QtCore/QRect>
+#include <QtCore/QLine>
+#include <QtGui/QPainter>
+
+/** ****************************************************************************
+ * @class Sparkline
+ *   Recent values, min/max decimated to pixel columns.
+*******************************************************************************/
+class Sparkline
+{
+public:
+    /// @param capacity Most values kept; the oldest are dropped beyond it
+    explicit Sparkline(int capacity);
+
+    /// Add a value.  @return true if the drawing changes
+    bool append(float value);
+    void clear();
+    /// Width to draw at, in pixel columns; re-reduces the values kept
+    void setColumns(int columns);
+    inline int columns() const;
+    inline int size() const;
+
+    /// Draw the columns into 'area', newest at the right, 0 to maxValue bottom to top
+    void draw(QPainter *painter, const QRect &area, float maxValue) const;
+
+private:
+    /// Fold a value into the newest column, or start a new one
+    bool addToColumns(float value);
+
+    /// The values, oldest at m_first
+    QVector<float> m_values;
+    int m_first;
+    int m_count;
+
+    /// Min and max per column, oldest at m_columnFirst; the newest may be partial
+    QVector<float> m_columnMin;
+    QVector<float> m_columnMax;
+    int m_columns;
+    int m_columnFirst;
+    int m_columnCount;
+    /// Values per full column, so that m_columns columns hold all the values
+    int m_valuesPerColumn;
+    /// Values in the newest column
+    int m_newestColumnValues;
+    /// Lines handed to the painter; kept to avoid allocating every draw
+    mutable QVector<QLine> m_lines;
+};
+
+
+/** ****************************************************************************
+ * Function: columns()
+ *
+*******************************************************************************/
+inline int Sparkline::columns() const
+{
+    return m_columns;
+}
+/** ****************************************************************************
+ * Function: size()
+ *   Number of values kept.
+*******************************************************************************/
+inline int Sparkline::size() const
+{
+    return m_count;
+}
+
+#endif // SPARKLINE_H
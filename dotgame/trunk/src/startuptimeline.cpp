@@ -0,0 +1,162 @@
+/** ****************************************************************************
+ * @file startuptimeline.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The StartupTimeline: per-stage startup times, up to the first paint.
+ *
+ ******************************************************************************/
+
+#include "startuptimeline.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QEvent>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <stdio.h>       // for snprintf()
+
+/** ****************************************************************************
+ * StartupTimeline Constructor
+ *   A QObject needs no QApplication, so this can be made before it.
+*******************************************************************************/
+StartupTimeline::StartupTimeline(QObject *parent) :
+    QObject(parent), m_dispatching(false)
+{
+    m_clock.start();
+    for (int stage = 0; stage < STARTUP_STAGE_COUNT; ++stage)
+    {
+        m_stageEndNs[stage] = -1;
+    }
+}
+
+/** ****************************************************************************
+ * Function: mark()
+ *   Only the first mark of a stage counts.
+*******************************************************************************/
+void StartupTimeline::mark(startupStage stage)
+{
+    if (m_stageEndNs[stage] < 0)
+    {
+        m_stageEndNs[stage] = m_clock.nsecsElapsed();
+    }
+    return;
+}
+
+/** ****************************************************************************
+ * Function: finishOnFirstPaint()
+ *   @param widgetPtr For a QGraphicsView, its viewport().
+*******************************************************************************/
+void StartupTimeline::finishOnFirstPaint(QWidget *widgetPtr)
+{
+    if (isFinished() || (widgetPtr == NULL))
+    {
+        return;
+    }
+    m_firstPaintWidgetPtr = widgetPtr;
+    widgetPtr->installEventFilter(this);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: setReportFile()
+ *
+*******************************************************************************/
+void StartupTimeline::setReportFile(const QString &fileName)
+{
+    m_reportFileName = fileName;
+    return;
+}
+
+/** ****************************************************************************
+ * Function: eventFilter() reimplemented from QObject
+ *   As in FrameProfiler, the paint is delivered from here so that its end
+ *   can be marked.  The filter is removed after the first one.
+*******************************************************************************/
+bool StartupTimeline::eventFilter(QObject *watched, QEvent *event)
+{
+    if ((event->type() != QEvent::Paint) || m_dispatching ||
+        (watched != m_firstPaintWidgetPtr))
+    {
+        return QObject::eventFilter(watched, event);
+    }
+    m_dispatching = true;
+    QCoreApplication::sendEvent(watched, event);
+    m_dispatching = false;
+    mark(STARTUP_FIRST_PAINT);
+    watched->removeEventFilter(this);
+    m_firstPaintWidgetPtr = NULL;
+
+    const qint64 NSEC_IN_MSEC = 1000000;
+    const qint64 firstFrameMs = m_stageEndNs[STARTUP_FIRST_PAINT] / NSEC_IN_MSEC;
+    if (firstFrameMs > FIRST_FRAME_BUDGET_MS)
+    {
+        qWarning("StartupTimeline: first frame after %lli ms, budget %i ms",
+                 firstFrameMs, FIRST_FRAME_BUDGET_MS);
+    }
+    if (!m_reportFileName.isEmpty())
+    {
+        writeReport(m_reportFileName);
+    }
+    return true;
+}
+
+/** ****************************************************************************
+ * Function: report()
+ *   Stages not marked (yet) are shown as '-'.
+*******************************************************************************/
+QString StartupTimeline::report() const
+{
+    static const char *const STAGE_NAMES[STARTUP_STAGE_COUNT] = {
+        "application", "QML types", "game widget", "status bar", "QML scene",
+        "layout", "score store", "show", "first paint"
+    };
+    const double NSEC_IN_MSEC = 1000000.0;
+    const size_t LINE_TEXT_SIZE = 96;
+    char lineText[LINE_TEXT_SIZE];
+    snprintf(lineText, LINE_TEXT_SIZE, "%-14s %8s %8s\n", "stage (ms)", "took", "at");
+    QString reportText(lineText);
+    qint64 previousEndNs = 0;
+    for (int stage = 0; stage < STARTUP_STAGE_COUNT; ++stage)
+    {
+        if (m_stageEndNs[stage] < 0)
+        {
+            snprintf(lineText, LINE_TEXT_SIZE, "%-14s %8s %8s\n", STAGE_NAMES[stage], "-", "-");
+        }
+        else
+        {
+            snprintf(lineText, LINE_TEXT_SIZE, "%-14s %8.1f %8.1f\n", STAGE_NAMES[stage],
+                     (m_stageEndNs[stage] - previousEndNs) / NSEC_IN_MSEC,
+                     m_stageEndNs[stage] / NSEC_IN_MSEC);
+            previousEndNs = m_stageEndNs[stage];
+        }
+        reportText += lineText;
+    }
+    return reportText;
+}
+
+/** ****************************************************************************
+ * Function: writeReport()
+ *   @return false if the file could not be opened.
+*******************************************************************************/
+bool StartupTimeline::writeReport(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    {
+        qDebug("StartupTimeline::writeReport: Can't open %s", qPrintable(fileName));
+        return false;
+    }
+    QTextStream reportStream(&file);
+    reportStream << QDateTime::currentDateTime().toString(Qt::ISODate) << "\n"
+                 << report() << "\n";
+    return true;
+}
@@ -0,0 +1,102 @@
+/** ****************************************************************************
+ * @file startuptimeline.h
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * The StartupTimeline times how long it takes from main() to the first frame
+ * of the game on screen.  main() and the MainWindow constructor mark the end
+ * of each subsystem they set up; the timeline ends when the watched widget
+ * has finished its first paint, after which the event loop takes input.
+ *
+ ******************************************************************************/
+
+#ifndef STARTUPTIMELINE_H
+#define STARTUPTIMELINE_H
+
+#include <QtCore/QObject>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
+#include <QtCore/QString>
+#include <QtGui/QWidget>
+
+/// Startup stages, in the order they are done; each is timed from the previous.
+enum startupStage {
+    STARTUP_APPLICATION = 0,    ///< QApplication, from the start of main()
+    STARTUP_QML_TYPES,          ///< registering the C++ QML items
+    STARTUP_GAME_WIDGET,        ///< DotWidget, its Dot and labels
+    STARTUP_STATUS_BAR,         ///< the status bar
+    STARTUP_QML_SCENE,          ///< the QML view, loading main.qml, the field item
+    STARTUP_LAYOUT,             ///< the central layouts, shortcuts, connections
+    STARTUP_SCORE_STORE,        ///< starting to read the score table
+    STARTUP_SHOW,               ///< show(): layout, window mapping
+    STARTUP_FIRST_PAINT,        ///< show() until the first paint has finished
+    STARTUP_STAGE_COUNT
+};
+
+/** ****************************************************************************
+ * @class StartupTimeline
+ *   Time per startup stage, and in all to the first paint.
+*******************************************************************************/
+class StartupTimeline : public QObject
+{
+    Q_OBJECT
+public:
+    /// The clock starts here: construct it first thing in main()
+    explicit StartupTimeline(QObject *parent = 0);
+
+    /// The first frame is interactive this long after main() on the kiosks
+    static const int FIRST_FRAME_BUDGET_MS = 200;
+
+    /// 'stage' has just finished
+    void mark(startupStage stage);
+    /// End the timeline when 'widgetPtr' has painted for the first time
+    void finishOnFirstPaint(QWidget *widgetPtr);
+    /// Append the report to 'fileName' when the timeline ends
+    void setReportFile(const QString &fileName);
+    inline bool isFinished() const;
+
+    /// One line per stage, ms taken and ms since main()
+    QString report() const;
+    /// @return false if the file could not be opened.
+    bool writeReport(const QString &fileName) const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
+private:
+    /* Private non-defined function prototypes disables compiler generation. */
+    StartupTimeline(const StartupTimeline&);                // prevent copy operator
+    StartupTimeline& operator=(const StartupTimeline&);     // prevent assignment operator
+
+    /// Runs from the constructor
+    QElapsedTimer m_clock;
+    /// Clock time each stage ended, or -1 if it hasn't
+    qint64 m_stageEndNs[STARTUP_STAGE_COUNT];
+    /// Widget whose first paint ends the timeline; NULL once it has
+    QPointer<QWidget> m_firstPaintWidgetPtr;
+    /// Set while the first paint is delivered from eventFilter()
+    bool m_dispatching;
+    /// Where the report goes at the end; empty for nowhere
+    QString m_reportFileName;
+};
+
+
+/** ****************************************************************************
+ * Function: isFinished()
+ *
+*******************************************************************************/
+inline bool StartupTimeline::isFinished() const
+{
+    return m_stageEndNs[STARTUP_FIRST_PAINT] >= 0;
+}
+
+#endif // STARTUPTIMELINE_H
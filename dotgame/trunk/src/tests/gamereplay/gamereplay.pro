@@ -0,0 +1,13 @@
+# QTestLib checks of the dotcore game replays: a recorded game has to replay
+# to the same dot positions and score.  'make check' runs them.
+TEMPLATE = app
+TARGET = tst_gamereplay
+QT += testlib
+QT -= gui
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+SOURCES += tst_gamereplay.cpp
+
+DOTCORE_OUT_PWD = $$OUT_PWD/../../dotcore
+include(../../dotcore/dotcore.pri)
@@ -0,0 +1,185 @@
+/** ****************************************************************************
+ * @file tst_gamereplay.cpp
+ * @author Jeremy Hannon <hje@zuhlke.com>
+ * @version 0.5
+ * @date October 16th, 2026
+ * Created: October 16th, 2026
+ *
+ * @section LICENSE
+ *     All rights reserved, Zuhlke Engineering Ltd.  Copyright 2012.
+ *
+ * @section DESCRIPTION
+ * The DotGame is a Qt application involving a randomly walking dot that the
+ * user tries to closely follow with their cursor to achieve a high score.
+ *
+ * Records headless games with ReplayWriter and plays them back with
+ * ReplayPlayer, the way DotWidget::runFrame() does, and checks that the replay
+ * matches: same dot at every stat update, same end and score.
+ *
+ ******************************************************************************/
+
+#include <QtTest/QtTest>
+#include "gamereplay.h"
+
+/// Arena of the recorded games, as on the kiosk
+static const int ARENA_WIDTH = 800;
+static const int ARENA_HEIGHT = 600;
+/// Simulation step, as DotWidget::SIM_STEP_MS
+static const unsigned int SIM_STEP_MS = 1;
+/// Game time at which the speed slider is moved, in ms
+static const unsigned int SPEED_CHANGE_MS = 2000;
+/// Game time at which the window is resized, in ms
+static const unsigned int RESIZE_MS = 3500;
+
+/** ****************************************************************************
+ * @class GameReplayTest
+ *
+*******************************************************************************/
+class GameReplayTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void replayMatches();
+    void replayMatchesMidGameSpeedChange();
+    void replayMatchesMidGameResize();
+    void unrecordedChangeMismatches();
+
+private:
+    /// Mid-game changes made while recording
+    enum midGameChange {
+        NO_CHANGE,
+        SPEED_CHANGE,
+        RESIZE
+    };
+    /// Play a timed game, with three cursor samples a step trailing the dot
+    static void recordGame(ReplayWriter &writer, midGameChange change, bool notify);
+    /// Play the recording back; the number of mismatches
+    static unsigned int replayGame(const ReplayWriter &writer);
+};
+
+/** ****************************************************************************
+ * Function: recordGame()
+ *   @param notify Tell the recorder about the change, as DotWidget does.
+*******************************************************************************/
+void GameReplayTest::recordGame(ReplayWriter &writer, midGameChange change, bool notify)
+{
+    const int64_t USEC_IN_MSEC = 1000;
+    GameSim gameSim(SimPoint(ARENA_WIDTH/2, ARENA_HEIGHT/2), ARENA_WIDTH, ARENA_HEIGHT);
+    gameSim.setTimeLimit(6);
+    gameSim.resetGameStats(GameSim::DOT_SPEED_DEFAULT, 1234);
+    writer.begin(gameSim);
+    gameSim.setRecorder(&writer);
+    gameOverReason reason = NO_GAME_OVER;
+    while (reason == NO_GAME_OVER)
+    {
+        if ((change == SPEED_CHANGE) && (gameSim.getElapsedTimeMs() == SPEED_CHANGE_MS))
+        {
+            gameSim.setDotSpeed(GameSim::DOT_SPEED_MIN + 8);
+            if (notify)
+            {
+                gameSim.notifySettingsChanged();
+            }
+        }
+        if ((change == RESIZE) && (gameSim.getElapsedTimeMs() == RESIZE_MS))
+        {
+            gameSim.dot().setBounds(ARENA_WIDTH - 100, ARENA_HEIGHT - 100);
+            gameSim.dot().setPos(SimPoint((ARENA_WIDTH - 100)/2, (ARENA_HEIGHT - 100)/2));
+            if (notify)
+            {
+                gameSim.notifySettingsChanged();
+            }
+        }
+        const int64_t stepStartUs = int64_t(gameSim.getElapsedTimeMs()) * USEC_IN_MSEC;
+        for (int64_t offsetUs = 0; offsetUs < 1000; offsetUs += 333)
+        {
+            SimPoint cursorPos = gameSim.dot().getPos();
+            cursorPos.x += int(((stepStartUs + offsetUs) / 7000) % 5) - 2;
+            cursorPos.y += int(((stepStartUs + offsetUs) / 11000) % 5) - 2;
+            gameSim.addCursorSample(stepStartUs + offsetUs, cursorPos);
+        }
+        reason = gameSim.step(SIM_STEP_MS).gameOver;
+    }
+    gameSim.setRecorder(NULL);
+    writer.finish(reason, gameSim.getScore());
+    return;
+}
+
+/** ****************************************************************************
+ * Function: replayGame()
+ *   Starts from a GameSim with other settings, so all of them must come from
+ *   the recording.
+*******************************************************************************/
+unsigned int GameReplayTest::replayGame(const ReplayWriter &writer)
+{
+    const int64_t USEC_IN_MSEC = 1000;
+    const std::vector<uint8_t> &data = writer.data();
+    ReplayPlayer player(&data[0], data.size());
+    if (!player.isValid())
+    {
+        return 1;
+    }
+    GameSim gameSim;
+    player.configure(gameSim);
+    gameSim.setRecorder(&player);
+    gameOverReason reason = NO_GAME_OVER;
+    while (reason == NO_GAME_OVER)
+    {
+        player.feedCursor(gameSim, int64_t(gameSim.getElapsedTimeMs() + SIM_STEP_MS) * USEC_IN_MSEC);
+        reason = gameSim.step(SIM_STEP_MS).gameOver;
+    }
+    gameSim.setRecorder(NULL);
+    player.checkResult(reason, gameSim.getScore());
+    return player.getMismatches();
+}
+
+/** ****************************************************************************
+ * Function: replayMatches()
+ *
+*******************************************************************************/
+void GameReplayTest::replayMatches()
+{
+    ReplayWriter writer;
+    recordGame(writer, NO_CHANGE, true);
+    QCOMPARE(replayGame(writer), 0u);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: replayMatchesMidGameSpeedChange()
+ *   The speed slider moved while the game ran.
+*******************************************************************************/
+void GameReplayTest::replayMatchesMidGameSpeedChange()
+{
+    ReplayWriter writer;
+    recordGame(writer, SPEED_CHANGE, true);
+    QCOMPARE(replayGame(writer), 0u);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: replayMatchesMidGameResize()
+ *   The window shrank while the game ran, moving the dot.
+*******************************************************************************/
+void GameReplayTest::replayMatchesMidGameResize()
+{
+    ReplayWriter writer;
+    recordGame(writer, RESIZE, true);
+    QCOMPARE(replayGame(writer), 0u);
+    return;
+}
+
+/** ****************************************************************************
+ * Function: unrecordedChangeMismatches()
+ *   Without its settings record the speed change can't be replayed, so the
+ *   checks above can fail.
+*******************************************************************************/
+void GameReplayTest::unrecordedChangeMismatches()
+{
+    ReplayWriter writer;
+    recordGame(writer, SPEED_CHANGE, false);
+    QVERIFY(replayGame(writer) > 0u);
+    return;
+}
+
+QTEST_APPLESS_MAIN(GameReplayTest)
+#include "tst_gamereplay.moc"